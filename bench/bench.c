@@ -0,0 +1,298 @@
+/**
+ * @file bench.c
+ * @brief Cycle-count benchmark image for the drivers, run headless in the mspdebug simulator.
+ *
+ * Each case is timed with Timer1_A counting SMCLK / 1, which runs at the MCLK
+ * rate both on the chip and in the simulator. The cost of an empty case is
+ * subtracted. The fastest of BENCH_RUNS runs is kept, so an interrupt landing
+ * in one run does not skew the result.
+ *
+ * ISR cases set the interrupt flag from the case itself, so their cycles
+ * include the flag-setting store, the 6-cycle interrupt entry and the RETI.
+ *
+ * The fixed-point kernels are paired with the plain C they replace (the
+ * *_libgcc cases), on operands read from volatile variables so that nothing
+ * folds at compile time.
+ *
+ * When bench_done() is reached, bench_results[] holds the cycles of each
+ * case in BENCH_CASES() order. bench/bench.sh reads them from the simulator.
+ * The image also runs on a LaunchPad, with a breakpoint on bench_done().
+ */
+#include <msp430.h>
+#include <stdint.h>
+#include "../common/defines.h"
+#include "../common/fixed.h"
+#include "../drivers/gpio.h"
+#include "../drivers/led.h"
+#include "../drivers/mcu_init.h"
+#include "../drivers/millis.h"
+#include "../drivers/runloop.h"
+#include "../drivers/timebase.h"
+
+// --- Benchmark Cases ---
+
+/**
+ * @brief Benchmark cases in report order, one X(name) per line: bench.sh reads the names here.
+ */
+#define BENCH_CASES(X)                                                                             \
+    X(gpio_configure)                                                                              \
+    X(gpio_set_out)                                                                                \
+    X(gpio_toggle_out)                                                                             \
+    X(gpio_get_input)                                                                              \
+    X(timebase_ticks)                                                                              \
+    X(timebase_millis)                                                                             \
+    X(millis)                                                                                      \
+    X(micros)                                                                                      \
+    X(timebase_alarm_set)                                                                          \
+    X(timebase_alarm_cancel)                                                                       \
+    X(runloop_post)                                                                                \
+    X(led_set_state)                                                                               \
+    X(led_handle_blinking)                                                                         \
+    X(isr_timebase_compare)                                                                        \
+    X(isr_timebase_overflow)                                                                       \
+    X(isr_port1)                                                                                   \
+    X(fixed_mul2000_libgcc)                                                                        \
+    X(fixed_mul2000)                                                                               \
+    X(fixed_divmod2000_libgcc)                                                                     \
+    X(fixed_divmod2000)                                                                            \
+    X(fixed_divmod10_libgcc)                                                                       \
+    X(fixed_divmod10)                                                                              \
+    X(fixed_sin)                                                                                   \
+    X(fixed_atan2)
+
+#define BENCH_RUNS 8
+#define BENCH_RESULTS_BYTES 64 ///< Size of the simulator memory dump, see the Makefile.
+
+// --- Private Module Variables ---
+
+#define BENCH_CASE_ID(name) BENCH_CASE_##name,
+typedef enum {
+    BENCH_CASES(BENCH_CASE_ID) BENCH_CASE_CNT,
+} bench_case_e;
+#undef BENCH_CASE_ID
+
+_Static_assert(BENCH_CASE_CNT * sizeof(uint16_t) <= BENCH_RESULTS_BYTES,
+    "bench_results must fit in the dump read by bench.sh");
+
+/**
+ * @brief Cycles per call of each case, read by the simulator once bench_done() is reached.
+ */
+volatile uint16_t bench_results[BENCH_CASE_CNT];
+
+/**
+ * @brief Operands and results of the fixed-point cases.
+ */
+static volatile uint32_t fixed_operand = 123456789UL;
+static volatile uint32_t fixed_ticks = 98765UL; ///< Within the range of fixed_divmod2000_u24().
+static volatile uint16_t fixed_angle = 1234;
+static volatile int16_t fixed_y = -12345;
+static volatile int16_t fixed_x = 23456;
+static volatile uint32_t fixed_result;
+static volatile uint16_t fixed_remainder;
+
+static const gpio_config_t unused_pin_config = {
+    .select = IO_SELECT_GPIO,
+    .resistor = IO_RESISTOR_DISABLED,
+    .dir = IO_DIR_OUTPUT,
+    .out = IO_OUT_LOW,
+};
+
+// --- Case Definitions ---
+
+static void bench_empty(void) { }
+
+static void bench_gpio_configure(void)
+{
+    gpio_configure(IO_UNUSED_2, &unused_pin_config);
+}
+
+static void bench_gpio_set_out(void)
+{
+    gpio_set_out(IO_UNUSED_2, IO_OUT_HIGH);
+}
+
+static void bench_gpio_toggle_out(void)
+{
+    gpio_toggle_out(IO_UNUSED_2);
+}
+
+static void bench_gpio_get_input(void)
+{
+    (void)gpio_get_input(IO_BUTTON);
+}
+
+static void bench_timebase_ticks(void)
+{
+    (void)timebase_ticks();
+}
+
+static void bench_timebase_millis(void)
+{
+    (void)timebase_millis();
+}
+
+static void bench_millis(void)
+{
+    (void)millis();
+}
+
+static void bench_micros(void)
+{
+    (void)micros();
+}
+
+static void bench_noop_alarm(void) { }
+
+static void bench_timebase_alarm_set(void)
+{
+    timebase_alarm_set(TIMEBASE_ALARM_APP, timebase_ticks() + TIMEBASE_MS_TO_TICKS(1000),
+        bench_noop_alarm);
+}
+
+static void bench_timebase_alarm_cancel(void)
+{
+    timebase_alarm_cancel(TIMEBASE_ALARM_APP);
+}
+
+static void bench_runloop_post(void)
+{
+    runloop_post(RUNLOOP_EVENT_APP);
+}
+
+static void bench_led_set_state(void)
+{
+    led_set_state(led_get_handle(IO_LED_RED), LED_ON);
+}
+
+static void bench_led_handle_blinking(void)
+{
+    led_handle_blinking();
+}
+
+static void bench_isr_timebase_compare(void)
+{
+    TA0CCTL0 = CCIE | CCIFG;
+}
+
+static void bench_isr_timebase_overflow(void)
+{
+    TA0CTL |= TAIFG;
+}
+
+static void bench_noop_gpio_cb(gpio_e gpio)
+{
+    UNUSED(gpio);
+}
+
+static void bench_isr_port1(void)
+{
+    GPIO_PORT_REG(IO_BUTTON, IFG) |= GPIO_PIN_BIT(IO_BUTTON);
+}
+
+static void bench_fixed_mul2000_libgcc(void)
+{
+    fixed_result = fixed_operand * TIMEBASE_TICKS_PER_MS;
+}
+
+static void bench_fixed_mul2000(void)
+{
+    fixed_result = fixed_mul2000_u32(fixed_operand);
+}
+
+static void bench_fixed_divmod2000_libgcc(void)
+{
+    uint32_t ticks = fixed_ticks;
+    fixed_result = ticks / TIMEBASE_TICKS_PER_MS;
+    fixed_remainder = (uint16_t)(ticks % TIMEBASE_TICKS_PER_MS);
+}
+
+static void bench_fixed_divmod2000(void)
+{
+    uint16_t remainder;
+    fixed_result = fixed_divmod2000_u24(fixed_ticks, &remainder);
+    fixed_remainder = remainder;
+}
+
+static void bench_fixed_divmod10_libgcc(void)
+{
+    uint32_t value = fixed_operand;
+    fixed_result = value / 10;
+    fixed_remainder = (uint16_t)(value % 10);
+}
+
+static void bench_fixed_divmod10(void)
+{
+    uint8_t remainder;
+    fixed_result = fixed_divmod10_u32(fixed_operand, &remainder);
+    fixed_remainder = remainder;
+}
+
+static void bench_fixed_sin(void)
+{
+    fixed_remainder = (uint16_t)fixed_sin(fixed_angle);
+}
+
+static void bench_fixed_atan2(void)
+{
+    fixed_remainder = fixed_atan2(fixed_y, fixed_x);
+}
+
+#define BENCH_CASE_FN(name) bench_##name,
+static void (*const bench_cases[BENCH_CASE_CNT])(void) = { BENCH_CASES(BENCH_CASE_FN) };
+#undef BENCH_CASE_FN
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Returns the fewest Timer1_A counts taken by a case over BENCH_RUNS runs.
+ */
+static uint16_t measure(void (*run)(void))
+{
+    uint16_t best = UINT16_MAX;
+
+    for (uint8_t i = 0; i < BENCH_RUNS; i++) {
+        uint16_t start = TA1R;
+        run();
+        uint16_t counts = TA1R - start;
+        if (counts < best) best = counts;
+    }
+    return best;
+}
+
+/**
+ * @brief Breakpoint target marking the end of the run.
+ */
+__attribute__((noinline)) void bench_done(void)
+{
+    __no_operation();
+}
+
+int main(void)
+{
+    mcu_init();
+    gpio_init();
+    timebase_init();
+    led_init();
+
+    // Timer1_A as a free-running cycle counter. The LaunchPad LEDs are not on
+    // Timer1_A outputs, so the LED driver never claims it here.
+    TA1CTL = TASSEL_2 | ID_0 | MC_2 | TACLR;
+
+    // State the cases expect: two LEDs blinking in software, and an
+    // interrupt callback on the button pin.
+    led_start_blinking(led_get_handle(IO_LED_RED), 200, 800);
+#if BOARD_HAS_LED_GREEN
+    led_start_blinking(led_get_handle(IO_LED_GREEN), 500, 500);
+#endif
+    gpio_enable_interrupt(IO_BUTTON, IO_TRIGGER_FALLING, bench_noop_gpio_cb);
+
+    uint16_t overhead = measure(bench_empty);
+    for (uint8_t i = 0; i < BENCH_CASE_CNT; i++) {
+        bench_results[i] = measure(bench_cases[i]) - overhead;
+    }
+
+    bench_done();
+    for (;;) {
+        __bis_SR_register(LPM4_bits);
+    }
+}
@@ -0,0 +1,45 @@
+#!/bin/sh
+# Converts the bench_results dump printed by the mspdebug simulator into a CSV
+# table with one "case,cycles" row per case, in BENCH_CASES() order. When a
+# baseline CSV is given, its cycles and the difference are appended to each row.
+#
+# Usage: mspdebug sim ... "md bench_results 64" | bench.sh bench/bench.c [baseline.csv]
+set -e
+
+cases=$(sed -n 's/^ *X(\([a-z0-9_]*\)).*/\1/p' "$1" | tr '\n' ' ')
+baseline=${2:-}
+
+awk -v cases="$cases" -v baseline="$baseline" '
+function hex(s,   i, v) {
+    s = tolower(s)
+    v = 0
+    for (i = 1; i <= length(s); i++) v = v * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+    return v
+}
+BEGIN {
+    if (baseline != "") {
+        while ((getline line < baseline) > 0) {
+            split(line, field, ",")
+            if (field[1] != "case") { base[field[1]] = field[2]; nbase++ }
+        }
+    }
+}
+# Memory dump lines: an address followed by 16 bytes. Disassembly lines never
+# hold that many bytes, so they are skipped.
+$1 ~ /^(0x)?[0-9a-fA-F]+:$/ && NF >= 17 {
+    for (i = 2; i <= 17; i++) if ($i !~ /^[0-9a-fA-F][0-9a-fA-F]$/) next
+    for (i = 2; i <= 17; i++) bytes[n++] = hex($i)
+}
+END {
+    cnt = split(cases, name, " ")
+    if (n < 2 * cnt) {
+        print "bench: bench_results not found in the simulator output" > "/dev/stderr"
+        exit 1
+    }
+    print (nbase ? "case,cycles,baseline,delta" : "case,cycles")
+    for (i = 1; i <= cnt; i++) {
+        c = bytes[2 * i - 2] + 256 * bytes[2 * i - 1]
+        if (name[i] in base) printf "%s,%d,%d,%+d\n", name[i], c, base[name[i]], c - base[name[i]]
+        else printf "%s,%d\n", name[i], c
+    }
+}'
@@ -0,0 +1,124 @@
+/**
+ * @file board.h
+ * @brief Pin assignments of the MSP-EXP430G2 LaunchPad, as a single X-macro table.
+ *
+ * Every port pin appears exactly once with its application alias and its
+ * reset configuration. The GPIO driver expands this table into the gpio_e
+ * aliases, whole-port register values for gpio_init() and compile-time checks
+ * that no pin is assigned twice or left out.
+ *
+ * Columns: X(alias, port, pin, select, resistor, dir, out)
+ */
+#ifndef BOARD_H
+#define BOARD_H
+
+/**
+ * @brief Number of channels of the 74HC595 LED panel on USCI_B0 SPI (8 per register).
+ *
+ * The panel uses P1.5 (UCB0CLK -> SRCLK), P1.7 (UCB0SIMO -> SER) and P2.0
+ * (-> RCLK). Set to 0 when no panel is fitted to leave these pins unused.
+ */
+#define BOARD_LED_PANEL_CHANNELS 16
+
+/**
+ * @brief Set to 1 when an I2C bus is fitted to USCI_B0, with external pull-ups.
+ *
+ * The bus uses P1.6 (UCB0SCL) and P1.7 (UCB0SDA). USCI_B0 and P1.7 are shared
+ * with the LED panel, which must then be removed (BOARD_LED_PANEL_CHANNELS 0).
+ * P1.6 also drives the green LED: remove jumper J5, the green LED is not used.
+ */
+#define BOARD_I2C_ENABLED 0
+
+#if BOARD_I2C_ENABLED && BOARD_LED_PANEL_CHANNELS > 0
+#error "The I2C bus and the LED panel both need USCI_B0 and P1.7"
+#endif
+
+#define BOARD_HAS_LED_GREEN (!BOARD_I2C_ENABLED)
+
+/**
+ * @brief Set to 1 when an AS5600 magnetic encoder is on the I2C bus (address 0x36).
+ */
+#define BOARD_HAS_AS5600 BOARD_I2C_ENABLED
+
+#if BOARD_HAS_AS5600 && !BOARD_I2C_ENABLED
+#error "The AS5600 needs the I2C bus"
+#endif
+
+/**
+ * @brief Set to 1 to stream the ADC10: the AS5600 analog OUT on P1.5 (A5), the
+ * temperature sensor and VCC/2.
+ *
+ * The conversions are triggered by the timebase periodic channel, which the
+ * LED panel and the AS5600 I2C sampling also need.
+ */
+#define BOARD_ADC_ENABLED 0
+
+#define BOARD_VCC_MV 3600 ///< Supply voltage from the LaunchPad emulator.
+
+#if BOARD_ADC_ENABLED && (BOARD_LED_PANEL_CHANNELS > 0 || BOARD_HAS_AS5600)
+#error "The ADC10 trigger, the LED panel and the AS5600 I2C sampling all need the periodic channel"
+#endif
+
+/**
+ * @brief Set to 1 to measure the AS5600 OUT pin in PWM mode on P2.1 (TA1.1 CCI1A)
+ * with the Timer1_A capture driver.
+ *
+ * Timer1_A then counts SMCLK for the captures: no LED may use a TA1 output.
+ */
+#define BOARD_CAPTURE_ENABLED 0
+
+#if BOARD_CAPTURE_ENABLED && BOARD_ADC_ENABLED
+#error "The AS5600 OUT pin is either analog (BOARD_ADC_ENABLED) or PWM (BOARD_CAPTURE_ENABLED)"
+#endif
+
+// clang-format off
+#if BOARD_LED_PANEL_CHANNELS > 0
+#define BOARD_PIN_P15(X) X(IO_PANEL_SCLK,  1, 5, IO_SELECT_ALT3, IO_RESISTOR_DISABLED, IO_DIR_OUTPUT, IO_OUT_LOW) /* UCB0CLK */
+#define BOARD_PIN_P17(X) X(IO_PANEL_MOSI,  1, 7, IO_SELECT_ALT3, IO_RESISTOR_DISABLED, IO_DIR_OUTPUT, IO_OUT_LOW) /* UCB0SIMO */
+#define BOARD_PIN_P20(X) X(IO_PANEL_LATCH, 2, 0, IO_SELECT_GPIO, IO_RESISTOR_DISABLED, IO_DIR_OUTPUT, IO_OUT_LOW)
+#elif BOARD_I2C_ENABLED
+#define BOARD_PIN_P15(X) X(IO_UNUSED_3, 1, 5, IO_SELECT_GPIO, IO_RESISTOR_ENABLED, IO_DIR_OUTPUT, IO_OUT_LOW)
+#define BOARD_PIN_P17(X) X(IO_I2C_SDA,  1, 7, IO_SELECT_ALT3, IO_RESISTOR_DISABLED, IO_DIR_INPUT, IO_OUT_LOW) /* UCB0SDA */
+#define BOARD_PIN_P20(X) X(IO_UNUSED_5, 2, 0, IO_SELECT_GPIO, IO_RESISTOR_ENABLED, IO_DIR_OUTPUT, IO_OUT_LOW)
+#elif BOARD_ADC_ENABLED
+#define BOARD_PIN_P15(X) X(IO_AS5600_OUT, 1, 5, IO_SELECT_GPIO, IO_RESISTOR_DISABLED, IO_DIR_INPUT, IO_OUT_LOW) /* A5 */
+#define BOARD_PIN_P17(X) X(IO_UNUSED_4,   1, 7, IO_SELECT_GPIO, IO_RESISTOR_ENABLED, IO_DIR_OUTPUT, IO_OUT_LOW)
+#define BOARD_PIN_P20(X) X(IO_UNUSED_5,   2, 0, IO_SELECT_GPIO, IO_RESISTOR_ENABLED, IO_DIR_OUTPUT, IO_OUT_LOW)
+#else
+#define BOARD_PIN_P15(X) X(IO_UNUSED_3, 1, 5, IO_SELECT_GPIO, IO_RESISTOR_ENABLED, IO_DIR_OUTPUT, IO_OUT_LOW)
+#define BOARD_PIN_P17(X) X(IO_UNUSED_4, 1, 7, IO_SELECT_GPIO, IO_RESISTOR_ENABLED, IO_DIR_OUTPUT, IO_OUT_LOW)
+#define BOARD_PIN_P20(X) X(IO_UNUSED_5, 2, 0, IO_SELECT_GPIO, IO_RESISTOR_ENABLED, IO_DIR_OUTPUT, IO_OUT_LOW)
+#endif
+
+#if BOARD_CAPTURE_ENABLED
+#define BOARD_PIN_P21(X) X(IO_AS5600_PWM, 2, 1, IO_SELECT_ALT1, IO_RESISTOR_DISABLED, IO_DIR_INPUT, IO_OUT_LOW) /* TA1.1 CCI1A */
+#else
+#define BOARD_PIN_P21(X) X(IO_UNUSED_6,   2, 1, IO_SELECT_GPIO, IO_RESISTOR_ENABLED,  IO_DIR_OUTPUT, IO_OUT_LOW)
+#endif
+
+#if BOARD_I2C_ENABLED
+#define BOARD_PIN_P16(X) X(IO_I2C_SCL,   1, 6, IO_SELECT_ALT3, IO_RESISTOR_DISABLED, IO_DIR_INPUT, IO_OUT_LOW) /* UCB0SCL */
+#else
+#define BOARD_PIN_P16(X) X(IO_LED_GREEN, 1, 6, IO_SELECT_GPIO, IO_RESISTOR_DISABLED, IO_DIR_OUTPUT, IO_OUT_LOW) /* Green LED */
+#endif
+
+#define BOARD_PINS(X)                                                                              \
+    X(IO_LED_RED,   1, 0, IO_SELECT_GPIO, IO_RESISTOR_DISABLED, IO_DIR_OUTPUT, IO_OUT_LOW) /* Red LED */ \
+    X(IO_UART_RX,   1, 1, IO_SELECT_ALT3, IO_RESISTOR_DISABLED, IO_DIR_INPUT,  IO_OUT_LOW) /* UCA0RXD */ \
+    X(IO_UART_TX,   1, 2, IO_SELECT_ALT3, IO_RESISTOR_DISABLED, IO_DIR_OUTPUT, IO_OUT_HIGH) /* UCA0TXD */ \
+    X(IO_BUTTON,    1, 3, IO_SELECT_GPIO, IO_RESISTOR_ENABLED,  IO_DIR_INPUT,  IO_OUT_HIGH) /* S2, active low */ \
+    X(IO_UNUSED_2,  1, 4, IO_SELECT_GPIO, IO_RESISTOR_ENABLED,  IO_DIR_OUTPUT, IO_OUT_LOW) \
+    BOARD_PIN_P15(X) \
+    BOARD_PIN_P16(X) \
+    BOARD_PIN_P17(X) \
+    BOARD_PIN_P20(X) \
+    BOARD_PIN_P21(X) \
+    X(IO_UNUSED_7,  2, 2, IO_SELECT_GPIO, IO_RESISTOR_ENABLED,  IO_DIR_OUTPUT, IO_OUT_LOW) \
+    X(IO_UNUSED_8,  2, 3, IO_SELECT_GPIO, IO_RESISTOR_ENABLED,  IO_DIR_OUTPUT, IO_OUT_LOW) \
+    X(IO_UNUSED_9,  2, 4, IO_SELECT_GPIO, IO_RESISTOR_ENABLED,  IO_DIR_OUTPUT, IO_OUT_LOW) \
+    X(IO_UNUSED_10, 2, 5, IO_SELECT_GPIO, IO_RESISTOR_ENABLED,  IO_DIR_OUTPUT, IO_OUT_LOW) \
+    X(IO_UNUSED_11, 2, 6, IO_SELECT_GPIO, IO_RESISTOR_ENABLED,  IO_DIR_OUTPUT, IO_OUT_LOW) \
+    X(IO_UNUSED_12, 2, 7, IO_SELECT_GPIO, IO_RESISTOR_ENABLED,  IO_DIR_OUTPUT, IO_OUT_LOW)
+// clang-format on
+
+#endif // BOARD_H
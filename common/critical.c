@@ -0,0 +1,101 @@
+/**
+ * @file critical.c
+ * @brief Interrupts-off time measurement of the CRITICAL_INSTRUMENT build.
+ *
+ * Windows are timed with the free-running Timer0_A counter of the timebase,
+ * one count per tick (0.5 us) except in the 1 MHz clock profile (1 us). The
+ * 16-bit difference limits a single window to 32 ms, far beyond any section
+ * in the drivers.
+ */
+#include "critical.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// --- Private Module Variables ---
+
+static critical_stats_t stats = { 0, NULL, 0, 0 };
+
+#if CRITICAL_INSTRUMENT
+
+/**
+ * @brief Start of the open outermost section, valid when is_open is set.
+ */
+static uint16_t open_start;
+static const char *open_file;
+static uint16_t open_line;
+static bool is_open = false;
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Closes the open section, if any, and keeps it if it is the longest so far.
+ * @note Must be called with interrupts disabled.
+ */
+static void close_section(void)
+{
+    if (!is_open) return;
+
+    uint16_t ticks = TA0R - open_start;
+    is_open = false;
+    stats.section_cnt++;
+    if (ticks > stats.max_ticks) {
+        stats.max_ticks = ticks;
+        stats.file = open_file;
+        stats.line = open_line;
+    }
+}
+
+// --- Public Function Definitions ---
+
+critical_state_t critical_enter_traced(const char *file, uint16_t line)
+{
+    critical_state_t state = critical_save_and_disable();
+
+    // Only the outermost section opens a window: nested ones find GIE already cleared.
+    if (state & GIE) {
+        open_start = TA0R;
+        open_file = file;
+        open_line = line;
+        is_open = true;
+    }
+    return state;
+}
+
+void critical_exit(critical_state_t state)
+{
+    if (state & GIE) {
+        close_section();
+        __enable_interrupt();
+    }
+}
+
+void critical_restart_window(void)
+{
+    open_start = TA0R;
+}
+
+void critical_exit_and_sleep(uint16_t lpm_bits)
+{
+    close_section();
+    __bis_SR_register(lpm_bits | GIE);
+}
+
+#endif // CRITICAL_INSTRUMENT
+
+void critical_get_stats(critical_stats_t *out)
+{
+    critical_state_t state = critical_save_and_disable();
+    *out = stats;
+    if (state & GIE) {
+        __enable_interrupt();
+    }
+}
+
+void critical_reset_stats(void)
+{
+    critical_state_t state = critical_save_and_disable();
+    stats = (critical_stats_t) { 0, NULL, 0, 0 };
+    if (state & GIE) {
+        __enable_interrupt();
+    }
+}
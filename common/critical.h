@@ -0,0 +1,121 @@
+/**
+ * @file critical.h
+ * @brief Nesting-safe critical sections, with optional measurement of the interrupts-off time.
+ *
+ * critical_enter() saves the interrupt enable state (SR.GIE) before disabling
+ * interrupts, and critical_exit() only re-enables them if they were enabled
+ * on entry. Sections can therefore be nested and used from ISRs.
+ *
+ * Building with CRITICAL_INSTRUMENT=1 (make CRITICAL_INSTRUMENT=1, after a
+ * make clean) times every outermost section with the Timer0_A counter and
+ * keeps the longest one with its call site, see critical_get_stats(). The
+ * time spent in ISRs, where the hardware clears GIE, is not included.
+ */
+#ifndef CRITICAL_H
+#define CRITICAL_H
+
+#include <msp430.h>
+#include <stdint.h>
+#include "defines.h"
+
+#ifndef CRITICAL_INSTRUMENT
+#define CRITICAL_INSTRUMENT 0
+#endif
+
+// --- Public Type Definitions ---
+
+/**
+ * @brief Interrupt state saved by critical_enter(): GIE if interrupts were enabled.
+ */
+typedef uint16_t critical_state_t;
+
+/**
+ * @brief Longest interrupts-disabled window seen, from a CRITICAL_INSTRUMENT build.
+ */
+typedef struct
+{
+    uint16_t max_ticks; ///< Duration of the window, in Timer0_A counts (see timebase.h).
+    const char *file; ///< Source file of the critical_enter() that opened it, or NULL.
+    uint16_t line; ///< Line of that critical_enter().
+    uint16_t section_cnt; ///< Number of outermost sections measured (wraps).
+} critical_stats_t;
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Saves the interrupt state and disables interrupts.
+ */
+FORCE_INLINE critical_state_t critical_save_and_disable(void)
+{
+    critical_state_t state = __get_SR_register() & GIE;
+    __disable_interrupt();
+    return state;
+}
+
+#if CRITICAL_INSTRUMENT
+
+critical_state_t critical_enter_traced(const char *file, uint16_t line);
+void critical_exit(critical_state_t state);
+void critical_exit_and_sleep(uint16_t lpm_bits);
+void critical_restart_window(void);
+
+/**
+ * @brief Disables interrupts, recording the call site.
+ * @return The state to pass to critical_exit().
+ */
+#define critical_enter() critical_enter_traced(__FILE__, __LINE__)
+
+#else
+
+/**
+ * @brief Disables interrupts.
+ * @return The state to pass to critical_exit().
+ */
+#define critical_enter() critical_save_and_disable()
+
+/**
+ * @brief Ends a critical section, re-enabling interrupts only if they were enabled on entry.
+ * @param state The value returned by the matching critical_enter().
+ */
+FORCE_INLINE void critical_exit(critical_state_t state)
+{
+    if (state & GIE) {
+        __enable_interrupt();
+    }
+}
+
+/**
+ * @brief Ends a critical section by entering a low-power mode with interrupts enabled.
+ *
+ * GIE and the LPM bits are set by a single instruction, so an interrupt made
+ * pending inside the section still wakes the CPU. Returns after an ISR has
+ * cleared the LPM bits, with interrupts enabled.
+ *
+ * @param lpm_bits The low-power mode to enter, e.g. LPM0_bits.
+ */
+FORCE_INLINE void critical_exit_and_sleep(uint16_t lpm_bits)
+{
+    __bis_SR_register(lpm_bits | GIE);
+}
+
+/**
+ * @brief Restarts the timing of the open section after Timer0_A was cleared.
+ * @note Only the timebase calls this, when a clock change restarts its counter.
+ */
+FORCE_INLINE void critical_restart_window(void) { }
+
+#endif // CRITICAL_INSTRUMENT
+
+/**
+ * @brief Copies the longest interrupts-disabled window measured so far.
+ * @note All zero unless built with CRITICAL_INSTRUMENT=1.
+ * @param out Destination of the measurements. Must not be NULL.
+ */
+void critical_get_stats(critical_stats_t *out);
+
+/**
+ * @brief Clears the measurements, e.g. to ignore the windows taken during initialization.
+ */
+void critical_reset_stats(void);
+
+#endif // CRITICAL_H
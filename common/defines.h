@@ -1,4 +1,12 @@
 #define UNUSED(x) (void)(x)
 #define SUPPRESS_UNUSED __attribute__((unused))
 #define ARRAY_SIZE(array) (sizeof(array) / sizeof(array[0]))
-#define INTERRUPT_VECTOR(vector) __attribute__((interrupt(vector)))
\ No newline at end of file
+#ifdef __MSP430__
+#define INTERRUPT_VECTOR(vector) __attribute__((interrupt(vector)))
+#else
+// Host emulation build: the stand-in msp430.h hands the ISR to the peripheral model.
+#define INTERRUPT_VECTOR(vector) HOST_INTERRUPT_VECTOR(vector)
+#endif
+#define FORCE_INLINE static inline __attribute__((always_inline))
+/// Keeps a variable out of the C runtime initialization: it holds its value across resets.
+#define NOINIT __attribute__((section(".noinit")))
@@ -0,0 +1,173 @@
+/**
+ * @file fixed.c
+ * @brief Implementation of the table-driven sine, cosine and atan2, and of the Q16.16 product.
+ *
+ * Both tables hold 2^n + 1 points of the first octant or quadrant, and the
+ * remaining bits of the input interpolate linearly between two of them. The
+ * differences between neighbours are small, so the interpolation product fits
+ * in 16 bits and takes one shift-add step per fraction bit.
+ */
+#include "fixed.h"
+#include <stdbool.h>
+
+// --- Private Module Constants ---
+
+#define SIN_STEP_LOG2 3 ///< Angle counts between two sine points.
+#define ATAN_RATIO_BITS 12 ///< Bits of the tangent computed in the first octant.
+#define ATAN_STEP_LOG2 7 ///< Tangent steps between two atan points.
+#define ATAN_FRAC_BITS 4 ///< Extra bits of angle held by the atan points.
+
+/**
+ * @brief sin(i * 8 / 4096 turn) in Q15 saturated to Q15_ONE, for i = 0 to 128 (one quadrant).
+ */
+static const q15_t sin_table[(FIXED_ANGLE_QUARTER >> SIN_STEP_LOG2) + 1] = {
+    0, 402, 804, 1206, 1608, 2009, 2411, 2811, 3212, 3612, 4011, 4410, 4808, 5205, 5602, 5998, 6393,
+    6787, 7180, 7571, 7962, 8351, 8740, 9127, 9512, 9896, 10279, 10660, 11039, 11417, 11793, 12167,
+    12540, 12910, 13279, 13646, 14010, 14373, 14733, 15091, 15447, 15800, 16151, 16500, 16846,
+    17190, 17531, 17869, 18205, 18538, 18868, 19195, 19520, 19841, 20160, 20475, 20788, 21097,
+    21403, 21706, 22006, 22302, 22595, 22884, 23170, 23453, 23732, 24008, 24279, 24548, 24812,
+    25073, 25330, 25583, 25833, 26078, 26320, 26557, 26791, 27020, 27246, 27467, 27684, 27897,
+    28106, 28311, 28511, 28707, 28899, 29086, 29269, 29448, 29622, 29792, 29957, 30118, 30274,
+    30425, 30572, 30715, 30853, 30986, 31114, 31238, 31357, 31471, 31581, 31686, 31786, 31881,
+    31972, 32058, 32138, 32214, 32286, 32352, 32413, 32470, 32522, 32568, 32610, 32647, 32679,
+    32706, 32729, 32746, 32758, 32766, 32767,
+};
+
+/**
+ * @brief atan(i / 32) in 1/16 angle counts, for i = 0 to 32 (one octant).
+ */
+static const uint16_t atan_table[(1U << (ATAN_RATIO_BITS - ATAN_STEP_LOG2)) + 1] = {
+    0, 326, 651, 975, 1297, 1617, 1933, 2246, 2555, 2860, 3159, 3453, 3742, 4025, 4302, 4572, 4836,
+    5094, 5344, 5589, 5826, 6058, 6282, 6500, 6712, 6917, 7117, 7310, 7498, 7679, 7856, 8026, 8192,
+};
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief a * b by shift and add over the bits of b, when the product fits in 16 bits.
+ */
+static uint16_t mul_u16_small(uint16_t a, uint8_t b)
+{
+    uint16_t product = 0;
+    while (b != 0) {
+        if (b & 1) {
+            product += a;
+        }
+        a <<= 1;
+        b >>= 1;
+    }
+    return product;
+}
+
+/**
+ * @brief Sine of an angle within the first quadrant, 0 to FIXED_ANGLE_QUARTER inclusive.
+ */
+static q15_t sin_quadrant(uint16_t angle)
+{
+    uint8_t index = (uint8_t)(angle >> SIN_STEP_LOG2);
+    uint8_t frac = (uint8_t)(angle & ((1U << SIN_STEP_LOG2) - 1));
+    q15_t value = sin_table[index];
+    if (frac == 0) {
+        return value; // Also keeps index + 1 within the table at 90 degrees
+    }
+    // The sine rises over the quadrant: the difference is positive.
+    uint16_t delta = (uint16_t)(sin_table[index + 1] - value);
+    uint16_t step = mul_u16_small(delta, frac) + (1U << (SIN_STEP_LOG2 - 1));
+    return (q15_t)(value + (step >> SIN_STEP_LOG2));
+}
+
+/**
+ * @brief floor(num * 2^ATAN_RATIO_BITS / den) for num < den, by restoring division.
+ */
+static uint16_t ratio_below_one(uint16_t num, uint16_t den)
+{
+    // num stays below den <= 32768, so doubling it never overflows.
+    uint16_t ratio = 0;
+    for (uint8_t i = 0; i < ATAN_RATIO_BITS; i++) {
+        num <<= 1;
+        ratio <<= 1;
+        if (num >= den) {
+            num -= den;
+            ratio |= 1;
+        }
+    }
+    return ratio;
+}
+
+/**
+ * @brief atan(num / den) in 1/16 angle counts, for num < den.
+ */
+static uint16_t atan_octant(uint16_t num, uint16_t den)
+{
+    uint16_t ratio = ratio_below_one(num, den);
+    uint8_t index = (uint8_t)(ratio >> ATAN_STEP_LOG2);
+    uint8_t frac = (uint8_t)(ratio & ((1U << ATAN_STEP_LOG2) - 1));
+    // The atan rises over the octant: the difference is positive.
+    uint16_t delta = atan_table[index + 1] - atan_table[index];
+    return atan_table[index] + (mul_u16_small(delta, frac) >> ATAN_STEP_LOG2);
+}
+
+// --- Public Function Definitions ---
+
+q15_t fixed_sin(uint16_t angle)
+{
+    angle &= FIXED_ANGLE_MASK;
+    uint16_t in_quadrant = angle & (FIXED_ANGLE_QUARTER - 1);
+    // The second and fourth quadrants run the table backwards.
+    if (angle & FIXED_ANGLE_QUARTER) {
+        in_quadrant = FIXED_ANGLE_QUARTER - in_quadrant;
+    }
+    q15_t value = sin_quadrant(in_quadrant);
+    return (angle & (2 * FIXED_ANGLE_QUARTER)) ? (q15_t)-value : value;
+}
+
+q15_t fixed_cos(uint16_t angle)
+{
+    return fixed_sin(angle + FIXED_ANGLE_QUARTER);
+}
+
+q16_t q16_mul(q16_t a, q16_t b)
+{
+    bool is_negative = (a < 0) != (b < 0);
+    uint32_t abs_a = (a < 0) ? -(uint32_t)a : (uint32_t)a;
+    uint32_t abs_b = (b < 0) ? -(uint32_t)b : (uint32_t)b;
+    uint16_t a_high = (uint16_t)(abs_a >> 16);
+    uint16_t a_low = (uint16_t)abs_a;
+    uint16_t b_high = (uint16_t)(abs_b >> 16);
+    uint16_t b_low = (uint16_t)abs_b;
+
+    // (a_high.a_low * b_high.b_low) >> 16: only the lowest partial product has bits below 2^16.
+    uint32_t product = ((uint32_t)a_high * b_high << 16) + (uint32_t)a_high * b_low
+        + (uint32_t)a_low * b_high + (((uint32_t)a_low * b_low) >> 16);
+    return is_negative ? -(q16_t)product : (q16_t)product;
+}
+
+uint16_t fixed_atan2(int16_t y, int16_t x)
+{
+    // Magnitudes up to 32768 fit in 16 bits unsigned.
+    uint16_t abs_x = (x < 0) ? -(uint16_t)x : (uint16_t)x;
+    uint16_t abs_y = (y < 0) ? -(uint16_t)y : (uint16_t)y;
+    if (abs_x == 0 && abs_y == 0) {
+        return 0;
+    }
+
+    // Fold into the first octant, then unfold: above the diagonal the angle
+    // is 90 degrees minus that of the swapped vector.
+    uint16_t octant;
+    if (abs_y < abs_x) {
+        octant = atan_octant(abs_y, abs_x);
+    } else if (abs_x < abs_y) {
+        octant = (FIXED_ANGLE_QUARTER << ATAN_FRAC_BITS) - atan_octant(abs_x, abs_y);
+    } else {
+        octant = (FIXED_ANGLE_QUARTER / 2) << ATAN_FRAC_BITS;
+    }
+    uint16_t angle = (octant + (1U << (ATAN_FRAC_BITS - 1))) >> ATAN_FRAC_BITS;
+
+    if (x < 0) {
+        angle = 2 * FIXED_ANGLE_QUARTER - angle;
+    }
+    if (y < 0) {
+        angle = FIXED_ANGLE_TURN - angle;
+    }
+    return angle & FIXED_ANGLE_MASK;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file fixed.h
+ * @brief Fixed-point kernels for a core without a hardware multiplier.
+ *
+ * The MSP430G2553 has no MPY peripheral: a multiplication or division the
+ * compiler cannot turn into shifts becomes a libgcc call that loops over every
+ * bit of the operands, a few hundred cycles for 32 bits. The kernels here
+ * avoid those calls:
+ * - Multiplications by a constant are spelled out as shifts and adds, built
+ *   up incrementally because each shift costs one instruction per bit.
+ * - Divisions by a constant multiply by the reciprocal with shifts and adds,
+ *   then correct the estimate with the exact remainder.
+ * - Sine, cosine and atan2 interpolate small flash tables, with the products
+ *   limited to a few bits of the interpolation fraction.
+ * - A Q16.16 product uses 16 x 16-bit partial products instead of 64 bits.
+ *
+ * Angles use the AS5600 scale: 12 bits, FIXED_ANGLE_TURN counts per turn,
+ * counter-clockwise from the positive x axis.
+ *
+ * The cycles of each kernel and of the plain C it replaces are measured by
+ * the fixed_* cases of the benchmark image (make bench). make fixed-check
+ * verifies their results and error bounds on the build machine.
+ */
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+#include "defines.h"
+
+// --- Public Constants ---
+
+#define FIXED_ANGLE_BITS 12
+#define FIXED_ANGLE_TURN (1U << FIXED_ANGLE_BITS) ///< 4096 counts: 360 degrees.
+#define FIXED_ANGLE_QUARTER (FIXED_ANGLE_TURN / 4) ///< 90 degrees.
+#define FIXED_ANGLE_MASK (FIXED_ANGLE_TURN - 1)
+
+#define Q15_ONE 0x7FFF ///< Largest Q15 value, 1 - 2^-15.
+#define Q16_ONE 0x10000L ///< 1.0 in Q16.16.
+
+/**
+ * @brief Converts a constant in [-1, 1) to Q15, rounded to nearest. For constant expressions only.
+ */
+#define Q15(value) ((q15_t)((value) * 32768.0 + ((value) < 0 ? -0.5 : 0.5)))
+
+/**
+ * @brief Converts a constant to Q16.16, rounded to nearest. For constant expressions only.
+ */
+#define Q16(value) ((q16_t)((value) * 65536.0 + ((value) < 0 ? -0.5 : 0.5)))
+
+// --- Public Type Definitions ---
+
+typedef int16_t q15_t; ///< Signed fraction in [-1, 1), 15 fractional bits.
+typedef int32_t q16_t; ///< Signed 16.16 fixed point.
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Sine of a 12-bit angle, within 1 LSB of the rounded exact value.
+ * @param angle Angle in FIXED_ANGLE_TURN counts per turn. Only the low 12 bits are used.
+ */
+q15_t fixed_sin(uint16_t angle);
+
+/**
+ * @brief Cosine of a 12-bit angle, within 1 LSB of the rounded exact value.
+ * @param angle Angle in FIXED_ANGLE_TURN counts per turn. Only the low 12 bits are used.
+ */
+q15_t fixed_cos(uint16_t angle);
+
+/**
+ * @brief Product of two Q16.16 values, rounded toward zero. The product must fit in Q16.16.
+ *
+ * Built from four 16 x 16 -> 32-bit partial products, so that libgcc is
+ * asked for those instead of a 64-bit multiplication.
+ */
+q16_t q16_mul(q16_t a, q16_t b);
+
+/**
+ * @brief Angle of the vector (x, y), within 1 count.
+ * @return Angle from 0 to FIXED_ANGLE_TURN - 1, 0 for the null vector.
+ */
+uint16_t fixed_atan2(int16_t y, int16_t x);
+
+// --- Public Inline Functions ---
+
+/**
+ * @brief Product of two Q15 values, rounded to nearest.
+ * @note Goes through the libgcc 32-bit multiplication: prefer the constant kernels below when
+ * one of the factors is known.
+ */
+FORCE_INLINE q15_t q15_mul(q15_t a, q15_t b)
+{
+    return (q15_t)(((int32_t)a * b + 0x4000) >> 15);
+}
+
+/**
+ * @brief x * 10 as (x * 4 + x) * 2.
+ */
+FORCE_INLINE uint32_t fixed_mul10_u32(uint32_t x)
+{
+    return ((x << 2) + x) << 1;
+}
+
+/**
+ * @brief x * 2000 as x * 2048 - x * 32 - x * 16: milliseconds to timebase ticks.
+ */
+FORCE_INLINE uint32_t fixed_mul2000_u32(uint32_t x)
+{
+    uint32_t shifted = x << 4;
+    uint32_t low = shifted; // x * 16
+    shifted <<= 1;
+    low += shifted; // + x * 32
+    shifted <<= 6;
+    return shifted - low; // x * 2048 - x * 48
+}
+
+/**
+ * @brief x / 10 and x % 10, for any x.
+ *
+ * The quotient estimate x * 0.8 / 8 is at most one below x / 10, and the
+ * remainder tells when to add it.
+ *
+ * @param rem Destination of x % 10. Must not be NULL.
+ */
+FORCE_INLINE uint32_t fixed_divmod10_u32(uint32_t x, uint8_t *rem)
+{
+    uint32_t q = (x >> 1) + (x >> 2);
+    q += q >> 4;
+    q += q >> 8;
+    q += q >> 16;
+    q >>= 3;
+    uint8_t r = (uint8_t)(x - fixed_mul10_u32(q));
+    if (r > 9) {
+        q++;
+        r -= 10;
+    }
+    *rem = r;
+    return q;
+}
+
+/**
+ * @brief x / 2000 and x % 2000 for x below 2^24: timebase ticks to milliseconds.
+ *
+ * 1 / 2000 is 1.024 / 2048, and 1 + 2^-6 + 2^-7 + 2^-11 is 1.02393: the
+ * estimate is at most one below x / 2000 over the range.
+ *
+ * @param rem Destination of x % 2000. Must not be NULL.
+ */
+FORCE_INLINE uint32_t fixed_divmod2000_u24(uint32_t x, uint16_t *rem)
+{
+    uint32_t shifted = x >> 6;
+    uint32_t sum = x + shifted;
+    shifted >>= 1;
+    sum += shifted;
+    shifted >>= 4;
+    sum += shifted;
+    uint32_t q = sum >> 11;
+    uint32_t r = x - fixed_mul2000_u32(q);
+    if (r >= 2000) {
+        q++;
+        r -= 2000;
+    }
+    *rem = (uint16_t)r;
+    return q;
+}
+
+#endif // FIXED_H
@@ -0,0 +1,40 @@
+/**
+ * @file format.c
+ * @brief Implementation of the decimal line formatting.
+ */
+#include "format.h"
+#include "fixed.h"
+
+// --- Public Function Definitions ---
+
+char *format_str(char *out, const char *str)
+{
+    while (*str != '\0') {
+        *out++ = *str++;
+    }
+    return out;
+}
+
+char *format_u32(char *out, uint32_t value)
+{
+    char digits[10];
+    uint8_t cnt = 0;
+    do {
+        uint8_t digit;
+        value = fixed_divmod10_u32(value, &digit);
+        digits[cnt++] = (char)('0' + digit);
+    } while (value != 0);
+    while (cnt > 0) {
+        *out++ = digits[--cnt];
+    }
+    return out;
+}
+
+char *format_i32(char *out, int32_t value)
+{
+    if (value < 0) {
+        *out++ = '-';
+        return format_u32(out, -(uint32_t)value);
+    }
+    return format_u32(out, (uint32_t)value);
+}
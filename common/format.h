@@ -0,0 +1,35 @@
+/**
+ * @file format.h
+ * @brief Decimal line formatting for the UART reports.
+ *
+ * Each function appends to a caller's line buffer and returns the new end of
+ * the line, so that a report is built as a chain of calls. Nothing is
+ * terminated or bounds-checked: the caller sizes the buffer for its longest
+ * line. Digits come from fixed_divmod10_u32(), not from the libgcc division.
+ */
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <stdint.h>
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Appends a NUL-terminated string, without its terminator.
+ * @return The new end of the line.
+ */
+char *format_str(char *out, const char *str);
+
+/**
+ * @brief Appends a number in decimal.
+ * @return The new end of the line.
+ */
+char *format_u32(char *out, uint32_t value);
+
+/**
+ * @brief Appends a signed number in decimal, with a leading '-' if negative.
+ * @return The new end of the line.
+ */
+char *format_i32(char *out, int32_t value);
+
+#endif // FORMAT_H
@@ -0,0 +1,64 @@
+/**
+ * @file stack.c
+ * @brief Implementation of the stack painting and high-water mark.
+ */
+#include "stack.h"
+#include <msp430.h>
+#include <stdint.h>
+
+#ifdef __MSP430__
+
+// --- Private Module Constants ---
+
+#define STACK_PAINT 0xA55Au ///< Unlikely as a return address, a saved register or a small integer.
+
+// --- Private Module Variables ---
+
+// From the msp430-elf linker script: end follows .bss and .noinit (it is the
+// start of the unused heap), and __stack is the top of RAM.
+extern uint16_t end[];
+extern uint16_t __stack[];
+
+// --- Public Function Definitions ---
+
+void stack_paint(void)
+{
+    // Everything below the current stack pointer is unused so far.
+    uint16_t *word = end;
+    uint16_t *sp = (uint16_t *)(uintptr_t)__get_SP_register();
+    while (word < sp) {
+        *word++ = STACK_PAINT;
+    }
+}
+
+uint16_t stack_high_water(void)
+{
+    const uint16_t *word = end;
+    while (word < __stack && *word == STACK_PAINT) {
+        word++;
+    }
+    return (uint16_t)((uintptr_t)__stack - (uintptr_t)word);
+}
+
+uint16_t stack_size(void)
+{
+    return (uint16_t)((uintptr_t)__stack - (uintptr_t)end);
+}
+
+#else
+
+// Host emulation build: the stack is the host process's.
+
+void stack_paint(void) { }
+
+uint16_t stack_high_water(void)
+{
+    return 0;
+}
+
+uint16_t stack_size(void)
+{
+    return 0;
+}
+
+#endif // __MSP430__
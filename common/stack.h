@@ -0,0 +1,40 @@
+/**
+ * @file stack.h
+ * @brief Stack painting and high-water mark.
+ *
+ * The stack grows down from the top of RAM towards the end of .bss (and
+ * .noinit). stack_paint() fills the free RAM between them with a pattern at
+ * startup; stack_high_water() later finds the deepest word that was
+ * overwritten. The static RAM side is reported at link time against
+ * RAM_BUDGET, see tools/ram_report.sh.
+ *
+ * On the host build the stack belongs to the host process: stack_paint() does
+ * nothing and both queries return 0.
+ */
+#ifndef STACK_H
+#define STACK_H
+
+#include <stdint.h>
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Fills the unused stack with the paint pattern.
+ * @note Must be called at the start of main(), with interrupts disabled.
+ */
+void stack_paint(void);
+
+/**
+ * @brief Returns the deepest stack use since stack_paint(), in bytes.
+ *
+ * Equal to stack_size() if the stack reached the end of .bss, in which case
+ * static variables may have been overwritten.
+ */
+uint16_t stack_high_water(void);
+
+/**
+ * @brief Returns the RAM available to the stack: from the end of .bss to the top of RAM, in bytes.
+ */
+uint16_t stack_size(void);
+
+#endif // STACK_H
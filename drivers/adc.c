@@ -0,0 +1,222 @@
+/**
+ * @file adc.c
+ * @brief Implementation of the timer-triggered ADC10 streaming.
+ *
+ * The DTC runs in two-block continuous mode over the caller's buffer. When it
+ * finishes a block it sets ADC10IFG and moves on to the other one by itself,
+ * so the ISR only records which block is complete and posts the run loop.
+ */
+#include "adc.h"
+
+#if BOARD_ADC_ENABLED
+
+#include <msp430.h>
+#include <stddef.h>
+#include "../common/critical.h"
+#include "../common/defines.h"
+#include "../common/format.h"
+#include "isr_profile.h"
+#include "runloop.h"
+#include "timebase.h"
+#include "trace.h"
+#include "uart.h"
+
+// --- Private Module Constants ---
+
+#define LINE_MAX 112
+
+// --- Private Module Variables ---
+
+static adc_stream_t stream;
+static bool is_running = false;
+static volatile const uint16_t *pending_block = NULL; ///< Filled, waiting for its callback.
+static volatile const uint16_t *latest_block = NULL; ///< Last block filled, for adc_report().
+static volatile adc_stats_t stats;
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Timebase periodic callback: the trigger output does the work, the interval stays.
+ */
+static uint16_t trigger_tick(void)
+{
+    return stream.interval_ticks;
+}
+
+/**
+ * @brief Run loop handler of RUNLOOP_EVENT_ADC: hands the filled block to the stream callback.
+ */
+static void adc_handle_block(void)
+{
+    critical_state_t state = critical_enter();
+    const uint16_t *block = (const uint16_t *)pending_block;
+    pending_block = NULL;
+    critical_exit(state);
+
+    if (block != NULL && stream.done != NULL) {
+        stream.done(block, stream.block_len);
+    }
+}
+
+/**
+ * @brief Millivolts of the reference of the stream in progress.
+ */
+static uint16_t ref_mv(void)
+{
+    switch (stream.ref) {
+    case ADC_REF_1V5:
+        return 1500;
+    case ADC_REF_2V5:
+        return 2500;
+    default:
+        return BOARD_VCC_MV;
+    }
+}
+
+// --- Public Function Definitions ---
+
+void adc_init(void)
+{
+    runloop_register(RUNLOOP_EVENT_ADC, adc_handle_block);
+}
+
+bool adc_start(const adc_stream_t *config)
+{
+    uint8_t seq_len = config->top_channel + 1;
+    if (config->buffer == NULL || config->top_channel >= ADC_CHANNEL_CNT || config->block_len == 0
+        || config->block_len % seq_len != 0 || config->interval_ticks < ADC_INTERVAL_MIN_TICKS) {
+        return false;
+    }
+
+    adc_stop();
+    stream = *config;
+    stats = (adc_stats_t) { 0, 0 };
+
+    // - INCH: the sequence runs from the top channel down to A0.
+    // - SHS_1: each conversion starts on a rising edge of TA0.1 (ISSH clear).
+    // - ADC10SSEL_0 | ADC10DIV_3: ADC10OSC / 4, whatever the clock profile.
+    // - CONSEQ_3: repeat-sequence, with MSC clear so that every step waits for its edge.
+    ADC10CTL1 = (uint16_t)(stream.top_channel * INCH_1) | SHS_1 | ADC10DIV_3 | ADC10SSEL_0
+        | CONSEQ_3;
+    uint16_t ref_bits = 0;
+    if (stream.ref == ADC_REF_1V5) {
+        ref_bits = SREF_1 | REFON;
+    } else if (stream.ref == ADC_REF_2V5) {
+        ref_bits = SREF_1 | REFON | REF2_5V;
+    }
+    // The reference settles (30 us) well before the first edge, one interval away.
+    ADC10CTL0 = ref_bits | ADC10SHT_3 | ADC10ON | ADC10IE;
+    ADC10AE0 = stream.analog_pins;
+
+    // Two blocks back to back, refilled forever: ADC10IFG is set at the end of each one.
+    ADC10DTC0 = ADC10TB | ADC10CT;
+    ADC10DTC1 = stream.block_len;
+    ADC10SA = (uintptr_t)stream.buffer; // Written last: starts the DTC at the first block
+    ADC10CTL0 |= ENC;
+
+    is_running = true;
+    timebase_periodic_start(stream.interval_ticks, trigger_tick);
+    timebase_periodic_set_trigger(true);
+    return true;
+}
+
+void adc_stop(void)
+{
+    if (!is_running) return;
+    is_running = false;
+
+    timebase_periodic_stop();
+    // Clearing CONSEQ with ENC stops even a repeat sequence at once.
+    ADC10CTL0 &= ~ENC;
+    ADC10CTL1 = 0;
+    while (ADC10CTL1 & ADC10BUSY);
+    ADC10CTL0 = 0;
+    ADC10DTC1 = 0;
+    ADC10AE0 = 0;
+
+    critical_state_t state = critical_enter();
+    pending_block = NULL;
+    latest_block = NULL;
+    critical_exit(state);
+}
+
+uint16_t adc_to_mv(uint16_t code)
+{
+    return (uint16_t)((uint32_t)code * ref_mv() / ADC_FULL_SCALE);
+}
+
+void adc_get_stats(adc_stats_t *out)
+{
+    critical_state_t state = critical_enter();
+    *out = stats;
+    critical_exit(state);
+}
+
+void adc_report(void)
+{
+    adc_stats_t counts;
+    adc_get_stats(&counts);
+    const uint16_t *block = (const uint16_t *)latest_block;
+
+    // e.g. "adc: 41 blocks, 0 overruns, A11 1800 mV, A10 1075 mV, A5 1350 mV\r\n"
+    char line[LINE_MAX];
+    char *end = format_str(line, "adc: ");
+    end = format_u32(end, counts.blocks);
+    end = format_str(end, " blocks, ");
+    end = format_u32(end, counts.overruns);
+    end = format_str(end, " overruns");
+    if (block != NULL) {
+        // Only the analog pins and the internal channels: the other pins read as noise.
+        uint8_t seq_len = stream.top_channel + 1;
+        for (uint8_t i = 0; i < seq_len; i++) {
+            uint8_t channel = stream.top_channel - i;
+            bool is_pin = channel < 8 && (stream.analog_pins & (1U << channel));
+            if (!is_pin && channel < ADC_CHANNEL_TEMP) continue;
+
+            uint32_t sum = 0;
+            for (uint8_t j = i; j < stream.block_len; j += seq_len) {
+                sum += block[j];
+            }
+            end = format_str(end, ", A");
+            end = format_u32(end, channel);
+            *end++ = ' ';
+            end = format_u32(end, adc_to_mv((uint16_t)(sum / (stream.block_len / seq_len))));
+            end = format_str(end, " mV");
+        }
+    }
+    end = format_str(end, "\r\n");
+
+    uart_write_all(line, (uint16_t)(end - line));
+}
+
+// --- Interrupt Service Routines ---
+
+/**
+ * @brief ADC10 ISR, fired when the DTC has filled a block.
+ */
+INTERRUPT_VECTOR(ADC10_VECTOR)
+void adc_isr(void)
+{
+    ISR_PROFILE_ENTER();
+    TRACE(TRACE_EVENT_ISR_BEGIN, ADC10_VECTOR);
+    // ADC10IFG is cleared by the interrupt acceptance.
+
+    // ADC10B1 is set once the first block is full, and cleared by the second.
+    const uint16_t *block = (ADC10DTC0 & ADC10B1) ? stream.buffer
+                                                  : stream.buffer + stream.block_len;
+    stats.blocks++;
+    if (pending_block != NULL) {
+        stats.overruns++;
+    }
+    latest_block = block;
+    if (stream.done != NULL) {
+        pending_block = block;
+        runloop_post(RUNLOOP_EVENT_ADC);
+    }
+
+    TRACE(TRACE_EVENT_ISR_END, ADC10_VECTOR);
+    ISR_PROFILE_EXIT(ISR_PROFILE_ADC10);
+    RUNLOOP_ISR_EXIT(ADC10_VECTOR);
+}
+
+#endif // BOARD_ADC_ENABLED
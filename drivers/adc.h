@@ -0,0 +1,136 @@
+/**
+ * @file adc.h
+ * @brief Timer-triggered ADC10 streaming into double-buffered blocks through the DTC.
+ *
+ * The ADC10 converts a sequence of channels in repeat-sequence mode, one
+ * conversion per rising edge of TA0.1, which the timebase periodic channel
+ * raises at exactly regular intervals. The Data Transfer Controller stores each
+ * result in RAM without the CPU and alternates between two blocks of the
+ * caller's buffer: while it fills one, the other is handed to the block
+ * callback from the run loop. The ADC10 interrupt fires, and the run loop
+ * wakes, once per block instead of once per conversion.
+ *
+ * Timer0_A runs the timebase in continuous mode, so the periodic channel still
+ * takes one short CCR1 interrupt per conversion to schedule the next edge. That
+ * interrupt does not wake the CPU from LPM0.
+ *
+ * A sequence always runs from its top channel down to A0, so channels in
+ * between are converted too (pins not enabled as analog inputs read as noise).
+ * The results of one pass over the sequence are stored in that order.
+ *
+ * Conversions use the ADC10 internal oscillator divided by 4 and a 64-clock
+ * sample time (41 to 69 us, above the 30 us the temperature sensor needs), so
+ * they do not depend on the clock profile and take 49 to 83 us each.
+ *
+ * The periodic channel is shared with the LED panel and the AS5600 I2C
+ * sampling. The driver is only built with BOARD_ADC_ENABLED.
+ */
+#ifndef ADC_H
+#define ADC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "../common/board.h"
+
+// --- Public Constants ---
+
+#define ADC_CHANNEL_TEMP 10 ///< Internal temperature sensor.
+#define ADC_CHANNEL_VMID 11 ///< (VCC - VSS) / 2.
+#define ADC_CHANNEL_CNT 12 ///< Channels A0 to A7, VREF+ and VREF- (8, 9), then the two above.
+#define ADC_FULL_SCALE 1023
+
+/**
+ * @brief Shortest interval between two conversions, with margin over the slowest ADC10 oscillator.
+ */
+#define ADC_INTERVAL_MIN_TICKS 200 // 100 us
+
+// --- Public Type Definitions ---
+
+/**
+ * @brief Voltage reference of a stream.
+ */
+typedef enum {
+    ADC_REF_VCC, ///< VCC to VSS: ratiometric sensors such as the AS5600 analog output.
+    ADC_REF_1V5, ///< Internal 1.5 V reference.
+    ADC_REF_2V5, ///< Internal 2.5 V reference, for VCC/2 up to VCC = 5 V.
+} adc_ref_e;
+
+/**
+ * @brief Block callback, executed from the run loop.
+ *
+ * The block stays untouched for one block time after the callback is posted,
+ * until the DTC comes back to it: copy or reduce it before then.
+ *
+ * @param block The filled block, in sequence order (top channel first).
+ * @param len Conversions in the block.
+ */
+typedef void (*adc_block_cb_t)(const uint16_t *block, uint8_t len);
+
+/**
+ * @brief A stream configuration, read by adc_start() only.
+ */
+typedef struct
+{
+    uint16_t *buffer; ///< Two blocks of block_len conversions, back to back.
+    uint8_t block_len; ///< Conversions per block, a multiple of top_channel + 1.
+    uint8_t top_channel; ///< First channel of the sequence, which then runs down to A0.
+    uint8_t analog_pins; ///< Port 1 pins switched to analog input (ADC10AE0), e.g. BIT5 for A5.
+    adc_ref_e ref;
+    uint16_t interval_ticks; ///< Timebase ticks between two conversions, at least ADC_INTERVAL_MIN_TICKS.
+    adc_block_cb_t done; ///< Called for each filled block, or NULL to keep only the latest for adc_report().
+} adc_stream_t;
+
+/**
+ * @brief Counters since the last adc_start() (they wrap).
+ */
+typedef struct
+{
+    uint16_t blocks; ///< Blocks filled.
+    uint16_t overruns; ///< Blocks filled again before their callback ran: the callback saw newer data.
+} adc_stats_t;
+
+#if BOARD_ADC_ENABLED
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Registers the run loop handler of the block callbacks.
+ * @note Must be called after timebase_init().
+ */
+void adc_init(void);
+
+/**
+ * @brief Starts streaming, replacing the stream in progress.
+ * @note Takes over the timebase periodic channel.
+ * @param stream The configuration. The buffer must stay valid until adc_stop().
+ * @return false if the configuration is invalid.
+ */
+bool adc_start(const adc_stream_t *stream);
+
+/**
+ * @brief Stops the conversions and the trigger, and switches the ADC10 and its reference off.
+ */
+void adc_stop(void);
+
+/**
+ * @brief Converts a result to millivolts for the reference of the stream in progress.
+ * @note ADC_REF_VCC results assume VCC is BOARD_VCC_MV.
+ */
+uint16_t adc_to_mv(uint16_t code);
+
+/**
+ * @brief Copies the counters.
+ * @param out Destination of the counters. Must not be NULL.
+ */
+void adc_get_stats(adc_stats_t *out);
+
+/**
+ * @brief Writes the counters and the mean of each channel over the latest block, in
+ * millivolts, as one line on the UART, waiting for room if needed.
+ * @note Must be called after uart_init().
+ */
+void adc_report(void);
+
+#endif // BOARD_ADC_ENABLED
+
+#endif // ADC_H
@@ -0,0 +1,216 @@
+/**
+ * @file as5600.c
+ * @brief Implementation of the AS5600 sampling, unwrapping and velocity filter.
+ *
+ * The timebase periodic callback and the I2C completion callback both run in
+ * interrupt context, and never at the same time, so the sample and counters
+ * are only guarded from the run loop side.
+ */
+#include "as5600.h"
+
+#if BOARD_HAS_AS5600
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "../common/critical.h"
+#include "../common/format.h"
+#include "i2c.h"
+#include "timebase.h"
+#include "uart.h"
+
+// --- Private Module Constants ---
+
+#define REG_STATUS 0x0B ///< Followed by RAW ANGLE (0x0C-0x0D).
+#define READ_LEN 3
+
+#define SAMPLE_TICKS (TIMEBASE_TICK_HZ / AS5600_SAMPLE_HZ)
+// Reads faster than the 150 us output refresh of the sensor would repeat values.
+_Static_assert(SAMPLE_TICKS >= 303 && SAMPLE_TICKS <= UINT16_MAX,
+    "AS5600_SAMPLE_HZ must be within 31 Hz and 6.6 kHz");
+
+/**
+ * @brief 60 * AS5600_SAMPLE_HZ / 2^(16 + 12) as RPM_SCALE / 2^22, after dropping 8 bits of the
+ * velocity: a sample moves at most half a turn, so the product stays below 2^19 * RPM_SCALE.
+ */
+#define RPM_VELOCITY_SHIFT 8
+#define RPM_SCALE ((60 * AS5600_SAMPLE_HZ) >> 6) ///< 1875 at 2 kHz.
+_Static_assert((60 * AS5600_SAMPLE_HZ) % 64 == 0 && RPM_SCALE < 4096,
+    "as5600_velocity_rpm needs AS5600_SAMPLE_HZ a multiple of 16 below 4.37 kHz");
+
+#define LINE_MAX 112
+
+// --- Private Module Variables ---
+
+static void read_done(i2c_transfer_t *transfer);
+
+static const uint8_t read_reg = REG_STATUS;
+static uint8_t read_buf[READ_LEN];
+static i2c_transfer_t read_transfer = {
+    .tx = &read_reg,
+    .rx = read_buf,
+    .tx_len = 1,
+    .rx_len = READ_LEN,
+    .address = AS5600_ADDRESS,
+    .status = I2C_STATUS_OK,
+    .done = read_done,
+};
+
+static as5600_sample_t sample;
+static bool has_sample = false;
+static as5600_stats_t stats = { .min_latency_ticks = UINT16_MAX };
+
+static uint32_t read_ticks = 0; ///< Tick at which the read in progress started.
+static uint16_t period_cnt = 0; ///< Sample periods elapsed, including skipped ones.
+static uint16_t read_period = 0; ///< period_cnt of the read in progress.
+static uint16_t sample_period = 0; ///< period_cnt of the latest sample.
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief I2C completion callback: turns a read into the next sample.
+ */
+static void read_done(i2c_transfer_t *transfer)
+{
+    if (transfer->status != I2C_STATUS_OK) {
+        stats.errors++;
+        return;
+    }
+
+    uint16_t angle = ((uint16_t)(read_buf[1] & 0x0F) << 8) | read_buf[2];
+    if (has_sample) {
+        // The shortest way around the circle: sign-extend the 12-bit difference.
+        int16_t delta = (int16_t)((uint16_t)(angle - sample.angle) << 4) >> 4;
+        sample.position += delta;
+        // After lost reads the delta spans several periods: keep the velocity
+        // rather than divide in the ISR.
+        if ((uint16_t)(read_period - sample_period) == 1) {
+            int32_t rate = (int32_t)delta << 16;
+            sample.velocity += (rate - sample.velocity) >> AS5600_VELOCITY_SHIFT;
+        }
+    } else {
+        sample.position = angle;
+        sample.velocity = 0;
+        has_sample = true;
+    }
+    sample.angle = angle;
+    sample.status = read_buf[0] & (AS5600_STATUS_MH | AS5600_STATUS_ML | AS5600_STATUS_MD);
+    sample.ticks = read_ticks;
+    sample_period = read_period;
+
+    uint16_t latency = (uint16_t)(timebase_ticks() - read_ticks);
+    if (latency < stats.min_latency_ticks) {
+        stats.min_latency_ticks = latency;
+    }
+    if (latency > stats.max_latency_ticks) {
+        stats.max_latency_ticks = latency;
+    }
+    stats.samples++;
+}
+
+/**
+ * @brief Timebase periodic callback: starts a read unless the previous one is still running.
+ */
+static uint16_t sample_tick(void)
+{
+    period_cnt++;
+    if (read_transfer.status == I2C_STATUS_PENDING) {
+        stats.overruns++;
+    } else {
+        read_ticks = timebase_ticks();
+        read_period = period_cnt;
+        if (!i2c_submit(&read_transfer)) {
+            stats.errors++;
+        }
+    }
+    return SAMPLE_TICKS;
+}
+
+/**
+ * @brief Converts timebase ticks to whole microseconds.
+ */
+static uint16_t ticks_to_us(uint16_t ticks)
+{
+    return ticks >> TIMEBASE_TICKS_PER_US_LOG2;
+}
+
+// --- Public Function Definitions ---
+
+void as5600_init(void)
+{
+    timebase_periodic_start(SAMPLE_TICKS, sample_tick);
+}
+
+bool as5600_get_sample(as5600_sample_t *out)
+{
+    critical_state_t state = critical_enter();
+    *out = sample;
+    bool is_valid = has_sample;
+    critical_exit(state);
+    return is_valid;
+}
+
+int32_t as5600_velocity_rpm(int32_t velocity)
+{
+    // counts/period * periods/min / counts/turn, with the Q16 and 4096 as one shift
+    _Static_assert(AS5600_COUNTS_PER_TURN == 1 << 12, "The conversion shift assumes 4096 counts");
+    return ((velocity >> RPM_VELOCITY_SHIFT) * (int32_t)RPM_SCALE) >> (22 - RPM_VELOCITY_SHIFT);
+}
+
+void as5600_get_stats(as5600_stats_t *out)
+{
+    critical_state_t state = critical_enter();
+    *out = stats;
+    critical_exit(state);
+}
+
+void as5600_reset_stats(void)
+{
+    critical_state_t state = critical_enter();
+    stats = (as5600_stats_t) { .min_latency_ticks = UINT16_MAX };
+    critical_exit(state);
+}
+
+void as5600_report(void)
+{
+    as5600_stats_t counts;
+    as5600_sample_t latest;
+    as5600_get_stats(&counts);
+    bool is_valid = as5600_get_sample(&latest);
+
+    // e.g. "as5600: 20000 samples, 0 errors, 0 overruns, latency 158-163 us, 600 rpm, pos 41026, MD\r\n"
+    char line[LINE_MAX];
+    char *end = format_str(line, "as5600: ");
+    end = format_u32(end, counts.samples);
+    end = format_str(end, " samples, ");
+    end = format_u32(end, counts.errors);
+    end = format_str(end, " errors, ");
+    end = format_u32(end, counts.overruns);
+    end = format_str(end, " overruns");
+    if (counts.samples > 0) {
+        end = format_str(end, ", latency ");
+        end = format_u32(end, ticks_to_us(counts.min_latency_ticks));
+        *end++ = '-';
+        end = format_u32(end, ticks_to_us(counts.max_latency_ticks));
+        end = format_str(end, " us");
+    }
+    if (is_valid) {
+        end = format_str(end, ", ");
+        end = format_i32(end, as5600_velocity_rpm(latest.velocity));
+        end = format_str(end, " rpm, pos ");
+        end = format_i32(end, latest.position);
+        if (latest.status & AS5600_STATUS_MD) {
+            end = format_str(end, ", MD");
+        }
+        if (latest.status & AS5600_STATUS_ML) {
+            end = format_str(end, ", ML");
+        }
+        if (latest.status & AS5600_STATUS_MH) {
+            end = format_str(end, ", MH");
+        }
+    }
+    end = format_str(end, "\r\n");
+
+    uart_write_all(line, (uint16_t)(end - line));
+}
+
+#endif // BOARD_HAS_AS5600
@@ -0,0 +1,142 @@
+/**
+ * @file boot.c
+ * @brief Implementation of the early boot hook and boot time measurement.
+ */
+#include "boot.h"
+#include <msp430.h>
+#include <stdbool.h>
+#include "../common/defines.h"
+#include "../common/format.h"
+#include "uart.h"
+
+// --- Private Module Constants ---
+
+#define BOOT_MAGIC 0xB007u
+#define BOOT_TA1CTL (TASSEL_2 | MC_2) ///< Continuous mode from SMCLK, as started by the early hook.
+#define RESET_FLAGS (WDTIFG | PORIFG | RSTIFG)
+
+// Immediates of the early hook, which cannot use the header macros from assembly.
+#define EARLY_WDTCTL "#0x5a80"
+#define EARLY_TA1CTL "#0x0224"
+_Static_assert((WDTPW | WDTHOLD) == 0x5a80 && (BOOT_TA1CTL | TACLR) == 0x0224,
+    "The early hook immediates are out of date");
+
+_Static_assert(BOOT_RESET_WDT == WDTIFG && BOOT_RESET_POR == PORIFG && BOOT_RESET_PIN == RSTIFG,
+    "BOOT_RESET_* must match the IFG1 flags");
+
+// --- Private Module Variables ---
+
+/**
+ * @brief State kept across resets: the C runtime neither clears nor initializes it.
+ */
+static NOINIT struct
+{
+    uint16_t magic; ///< BOOT_MAGIC once the counter is valid.
+    uint16_t boot_cnt;
+} persist;
+
+static boot_stats_t stats;
+static uint8_t marked = 0; ///< One bit per boot_mark_e already recorded.
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Returns the MCLK cycles counted by Timer1_A since the early hook.
+ */
+static uint32_t cycles_since_reset(void)
+{
+    bool is_overflowed = TA1CTL & TAIFG;
+    uint16_t counts = TA1R;
+    // An overflow between the two reads leaves a small count with the flag now set.
+    if (!is_overflowed && counts < 0x8000u && (TA1CTL & TAIFG)) {
+        is_overflowed = true;
+    }
+    return counts + (is_overflowed ? 0x10000ul : 0ul);
+}
+
+// --- Early Hook ---
+
+#ifdef __MSP430__
+
+/**
+ * @brief Runs between the stack pointer setup and the .bss clear of crt0.
+ *
+ * The msp430-elf startup code is made of .crt_* sections linked in name order
+ * and falling through into each other, so this must not return: naked, with
+ * no C code that could use the stack frame or registers.
+ */
+__attribute__((naked, used, section(".crt_0050boot"))) static void boot_early_init(void)
+{
+    __asm__ volatile("mov.w " EARLY_WDTCTL ", &WDTCTL\n\t"
+                     "mov.w " EARLY_TA1CTL ", &TA1CTL");
+}
+
+#else
+
+// Host emulation build: called by the model at reset, in place of the crt0 section.
+void boot_early_init(void);
+
+void boot_early_init(void)
+{
+    WDTCTL = WDTPW | WDTHOLD;
+    TA1CTL = BOOT_TA1CTL | TACLR;
+}
+
+#endif // __MSP430__
+
+// --- Public Function Definitions ---
+
+void boot_init(void)
+{
+    stats.mark_cycles[BOOT_MARK_MAIN] = cycles_since_reset();
+    marked = 1u << BOOT_MARK_MAIN;
+
+    stats.reset_flags = IFG1 & RESET_FLAGS;
+    IFG1 &= ~RESET_FLAGS;
+
+    if (persist.magic != BOOT_MAGIC || (stats.reset_flags & BOOT_RESET_POR)) {
+        persist.magic = BOOT_MAGIC;
+        persist.boot_cnt = 0;
+    }
+    stats.boot_cnt = ++persist.boot_cnt;
+}
+
+void boot_mark(boot_mark_e mark)
+{
+    // Images without boot_init(), such as the benchmark, own Timer1_A themselves.
+    if (!(marked & (1u << BOOT_MARK_MAIN)) || (marked & (1u << mark))) return;
+
+    stats.mark_cycles[mark] = cycles_since_reset();
+    marked |= 1u << mark;
+
+    if (mark == BOOT_MARK_CNT - 1 && (TA1CTL & ~(TAIFG | TAIE)) == BOOT_TA1CTL) {
+        TA1CTL = MC_0;
+    }
+}
+
+void boot_get_stats(boot_stats_t *out)
+{
+    *out = stats;
+}
+
+void boot_report(void)
+{
+    static const char *const reset_labels[] = { "wdt", "", "por", "pin" };
+    char line[80];
+    char *end = format_str(line, "boot ");
+    end = format_u32(end, stats.boot_cnt);
+    end = format_str(end, ": main ");
+    end = format_u32(end, stats.mark_cycles[BOOT_MARK_MAIN]);
+    end = format_str(end, " cycles, first LED ");
+    end = format_u32(end, stats.mark_cycles[BOOT_MARK_FIRST_LED]);
+    end = format_str(end, " cycles, reset");
+    for (uint8_t bit = 0; bit < ARRAY_SIZE(reset_labels); bit++) {
+        if (stats.reset_flags & (1u << bit)) {
+            *end++ = ' ';
+            end = format_str(end, reset_labels[bit]);
+        }
+    }
+    end = format_str(end, "\r\n");
+
+    uart_write_all(line, (uint16_t)(end - line));
+}
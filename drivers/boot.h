@@ -0,0 +1,83 @@
+/**
+ * @file boot.h
+ * @brief Early boot hook, reset cause and boot time measurement.
+ *
+ * The watchdog runs from reset with a 32768-cycle timeout, and the C runtime
+ * initialization (.data copy, .bss clear) runs before main(). An early hook
+ * placed in the crt0 startup sequence stops the watchdog right after the stack
+ * pointer is set, before any of that runs. It also starts Timer1_A in
+ * continuous mode from SMCLK, which equals MCLK in every clock profile, so that
+ * boot_mark() can timestamp the boot in CPU cycles from reset (plus the few
+ * cycles of the reset sequence itself).
+ *
+ * Timer1_A is handed over to the LED driver at the last mark, the first LED
+ * switched on. A 16-bit counter with its overflow flag covers up to 131072
+ * cycles: longer boots are reported as at least 65536 cycles more than counted.
+ *
+ * A boot counter survives resets in .noinit, validated by a magic word and
+ * restarted after each power-on.
+ *
+ * On the host build the model calls the early hook at reset, and cycles are
+ * counted from its simulated clock.
+ */
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+
+// --- Public Type Definitions ---
+
+/**
+ * @brief Boot milestones, each recorded once.
+ */
+typedef enum {
+    BOOT_MARK_MAIN, ///< Entry of main(), after the C runtime initialization.
+    BOOT_MARK_FIRST_LED, ///< First LED switched on: the end of the boot.
+    BOOT_MARK_CNT,
+} boot_mark_e;
+
+/**
+ * @brief Reset causes, from the IFG1 flags.
+ */
+#define BOOT_RESET_WDT 0x01 ///< Watchdog timeout or WDTCTL password violation (WDTIFG).
+#define BOOT_RESET_POR 0x04 ///< Power-on or brownout (PORIFG).
+#define BOOT_RESET_PIN 0x08 ///< RST/NMI pin (RSTIFG).
+
+typedef struct
+{
+    uint32_t mark_cycles[BOOT_MARK_CNT]; ///< MCLK cycles from reset to each mark, 0 until reached.
+    uint16_t boot_cnt; ///< Boots since the last power-on, this one included.
+    uint8_t reset_flags; ///< BOOT_RESET_* causes of this boot.
+} boot_stats_t;
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Records BOOT_MARK_MAIN, the reset cause and the boot count.
+ * @note Must be the first call in main(), before the watchdog is used as a timer.
+ */
+void boot_init(void);
+
+/**
+ * @brief Records a milestone if it is the first time it is reached.
+ *
+ * Does nothing before boot_init().
+ *
+ * The last mark stops the Timer1_A cycle count, unless a driver already took
+ * the timer over.
+ */
+void boot_mark(boot_mark_e mark);
+
+/**
+ * @brief Copies the boot measurements.
+ * @param out Destination of the measurements. Must not be NULL.
+ */
+void boot_get_stats(boot_stats_t *out);
+
+/**
+ * @brief Writes the boot measurements as one line on the UART, waiting for room if needed.
+ * @note Must be called after uart_init().
+ */
+void boot_report(void);
+
+#endif // BOOT_H
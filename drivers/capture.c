@@ -0,0 +1,360 @@
+/**
+ * @file capture.c
+ * @brief Implementation of the Timer1_A input capture.
+ *
+ * Each ring holds free-running 8-bit indices, like the I2C queue. The capture
+ * ISRs are the only writers; the run loop side reads with interrupts disabled.
+ */
+#include "capture.h"
+
+#if BOARD_CAPTURE_ENABLED
+
+#include <msp430.h>
+#include <stddef.h>
+#include "../common/critical.h"
+#include "../common/defines.h"
+#include "../common/fixed.h"
+#include "../common/format.h"
+#include "clock.h"
+#include "isr_profile.h"
+#include "runloop.h"
+#include "trace.h"
+#include "uart.h"
+
+_Static_assert((CAPTURE_RING_LEN & (CAPTURE_RING_LEN - 1)) == 0 && CAPTURE_RING_LEN <= 8,
+    "CAPTURE_RING_LEN must be a power of two up to 8");
+
+// --- Private Module Constants ---
+
+#define RING_MASK (CAPTURE_RING_LEN - 1)
+#define LINE_MAX 96
+
+// --- Private Structure Definitions ---
+
+/**
+ * @brief Edge ring and state of one channel.
+ */
+struct capture_channel_s
+{
+    uint32_t cycles[CAPTURE_RING_LEN];
+    uint8_t rising; ///< One bit per ring slot, set for a rising edge.
+    uint8_t head; ///< Advanced by the capture ISR.
+    uint8_t tail; ///< Advanced by capture_read(), or by the ISR when the ring is full.
+    uint8_t history; ///< Valid slots behind head, up to CAPTURE_RING_LEN, for capture_get_pwm().
+    capture_edge_e edges; ///< 0 while stopped.
+    capture_stats_t stats;
+};
+
+// --- Private Module Variables ---
+
+static volatile struct capture_channel_s channels[CAPTURE_CHANNEL_CNT];
+static volatile uint16_t overflow_cnt = 0; ///< High word of the timestamps.
+static uint32_t smclk_hz = 0;
+static uint8_t running_mask = 0;
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Returns the TA1CCTLx register of a channel.
+ */
+static volatile uint16_t *channel_ctl(uint8_t channel)
+{
+    return (channel == 0) ? &TA1CCTL0 : (channel == 1) ? &TA1CCTL1 : &TA1CCTL2;
+}
+
+/**
+ * @brief Returns the TA1CCRx register of a channel.
+ */
+static volatile uint16_t *channel_ccr(uint8_t channel)
+{
+    return (channel == 0) ? &TA1CCR0 : (channel == 1) ? &TA1CCR1 : &TA1CCR2;
+}
+
+/**
+ * @brief Empties the ring of a channel.
+ * @note Must be called with interrupts disabled.
+ */
+static void clear_ring(volatile struct capture_channel_s *ch)
+{
+    ch->tail = ch->head;
+    ch->history = 0;
+}
+
+/**
+ * @brief Stores the edge just captured on a channel.
+ * @note Called from the capture ISRs.
+ */
+static void store_edge(uint8_t channel)
+{
+    volatile uint16_t *ctl = channel_ctl(channel);
+    uint16_t count = *channel_ccr(channel);
+    uint16_t flags = *ctl;
+    if (flags & COV) {
+        *ctl &= ~COV;
+    }
+
+    // An overflow still pending came before the capture if the count is small.
+    uint16_t high = overflow_cnt;
+    if ((TA1CTL & TAIFG) && count < 0x8000u) {
+        high++;
+    }
+
+    volatile struct capture_channel_s *ch = &channels[channel];
+    if (ch->edges == 0) return;
+    if (flags & COV) {
+        ch->stats.missed++;
+    }
+    if ((uint8_t)(ch->head - ch->tail) == CAPTURE_RING_LEN) {
+        ch->tail++;
+        ch->stats.overruns++;
+    }
+
+    // On both edges, the input level right after the edge tells which one it was.
+    bool is_rising = (ch->edges == CAPTURE_EDGE_BOTH) ? (flags & CCI) != 0
+                                                      : ch->edges == CAPTURE_EDGE_RISING;
+    uint8_t slot = ch->head & RING_MASK;
+    ch->cycles[slot] = ((uint32_t)high << 16) | count;
+    if (is_rising) {
+        ch->rising |= 1u << slot;
+    } else {
+        ch->rising &= ~(1u << slot);
+    }
+    ch->head++;
+    if (ch->history < CAPTURE_RING_LEN) {
+        ch->history++;
+    }
+    ch->stats.edges++;
+}
+
+/**
+ * @brief Clock change callback: timestamps from before the change are not comparable.
+ */
+static void capture_clock_changed(void)
+{
+    smclk_hz = clock_smclk_hz();
+    for (uint8_t i = 0; i < CAPTURE_CHANNEL_CNT; i++) {
+        clear_ring(&channels[i]);
+    }
+}
+
+/**
+ * @brief Appends hundredths as a decimal number with two decimals.
+ * @return The new end of the line.
+ */
+static char *append_centi(char *out, uint32_t value)
+{
+    uint8_t hundredths;
+    uint8_t tenths;
+    value = fixed_divmod10_u32(value, &hundredths);
+    value = fixed_divmod10_u32(value, &tenths);
+    out = format_u32(out, value);
+    *out++ = '.';
+    *out++ = (char)('0' + tenths);
+    *out++ = (char)('0' + hundredths);
+    return out;
+}
+
+// --- Public Function Definitions ---
+
+void capture_init(void)
+{
+    smclk_hz = clock_smclk_hz();
+    // Continuous mode from SMCLK undivided: one count per cycle in every profile.
+    TA1CTL = TASSEL_2 | ID_0 | MC_2 | TACLR;
+    clock_register(CLOCK_CLIENT_CAPTURE, capture_clock_changed);
+}
+
+bool capture_start(uint8_t channel, capture_input_e input, capture_edge_e edges)
+{
+    if (channel >= CAPTURE_CHANNEL_CNT || edges < CAPTURE_EDGE_RISING || edges > CAPTURE_EDGE_BOTH) {
+        return false;
+    }
+
+    critical_state_t state = critical_enter();
+    volatile struct capture_channel_s *ch = &channels[channel];
+    clear_ring(ch);
+    ch->stats = (capture_stats_t) { 0, 0, 0 };
+    ch->edges = edges;
+    if (running_mask == 0) {
+        overflow_cnt = 0;
+        TA1CTL = (TA1CTL & ~TAIFG) | TAIE;
+        runloop_hold_lpm0(); // SMCLK clocks the timer
+    }
+    running_mask |= 1u << channel;
+    // SCS: captures synchronized to the timer clock, as recommended.
+    *channel_ctl(channel) = ((uint16_t)edges * CM_1) | ((input == CAPTURE_INPUT_B) ? CCIS_1 : CCIS_0)
+        | SCS | CAP | CCIE;
+    critical_exit(state);
+    return true;
+}
+
+void capture_stop(uint8_t channel)
+{
+    if (channel >= CAPTURE_CHANNEL_CNT) return;
+
+    critical_state_t state = critical_enter();
+    if (running_mask & (1u << channel)) {
+        *channel_ctl(channel) = 0;
+        channels[channel].edges = 0;
+        running_mask &= ~(1u << channel);
+        if (running_mask == 0) {
+            TA1CTL &= ~TAIE;
+            runloop_release_lpm0();
+        }
+    }
+    critical_exit(state);
+}
+
+bool capture_read(uint8_t channel, capture_event_t *out)
+{
+    if (channel >= CAPTURE_CHANNEL_CNT) return false;
+
+    critical_state_t state = critical_enter();
+    volatile struct capture_channel_s *ch = &channels[channel];
+    bool is_available = ch->head != ch->tail;
+    if (is_available) {
+        uint8_t slot = ch->tail & RING_MASK;
+        out->cycles = ch->cycles[slot];
+        out->is_rising = ch->rising & (1u << slot);
+        ch->tail++;
+    }
+    critical_exit(state);
+    return is_available;
+}
+
+bool capture_get_pwm(uint8_t channel, capture_pwm_t *out)
+{
+    if (channel >= CAPTURE_CHANNEL_CNT) return false;
+
+    uint32_t rise0 = 0;
+    uint32_t fall = 0;
+    uint32_t rise1 = 0;
+    bool is_valid = false;
+
+    critical_state_t state = critical_enter();
+    volatile struct capture_channel_s *ch = &channels[channel];
+    uint8_t newest = ch->head - 1;
+    uint8_t history = ch->history;
+    // The period ends on the latest rising edge.
+    if (history > 0 && !(ch->rising & (1u << (newest & RING_MASK)))) {
+        newest--;
+        history--;
+    }
+    if (history >= 3) {
+        uint8_t s1 = newest & RING_MASK;
+        uint8_t sf = (uint8_t)(newest - 1) & RING_MASK;
+        uint8_t s0 = (uint8_t)(newest - 2) & RING_MASK;
+        uint8_t rising = ch->rising;
+        is_valid = (rising & (1u << s1)) && !(rising & (1u << sf)) && (rising & (1u << s0));
+        rise1 = ch->cycles[s1];
+        fall = ch->cycles[sf];
+        rise0 = ch->cycles[s0];
+    }
+    uint32_t hz = smclk_hz;
+    critical_exit(state);
+
+    if (!is_valid) return false;
+
+    out->period_cycles = rise1 - rise0;
+    out->high_cycles = fall - rise0;
+    out->smclk_hz = hz;
+
+    // Q16 with a 32-bit division only: both scaled down until the period fits 16 bits.
+    uint32_t period = out->period_cycles;
+    uint32_t high = out->high_cycles;
+    while (period > UINT16_MAX) {
+        period >>= 1;
+        high >>= 1;
+    }
+    out->duty = (period != 0) ? (high << 16) / period : 0;
+    return true;
+}
+
+void capture_get_stats(uint8_t channel, capture_stats_t *out)
+{
+    if (channel >= CAPTURE_CHANNEL_CNT) return;
+
+    critical_state_t state = critical_enter();
+    *out = channels[channel].stats;
+    critical_exit(state);
+}
+
+void capture_report(void)
+{
+    for (uint8_t i = 0; i < CAPTURE_CHANNEL_CNT; i++) {
+        if (!(running_mask & (1u << i))) continue;
+
+        capture_stats_t counts;
+        capture_pwm_t pwm;
+        capture_get_stats(i, &counts);
+        bool is_valid = capture_get_pwm(i, &pwm);
+
+        // e.g. "capture: TA1.1 18398 edges, 0 missed, 919.98 Hz, duty 51.23%\r\n"
+        // (ring overruns are expected when only the PWM is measured)
+        char line[LINE_MAX];
+        char *end = format_str(line, "capture: TA1.");
+        end = format_u32(end, i);
+        *end++ = ' ';
+        end = format_u32(end, counts.edges);
+        end = format_str(end, " edges, ");
+        end = format_u32(end, counts.missed);
+        end = format_str(end, " missed");
+        if (is_valid && pwm.period_cycles != 0) {
+            end = format_str(end, ", ");
+            end = append_centi(end, pwm.smclk_hz * 100 / pwm.period_cycles);
+            end = format_str(end, " Hz, duty ");
+            end = append_centi(end, (pwm.duty * 10000) >> 16);
+            *end++ = '%';
+        }
+        end = format_str(end, "\r\n");
+
+        uart_write_all(line, (uint16_t)(end - line));
+    }
+}
+
+// --- Interrupt Service Routines ---
+
+/**
+ * @brief Timer1_A CCR0 ISR, a capture on channel 0.
+ */
+INTERRUPT_VECTOR(TIMER1_A0_VECTOR)
+void capture_ccr0_isr(void)
+{
+    ISR_PROFILE_ENTER();
+    TRACE(TRACE_EVENT_ISR_BEGIN, TIMER1_A0_VECTOR);
+    store_edge(0);
+    TRACE(TRACE_EVENT_ISR_END, TIMER1_A0_VECTOR);
+    ISR_PROFILE_EXIT(ISR_PROFILE_TIMER1_A0);
+    TRACE_ISR_EXIT();
+}
+
+/**
+ * @brief Timer1_A CCR1/CCR2/overflow ISR.
+ *
+ * TA1IV reports the captures before the overflow, so an overflow that
+ * happened just before a capture is still pending when the capture is stored.
+ */
+INTERRUPT_VECTOR(TIMER1_A1_VECTOR)
+void capture_isr(void)
+{
+    ISR_PROFILE_ENTER();
+    TRACE(TRACE_EVENT_ISR_BEGIN, TIMER1_A1_VECTOR);
+    switch (TA1IV) {
+    case TA1IV_TACCR1:
+        store_edge(1);
+        break;
+    case TA1IV_TACCR2:
+        store_edge(2);
+        break;
+    case TA1IV_TAIFG:
+        overflow_cnt++;
+        break;
+    default:
+        break;
+    }
+    TRACE(TRACE_EVENT_ISR_END, TIMER1_A1_VECTOR);
+    ISR_PROFILE_EXIT(ISR_PROFILE_TIMER1_A1);
+    TRACE_ISR_EXIT();
+}
+
+#endif // BOARD_CAPTURE_ENABLED
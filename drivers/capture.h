@@ -0,0 +1,140 @@
+/**
+ * @file capture.h
+ * @brief Timer1_A input capture: edge timestamps at one SMCLK cycle, period and duty.
+ *
+ * Timer1_A counts SMCLK undivided in continuous mode, and each of its three
+ * channels can capture the edges of its CCIxA or CCIxB pin:
+ * - Channel 0: P2.0 (A) or P2.3 (B).
+ * - Channel 1: P2.1 (A) or P2.2 (B).
+ * - Channel 2: P2.4 (A) or P2.5 (B).
+ *
+ * The hardware latches the counter on the edge itself, so the timestamps do
+ * not depend on the interrupt latency. The capture ISR extends them to 32
+ * bits with the overflow count and stores them with their level in a small
+ * per-channel ring, from which the period and duty of a PWM input are
+ * computed on demand: nothing polls the pins.
+ *
+ * The counter overflows every 4 ms at 16 MHz, which costs one short interrupt
+ * each time while a channel runs. Timestamps are only comparable within a
+ * clock profile: a clock change empties the rings. SMCLK must keep running,
+ * so a running channel holds the run loop in LPM0.
+ *
+ * Timer1_A counts the boot time until the last boot mark, and is shared with
+ * the LED driver for LEDs on its outputs. The driver is only built with
+ * BOARD_CAPTURE_ENABLED.
+ */
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "../common/board.h"
+
+// --- Public Constants ---
+
+#define CAPTURE_CHANNEL_CNT 3
+#define CAPTURE_RING_LEN 4 ///< Edges kept per channel, the oldest overwritten first. Power of two.
+#define CAPTURE_DUTY_ONE 0x10000UL ///< A duty cycle of 100% in Q16.
+
+// --- Public Type Definitions ---
+
+/**
+ * @brief Capture input of a channel.
+ */
+typedef enum {
+    CAPTURE_INPUT_A, ///< CCIxA pin.
+    CAPTURE_INPUT_B, ///< CCIxB pin.
+} capture_input_e;
+
+/**
+ * @brief Edges captured, as the CM field of TACCTLx.
+ */
+typedef enum {
+    CAPTURE_EDGE_RISING = 1,
+    CAPTURE_EDGE_FALLING = 2,
+    CAPTURE_EDGE_BOTH = 3, ///< Needed for the duty cycle.
+} capture_edge_e;
+
+/**
+ * @brief A captured edge.
+ */
+typedef struct
+{
+    uint32_t cycles; ///< SMCLK cycles since the driver started, wrapping every 268 s at 16 MHz.
+    bool is_rising;
+} capture_event_t;
+
+/**
+ * @brief Period and duty cycle of a PWM input, from its three latest edges.
+ */
+typedef struct
+{
+    uint32_t period_cycles; ///< SMCLK cycles from one rising edge to the next.
+    uint32_t high_cycles; ///< SMCLK cycles from that rising edge to the falling one.
+    uint32_t duty; ///< high / period in Q16 (CAPTURE_DUTY_ONE is 100%).
+    uint32_t smclk_hz; ///< SMCLK frequency the cycles were counted at.
+} capture_pwm_t;
+
+/**
+ * @brief Counters per channel since capture_start() (they wrap).
+ */
+typedef struct
+{
+    uint16_t edges; ///< Edges captured.
+    uint16_t overruns; ///< Edges overwritten in the ring before capture_read() took them.
+    uint16_t missed; ///< Edges lost because the previous capture was not read in time (COV).
+} capture_stats_t;
+
+#if BOARD_CAPTURE_ENABLED
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Starts Timer1_A from SMCLK and registers for clock changes.
+ * @note Must be called after the last boot mark (see boot.h).
+ */
+void capture_init(void);
+
+/**
+ * @brief Starts capturing the edges of a channel input, emptying its ring.
+ * @note The pin must be configured for its Timer1_A function (IO_SELECT_ALT1, input).
+ * @return false if the channel or edge is invalid.
+ */
+bool capture_start(uint8_t channel, capture_input_e input, capture_edge_e edges);
+
+/**
+ * @brief Stops capturing on a channel.
+ */
+void capture_stop(uint8_t channel);
+
+/**
+ * @brief Takes the oldest edge of a channel's ring.
+ * @param out Destination of the edge. Must not be NULL.
+ * @return false if the ring is empty.
+ */
+bool capture_read(uint8_t channel, capture_event_t *out);
+
+/**
+ * @brief Computes the period and duty cycle from the latest rising, falling
+ * and rising edges of a channel captured on both edges. The ring is not emptied.
+ * @param out Destination of the measurement. Must not be NULL.
+ * @return false until a full period has been captured since the start or the last clock change.
+ */
+bool capture_get_pwm(uint8_t channel, capture_pwm_t *out);
+
+/**
+ * @brief Copies the counters of a channel.
+ * @param out Destination of the counters. Must not be NULL.
+ */
+void capture_get_stats(uint8_t channel, capture_stats_t *out);
+
+/**
+ * @brief Writes the edge and missed counts, frequency and duty cycle of each running channel on
+ * the UART, one line per channel, waiting for room if needed.
+ * @note Must be called after uart_init().
+ */
+void capture_report(void);
+
+#endif // BOARD_CAPTURE_ENABLED
+
+#endif // CAPTURE_H
@@ -0,0 +1,177 @@
+/**
+ * @file clock.c
+ * @brief Implementation of the clock manager.
+ */
+#include "clock.h"
+#include <stddef.h>
+#include "../common/critical.h"
+#include "../common/defines.h"
+
+// --- Private Module Constants ---
+
+/**
+ * @brief DCO settings used when a profile's calibration data is erased.
+ *
+ * Typical datasheet frequencies: RSEL 7/DCO 3 (the reset setting) is about
+ * 1 MHz, RSEL 13/DCO 3 about 7.8 MHz and RSEL 15/DCO 3 about 15.25 MHz. The
+ * FLL then pulls the DCO onto the exact frequency.
+ */
+#define SEED_DCOCTL 0x60 // DCO 3, MOD 0
+#define SEED_BCSCTL1(rsel) (XT2OFF | (rsel))
+
+// --- Private Module Variables ---
+
+/**
+ * @brief Current DCO profile. The DCO comes out of reset at about 1.1 MHz.
+ */
+static clock_profile_e profile = CLOCK_PROFILE_1MHZ;
+static clock_aclk_e aclk_source = CLOCK_ACLK_LFXT1;
+
+/**
+ * @brief Change callbacks, indexed by clock_client_e.
+ */
+static clock_change_cb_t clients[CLOCK_CLIENT_CNT];
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Runs every registered change callback.
+ * @note Must be called with interrupts disabled.
+ */
+static void notify_clients(void)
+{
+    for (uint8_t i = 0; i < ARRAY_SIZE(clients); i++) {
+        if (clients[i] != NULL) {
+            clients[i]();
+        }
+    }
+}
+
+/**
+ * @brief Loads the DCO calibration of a profile, or its seed setting if the calibration is erased.
+ * @return false if the profile is invalid.
+ */
+static bool load_profile(clock_profile_e new_profile)
+{
+    uint8_t bc1;
+    uint8_t dco;
+    uint8_t seed_rsel;
+
+    switch (new_profile) {
+    case CLOCK_PROFILE_1MHZ:
+        bc1 = CALBC1_1MHZ;
+        dco = CALDCO_1MHZ;
+        seed_rsel = 7;
+        break;
+    case CLOCK_PROFILE_8MHZ:
+        bc1 = CALBC1_8MHZ;
+        dco = CALDCO_8MHZ;
+        seed_rsel = 13;
+        break;
+    case CLOCK_PROFILE_16MHZ:
+        bc1 = CALBC1_16MHZ;
+        dco = CALDCO_16MHZ;
+        seed_rsel = 15;
+        break;
+    default:
+        return false;
+    }
+    if (bc1 == 0xFF) {
+        bc1 = SEED_BCSCTL1(seed_rsel);
+        dco = SEED_DCOCTL;
+    }
+
+    // Select the lowest tap first, so the DCO never overshoots the target
+    // while the range changes.
+    DCOCTL = 0;
+    BCSCTL1 = bc1;
+    DCOCTL = dco;
+    profile = new_profile;
+    return true;
+}
+
+/**
+ * @brief Writes BCSCTL3 for an ACLK source.
+ */
+static void load_aclk(clock_aclk_e source)
+{
+    // The LaunchPad crystal needs 12.5 pF of load capacitance; the VLO needs none.
+    BCSCTL3 = (source == CLOCK_ACLK_VLO) ? LFXT1S_2 : (LFXT1S_0 | XCAP_3);
+    aclk_source = source;
+}
+
+// --- Public Function Definitions ---
+
+void clock_init(void)
+{
+    (void)load_profile(CLOCK_PROFILE_16MHZ);
+
+    // MCLK and SMCLK from the DCO, both undivided.
+    BCSCTL2 = SELM_0 | DIVM_0 | DIVS_0;
+
+    // ACLK keeps running in LPM3 and clocks the hardware LED blinking on Timer1_A.
+    load_aclk(CLOCK_ACLK_LFXT1);
+}
+
+bool clock_set_profile(clock_profile_e new_profile)
+{
+    if (new_profile == profile) return true;
+
+    critical_state_t state = critical_enter();
+    bool is_loaded = load_profile(new_profile);
+    if (is_loaded) {
+        notify_clients();
+    }
+    critical_exit(state);
+    return is_loaded;
+}
+
+void clock_set_aclk(clock_aclk_e source)
+{
+    if (source == aclk_source) return;
+
+    critical_state_t state = critical_enter();
+    load_aclk(source);
+    notify_clients();
+    critical_exit(state);
+}
+
+clock_profile_e clock_get_profile(void)
+{
+    return profile;
+}
+
+uint32_t clock_smclk_hz(void)
+{
+    switch (profile) {
+    case CLOCK_PROFILE_8MHZ:
+        return 8000000UL;
+    case CLOCK_PROFILE_16MHZ:
+        return 16000000UL;
+    default:
+        return 1000000UL;
+    }
+}
+
+uint32_t clock_aclk_hz(void)
+{
+    return (aclk_source == CLOCK_ACLK_VLO) ? CLOCK_VLO_HZ : CLOCK_LFXT1_HZ;
+}
+
+uint8_t clock_smclk_div_log2(uint32_t max_hz)
+{
+    uint32_t hz = clock_smclk_hz();
+    uint8_t div_log2 = 0;
+
+    while (div_log2 < CLOCK_DIV_LOG2_MAX && (hz >> div_log2) > max_hz) {
+        div_log2++;
+    }
+    return div_log2;
+}
+
+void clock_register(clock_client_e client, clock_change_cb_t callback)
+{
+    if (client >= CLOCK_CLIENT_CNT) return;
+
+    clients[client] = callback;
+}
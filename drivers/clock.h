@@ -0,0 +1,131 @@
+/**
+ * @file clock.h
+ * @brief Clock manager: runtime DCO profiles and ACLK source selection.
+ *
+ * MCLK and SMCLK both run from the DCO, loaded from the factory calibration
+ * of the selected profile. Drivers whose timing depends on a clock register a
+ * callback and recompute their dividers and periods when it changes, so the
+ * CPU can drop to 1 MHz while idle and go back to 16 MHz for bursts.
+ *
+ * Every profile runs SMCLK at a power-of-two multiple or fraction of the
+ * 2 MHz timebase tick, so the timebase keeps exact time across switches. There
+ * is no 12 MHz profile for that reason.
+ */
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <msp430.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// --- Public Constants ---
+
+#define CLOCK_LFXT1_HZ 32768UL ///< LaunchPad watch crystal.
+#define CLOCK_VLO_HZ 12000UL ///< Typical VLO frequency; it varies from 4 to 20 kHz between parts.
+#define CLOCK_DIV_LOG2_MAX 3 ///< Timer_A input dividers go up to 8.
+
+/**
+ * @brief Timer_A input divider bits (TAxCTL.ID) for a divider of 2^div_log2.
+ */
+#define CLOCK_TIMER_ID(div_log2) ((uint16_t)(div_log2) * ID_1)
+
+// --- Public Type Definitions ---
+
+/**
+ * @brief DCO profiles, setting both MCLK and SMCLK.
+ */
+typedef enum {
+    CLOCK_PROFILE_1MHZ, ///< Idle profile. Also the approximate DCO frequency after reset.
+    CLOCK_PROFILE_8MHZ,
+    CLOCK_PROFILE_16MHZ, ///< Default profile set by mcu_init().
+    CLOCK_PROFILE_CNT,
+} clock_profile_e;
+
+/**
+ * @brief ACLK sources.
+ */
+typedef enum {
+    CLOCK_ACLK_LFXT1, ///< 32.768 kHz crystal, accurate. Default.
+    CLOCK_ACLK_VLO, ///< Internal low-power oscillator, no crystal needed but inaccurate.
+} clock_aclk_e;
+
+/**
+ * @brief Clock change notification slots, one per client module.
+ */
+typedef enum {
+    CLOCK_CLIENT_TIMEBASE, ///< Timer0_A divider and tick scaling.
+    CLOCK_CLIENT_LED, ///< Timer1_A blink and PWM periods.
+    CLOCK_CLIENT_CAPTURE, ///< Timer1_A capture timestamps.
+    CLOCK_CLIENT_LED_PANEL, ///< USCI_B0 SPI clock divider.
+    CLOCK_CLIENT_I2C, ///< USCI_B0 I2C clock divider.
+    CLOCK_CLIENT_UART, ///< USCI_A0 baud rate divider.
+    CLOCK_CLIENT_FLL, ///< Restarts the DCO measurement. After CLOCK_CLIENT_TIMEBASE.
+    CLOCK_CLIENT_POWER, ///< Closes the residency interval. After CLOCK_CLIENT_TIMEBASE.
+    CLOCK_CLIENT_CNT,
+} clock_client_e;
+
+/**
+ * @brief Clock change callback.
+ *
+ * Called with interrupts disabled right after the clocks changed, in
+ * clock_client_e order. It should only reprogram the client's peripherals.
+ */
+typedef void (*clock_change_cb_t)(void);
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Sets the default clocks: 16 MHz DCO profile, SMCLK undivided, ACLK from LFXT1.
+ * @note Called by mcu_init(), before any client registers.
+ */
+void clock_init(void);
+
+/**
+ * @brief Switches the DCO to a profile and notifies the registered clients.
+ *
+ * The factory calibration of the profile is loaded. If it has been erased, a
+ * typical setting is loaded instead, which is only accurate once the FLL
+ * (see fll.h) has locked.
+ *
+ * @note Must not be called from an ISR, as it reprograms the timers of the ISRs.
+ * @param profile The profile to switch to.
+ * @return false if the profile is invalid.
+ */
+bool clock_set_profile(clock_profile_e profile);
+
+/**
+ * @brief Selects the ACLK source and notifies the registered clients.
+ * @param source The oscillator to clock ACLK from.
+ */
+void clock_set_aclk(clock_aclk_e source);
+
+/**
+ * @brief Returns the current DCO profile.
+ */
+clock_profile_e clock_get_profile(void);
+
+/**
+ * @brief Returns the nominal SMCLK (and MCLK) frequency of the current profile, in Hz.
+ */
+uint32_t clock_smclk_hz(void);
+
+/**
+ * @brief Returns the nominal ACLK frequency, in Hz.
+ */
+uint32_t clock_aclk_hz(void);
+
+/**
+ * @brief Returns the smallest power-of-two divider bringing SMCLK down to at most a frequency.
+ * @param max_hz The highest frequency the peripheral should be clocked at.
+ * @return log2 of the divider, at most CLOCK_DIV_LOG2_MAX.
+ */
+uint8_t clock_smclk_div_log2(uint32_t max_hz);
+
+/**
+ * @brief Registers the callback run when the clocks change.
+ * @param client The client slot.
+ * @param callback The function to call, or NULL to stop notifications.
+ */
+void clock_register(clock_client_e client, clock_change_cb_t callback);
+
+#endif // CLOCK_H
@@ -0,0 +1,263 @@
+/**
+ * @file fll.c
+ * @brief Implementation of the software FLL.
+ *
+ * Window lengths are measured in timebase ticks, which count SMCLK at the
+ * nominal 2 MHz of every clock profile, so the target is the same 500000
+ * ticks per window whatever the profile.
+ *
+ * The correction runs in the watchdog ISR with interrupts disabled, so it
+ * avoids the libgcc multiplications and divisions: errors are taken relative
+ * to the constant target rather than to the measured window.
+ */
+#include "fll.h"
+#include <msp430.h>
+#include "../common/critical.h"
+#include "../common/defines.h"
+#include "clock.h"
+#include "isr_profile.h"
+#include "timebase.h"
+#include "trace.h"
+
+// --- Private Module Constants ---
+
+#define GATE_ACLK_PERIODS 8192UL ///< WDTIS0: WDT interval of ACLK / 8192.
+#define WINDOWS_PER_S (CLOCK_LFXT1_HZ / GATE_ACLK_PERIODS) ///< 4 windows of 250 ms
+#define TARGET_TICKS (TIMEBASE_TICK_HZ / WINDOWS_PER_S) ///< 500000 ticks per window
+
+/**
+ * @brief Largest difference between two windows measured at the same DCO setting.
+ *
+ * Half an ACLK period: a gate serviced more than one ACLK period late reads
+ * the next edge and makes its two windows differ by a whole period.
+ */
+#define AGREE_TICKS ((int32_t)(TIMEBASE_TICK_HZ / CLOCK_LFXT1_HZ / 2))
+
+/**
+ * @brief DCO taps per unit of relative frequency error: 32 MOD steps per 8% DCO step.
+ *
+ * 32 / ln(1.08), from the typical DCO tap ratio of the datasheet.
+ */
+#define TAPS_PER_RATIO 416L
+
+/**
+ * @brief TAPS_PER_RATIO / TARGET_TICKS in Q20: taps per tick of window error (872.4).
+ */
+#define TAPS_PER_TICK_Q20 872L
+_Static_assert(TAPS_PER_TICK_Q20 == (TAPS_PER_RATIO << 20) / TARGET_TICKS
+        && TAPS_PER_TICK_Q20 == 8 + 32 + 64 + 256 + 512,
+    "error_to_taps() spells out the multiplication by TAPS_PER_TICK_Q20");
+
+/**
+ * @brief Window error below which the DCO counts as locked: a tap's worth.
+ */
+#define LOCK_ERROR_TICKS ((int32_t)(TARGET_TICKS / TAPS_PER_RATIO))
+#define TAP_STEP_MAX 32 ///< Largest correction per window pair: one DCO step.
+
+/**
+ * @brief Window error worth TAP_STEP_MAX taps.
+ */
+#define ERROR_STEP_MAX ((int32_t)(TAP_STEP_MAX * TARGET_TICKS / TAPS_PER_RATIO))
+
+#define TAP_MAX 0xE0 ///< DCO 7, MOD 0: MOD has no effect at DCO 7.
+#define RSEL_STEP_TAPS 125 ///< Taps in one RSEL step: 32 * ln(1.35) / ln(1.08).
+#define RSEL_MAX 15
+#define RSEL_MASK (RSEL3 | RSEL2 | RSEL1 | RSEL0)
+
+/**
+ * @brief Bound of the integrated timing error, in ticks (a few taps' worth).
+ *
+ * Keeps the integral from winding up while the DCO is far off, e.g. after a
+ * profile switch with erased calibration.
+ */
+#define PHASE_ERROR_MAX ((int32_t)(4 * TARGET_TICKS / TAPS_PER_RATIO))
+#define PHASE_GAIN_DIV 4 ///< Fraction of the integrated error corrected per window pair.
+
+// --- Private Module Variables ---
+
+/**
+ * @brief Length of the last accepted window in ticks, or 0 if none yet.
+ */
+static volatile uint32_t measured_ticks = 0;
+static volatile bool is_locked = false;
+
+/**
+ * @brief Tick of the last gate edge, valid when has_gate is set.
+ */
+static uint32_t last_gate = 0;
+static bool has_gate = false;
+
+/**
+ * @brief First window of the current pair, valid when has_first_window is set.
+ */
+static uint32_t first_window = 0;
+static bool has_first_window = false;
+
+/**
+ * @brief Ticks the timebase has lost against the crystal since the last restart.
+ */
+static int32_t phase_error = 0;
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Forgets the measurements in progress. Called with interrupts disabled.
+ */
+static void fll_restart(void)
+{
+    has_gate = false;
+    has_first_window = false;
+    phase_error = 0;
+    measured_ticks = 0;
+    is_locked = false;
+}
+
+/**
+ * @brief Moves the DCO by a number of taps, changing RSEL at the ends of the DCOCTL range.
+ */
+static void step_taps(int16_t taps)
+{
+    uint8_t rsel = BCSCTL1 & RSEL_MASK;
+    int16_t tap = (int16_t)DCOCTL + taps;
+
+    if (tap > TAP_MAX) {
+        if (rsel < RSEL_MAX) {
+            rsel++;
+            tap -= RSEL_STEP_TAPS;
+        } else {
+            tap = TAP_MAX;
+        }
+    } else if (tap < 0) {
+        if (rsel > 0) {
+            rsel--;
+            tap += RSEL_STEP_TAPS;
+        } else {
+            tap = 0;
+        }
+    }
+
+    // Write the register lowering the frequency first, so it never overshoots.
+    if (rsel > (BCSCTL1 & RSEL_MASK)) {
+        DCOCTL = (uint8_t)tap;
+        BCSCTL1 = (BCSCTL1 & ~RSEL_MASK) | rsel;
+    } else {
+        BCSCTL1 = (BCSCTL1 & ~RSEL_MASK) | rsel;
+        DCOCTL = (uint8_t)tap;
+    }
+}
+
+/**
+ * @brief Converts a window error in ticks to DCO taps, rounded to nearest, within TAP_STEP_MAX.
+ */
+static int16_t error_to_taps(int32_t error)
+{
+    if (error >= ERROR_STEP_MAX) return TAP_STEP_MAX;
+    if (error <= -ERROR_STEP_MAX) return -TAP_STEP_MAX;
+
+    // error * TAPS_PER_TICK_Q20 as shifts and adds, below 2^25 in magnitude.
+    uint32_t shifted = (uint32_t)error << 3;
+    uint32_t product = shifted; // * 8
+    shifted <<= 2;
+    product += shifted; // + * 32
+    shifted <<= 1;
+    product += shifted; // + * 64
+    shifted <<= 2;
+    product += shifted; // + * 256
+    shifted <<= 1;
+    product += shifted; // + * 512
+    return (int16_t)((int32_t)(product + (1UL << 19)) >> 20);
+}
+
+/**
+ * @brief Takes one measured window and corrects the DCO once two windows agree.
+ */
+static void fll_window(uint32_t ticks)
+{
+    if (!has_first_window) {
+        first_window = ticks;
+        has_first_window = true;
+        return;
+    }
+
+    int32_t diff = (int32_t)(ticks - first_window);
+    if (diff > AGREE_TICKS || diff < -AGREE_TICKS) {
+        // A gate was serviced late: start a new pair from this window.
+        first_window = ticks;
+        return;
+    }
+    has_first_window = false;
+    measured_ticks = ticks;
+
+    int32_t error = (int32_t)(TARGET_TICKS - ticks);
+    phase_error += error + (int32_t)(TARGET_TICKS - first_window);
+    if (phase_error > PHASE_ERROR_MAX) phase_error = PHASE_ERROR_MAX;
+    if (phase_error < -PHASE_ERROR_MAX) phase_error = -PHASE_ERROR_MAX;
+    is_locked = (error < 0 ? -error : error) < LOCK_ERROR_TICKS;
+
+    int16_t taps = error_to_taps(error + phase_error / PHASE_GAIN_DIV);
+    if (taps != 0) {
+        step_taps(taps);
+    }
+}
+
+// --- Public Function Definitions ---
+
+void fll_init(void)
+{
+    // CCR2 captures the timer on every rising ACLK edge (CCI2B), without interrupts.
+    TA0CCTL2 = CM_1 | CCIS_1 | SCS | CAP;
+
+    // Watchdog as an interval timer of ACLK / 8192, the measurement gate.
+    WDTCTL = WDTPW | WDTTMSEL | WDTCNTCL | WDTSSEL | WDTIS0;
+    IE1 |= WDTIE;
+
+    clock_register(CLOCK_CLIENT_FLL, fll_restart);
+}
+
+uint32_t fll_measured_hz(void)
+{
+    critical_state_t state = critical_enter();
+    uint32_t ticks = measured_ticks;
+    critical_exit(state);
+
+    // Ticks are nominal 0.5 us, so scale by the profile's SMCLK per tick.
+    return (ticks * WINDOWS_PER_S * (clock_smclk_hz() / 1000000UL)) >> TIMEBASE_TICKS_PER_US_LOG2;
+}
+
+bool fll_is_locked(void)
+{
+    return is_locked;
+}
+
+// --- Interrupt Service Routines ---
+
+/**
+ * @brief Watchdog interval ISR, at each gate edge of the measurement.
+ *
+ * Runs without waking the CPU: the correction needs no main loop work.
+ */
+INTERRUPT_VECTOR(WDT_VECTOR)
+void fll_gate_isr(void)
+{
+    ISR_PROFILE_ENTER();
+    TRACE(TRACE_EVENT_ISR_BEGIN, WDT_VECTOR);
+
+    // Read the capture first, before the next ACLK edge replaces it.
+    uint16_t capture = TA0CCR2;
+    ISR_PROFILE_LATENCY(capture); // The gate edge, unless more than one ACLK period ago
+    uint32_t gate = timebase_capture_ticks(capture);
+
+    if (clock_aclk_hz() != CLOCK_LFXT1_HZ || (BCSCTL3 & LFXT1OF)) {
+        fll_restart();
+    } else {
+        if (has_gate) {
+            fll_window(gate - last_gate);
+        }
+        last_gate = gate;
+        has_gate = true;
+    }
+
+    TRACE(TRACE_EVENT_ISR_END, WDT_VECTOR);
+    ISR_PROFILE_EXIT(ISR_PROFILE_WDT);
+    TRACE_ISR_EXIT();
+}
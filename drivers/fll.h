@@ -0,0 +1,46 @@
+/**
+ * @file fll.h
+ * @brief Software frequency-locked loop holding the DCO on frequency against the 32 kHz crystal.
+ *
+ * The watchdog timer, in interval mode from ACLK, marks a gate every 8192
+ * crystal periods (250 ms). Timer0_A CCR2 captures every ACLK edge, so at each
+ * gate the latest capture gives the timebase tick of the gate edge, and each
+ * window measures SMCLK over exactly 250 ms of crystal time.
+ *
+ * When two consecutive windows agree, the DCO taps (DCOCTL MOD/DCO, and
+ * BCSCTL1 RSEL when they run out) are stepped towards the nominal frequency
+ * of the clock profile. A tap is about 0.24%, so the loop also integrates the
+ * timing error and alternates between the two nearest taps: the timebase
+ * then follows the crystal on average instead of staying up to half a tap off.
+ *
+ * The loop pauses while ACLK runs from the VLO or the crystal is faulty.
+ */
+#ifndef FLL_H
+#define FLL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Starts the background DCO measurement and correction.
+ *
+ * Takes the watchdog timer (interval mode) and Timer0_A CCR2 (capture mode).
+ *
+ * @note Must be called after timebase_init().
+ */
+void fll_init(void);
+
+/**
+ * @brief Returns the SMCLK frequency measured over the last accepted window.
+ * @return The frequency in Hz (32 Hz resolution at 16 MHz), or 0 if not measured yet.
+ */
+uint32_t fll_measured_hz(void);
+
+/**
+ * @brief Returns whether the DCO is within one tap of the profile's nominal frequency.
+ */
+bool fll_is_locked(void);
+
+#endif // FLL_H
@@ -7,105 +7,90 @@
  * hardware registers.
  */
 #include "gpio.h"
+#include <stddef.h>
+#include "../common/critical.h"
 #include "../common/defines.h"
+#include "isr_profile.h"
+#include "runloop.h"
+#include "timebase.h"
+#include "trace.h"
 
-// MACROS to decode the port and pin information from a gpio_e enum value.
-// The enum is structured such that:
-// - Bits 3-4 represent the port index (0 for Port 1, 1 for Port 2).
-// - Bits 0-2 represent the pin index (0-7).
+// Expansions of the BOARD_PINS() table into whole-port register values.
+// Each X() entry contributes its pin bit to a port mask when the given column
+// matches, so every mask below is a compile-time constant.
 
-#define IO_PORT_CNT (2u) ///< Number of GPIO ports handled by this driver (P1, P2).
-#define IO_PIN_CNT_PER_PORT (8u)
-#define IO_PORT_OFFSET (3u) ///< Bit offset for the port number within the enum value.
-#define IO_PORT_MASK (0x3u << IO_PORT_OFFSET) ///< Mask to isolate the port number bits.
-#define IO_PIN_MASK (0x7u) ///< Mask to isolate the pin number bits.
+#define BOARD_PIN_BIT(port, pin) (1u << (((port) - 1u) * IO_PIN_CNT_PER_PORT + (pin)))
 
-#define UNUSED_CONFIG                                                                              \
-    {                                                                                              \
-        IO_SELECT_GPIO, IO_RESISTOR_ENABLED, IO_DIR_OUTPUT, IO_OUT_LOW                             \
-    }
+#define MASK_ALL(alias, port, pin, select, resistor, dir, out) | BOARD_PIN_BIT(port, pin)
+#define SUM_ALL(alias, port, pin, select, resistor, dir, out) + BOARD_PIN_BIT(port, pin)
+#define MASK_DIR(alias, port, pin, select, resistor, dir, out)                                     \
+    | (((dir) == IO_DIR_OUTPUT) ? BOARD_PIN_BIT(port, pin) : 0u)
+#define MASK_REN(alias, port, pin, select, resistor, dir, out)                                     \
+    | (((resistor) == IO_RESISTOR_ENABLED) ? BOARD_PIN_BIT(port, pin) : 0u)
+#define MASK_OUT(alias, port, pin, select, resistor, dir, out)                                     \
+    | (((out) == IO_OUT_HIGH) ? BOARD_PIN_BIT(port, pin) : 0u)
+#define MASK_SEL1(alias, port, pin, select, resistor, dir, out)                                    \
+    | (((select) == IO_SELECT_ALT1 || (select) == IO_SELECT_ALT3) ? BOARD_PIN_BIT(port, pin) : 0u)
+#define MASK_SEL2(alias, port, pin, select, resistor, dir, out)                                    \
+    | (((select) == IO_SELECT_ALT2 || (select) == IO_SELECT_ALT3) ? BOARD_PIN_BIT(port, pin) : 0u)
+#define CHECK_ALIAS(alias, port, pin, select, resistor, dir, out)                                  \
+    _Static_assert((port) >= 1 && (port) <= IO_PORT_CNT && (pin) < IO_PIN_CNT_PER_PORT,            \
+        #alias " is not on a valid port pin");                                                     \
+    _Static_assert(!((select) != IO_SELECT_GPIO && (resistor) == IO_RESISTOR_ENABLED),             \
+        #alias " enables a resistor on a peripheral pin");
 
-// These arrays store pointers to the memory-mapped hardware registers for each port.
-// - 'volatile' is used to ensure the compiler does not optimize away register accesses,
-//   as their values can change unexpectedly by hardware.
-// - 'const' (after the '*') makes the pointers themselves constant; they will always
-//   point to the same hardware register address after initialization.
-// This array-based approach allows functions to access registers for any port
-// using a simple index, making the code more scalable and readable.
-
-/// @brief Array of pointers to the Port Direction registers (P1DIR, P2DIR).
-static volatile uint8_t *const port_dir_regs[IO_PORT_CNT] = { &P1DIR, &P2DIR };
-/// @brief Array of pointers to the Port Resistor Enable registers (P1REN, P2REN).
-static volatile uint8_t *const port_ren_regs[IO_PORT_CNT] = { &P1REN, &P2REN };
-/// @brief Array of pointers to the Port Output registers (P1OUT, P2OUT).
-static volatile uint8_t *const port_out_regs[IO_PORT_CNT] = { &P1OUT, &P2OUT };
-/// @brief Array of pointers to the Port Input registers (P1IN, P2IN).
-static volatile uint8_t *const port_in_regs[IO_PORT_CNT] = { &P1IN, &P2IN };
-/// @brief Array of pointers to the Port Select 1 registers (P1SEL, P2SEL).
-static volatile uint8_t *const port_sel1_regs[IO_PORT_CNT] = { &P1SEL, &P2SEL };
-/// @brief Array of pointers to the Port Select 2 registers (P1SEL2, P2SEL2).
-static volatile uint8_t *const port_sel2_regs[IO_PORT_CNT] = { &P1SEL2, &P2SEL2 };
-
-// This array holds the initial configuration for all IO pins.
-static const gpio_config_t io_initial_configs[IO_PORT_CNT * IO_PIN_CNT_PER_PORT] = {
-    // Output
-    [IO_UART_RX] = { IO_SELECT_GPIO, IO_RESISTOR_DISABLED, IO_DIR_OUTPUT, IO_OUT_LOW },
-    [IO_UART_TX] = { IO_SELECT_GPIO, IO_RESISTOR_DISABLED, IO_DIR_OUTPUT, IO_OUT_LOW },
-    [IO_LED_GREEN] = { IO_SELECT_GPIO, IO_RESISTOR_DISABLED, IO_DIR_OUTPUT, IO_OUT_LOW },
-    [IO_LED_RED] = { IO_SELECT_GPIO, IO_RESISTOR_DISABLED, IO_DIR_OUTPUT, IO_OUT_LOW },
-    [IO_UNUSED_1] = UNUSED_CONFIG,
-    [IO_UNUSED_2] = UNUSED_CONFIG,
-    [IO_UNUSED_3] = UNUSED_CONFIG,
-    [IO_UNUSED_4] = UNUSED_CONFIG,
-    [IO_UNUSED_5] = UNUSED_CONFIG,
-    [IO_UNUSED_6] = UNUSED_CONFIG,
-    [IO_UNUSED_7] = UNUSED_CONFIG,
-    [IO_UNUSED_8] = UNUSED_CONFIG,
-    [IO_UNUSED_9] = UNUSED_CONFIG,
-    [IO_UNUSED_10] = UNUSED_CONFIG,
-    [IO_UNUSED_11] = UNUSED_CONFIG,
-    [IO_UNUSED_12] = UNUSED_CONFIG,
-};
+/// @brief 16-bit masks covering P1 (low byte) and P2 (high byte).
+#define BOARD_MASK(expand) (0u BOARD_PINS(expand))
 
-/**
- * @brief Extracts the port index from a gpio_e enum value.
- * @param gpio The GPIO pin identifier.
- * @return The port index (0 for Port 1, 1 for Port 2).
- */
-static uint8_t gpio_port(gpio_e gpio)
-{
-    return (gpio & IO_PORT_MASK) >> IO_PORT_OFFSET;
-}
+// A pin listed twice makes the sum of the pin bits differ from their union.
+_Static_assert((0ul BOARD_PINS(SUM_ALL)) == BOARD_MASK(MASK_ALL), "A port pin is assigned twice");
+_Static_assert(BOARD_MASK(MASK_ALL) == 0xFFFFu, "Every port pin must be assigned in board.h");
+BOARD_PINS(CHECK_ALIAS)
 
-/**
- * @brief Extracts the pin index (0-7) from a gpio_e enum value.
- * @param gpio The GPIO pin identifier.
- * @return The pin index within its port (0-7).
- */
-static inline uint8_t gpio_pin_idx(gpio_e gpio)
-{
-    return gpio & IO_PIN_MASK;
-}
+#define PORT_BYTE(mask, port_idx) ((uint8_t)((mask) >> ((port_idx) * IO_PIN_CNT_PER_PORT)))
+
+/// @brief First pin of a port, used to select its registers with GPIO_PORT_REG().
+#define PORT_FIRST_PIN(port_idx) ((gpio_e)((port_idx) << IO_PORT_OFFSET))
+
+/// @brief Edge callbacks, indexed by the pin's gpio_e value.
+static gpio_isr_cb_t isr_callbacks[IO_PORT_CNT * IO_PIN_CNT_PER_PORT];
+
+/// @brief Pins whose edge select is flipped after each interrupt, one mask per port.
+static uint8_t both_edge_pins[IO_PORT_CNT];
 
 /**
- * @brief Creates a bitmask for a specific pin from a gpio_e enum value.
- *
- * This is used to read or modify the specific bit corresponding to a pin
- * within a hardware register.
+ * @brief State of the bit-parallel input debouncer.
  *
- * @param gpio The GPIO pin identifier.
- * @return A bitmask with a single bit set (e.g., 0b00000001 for pin 0).
+ * Bit n of every field belongs to the pin whose gpio_e value is n. The two
+ * counter fields form one 2-bit counter per pin, stored as bit-slices.
  */
-static uint8_t gpio_pin_bit(gpio_e gpio)
+static volatile struct
 {
-    return 1 << gpio_pin_idx(gpio);
-}
+    uint16_t mask; ///< Pins being debounced.
+    uint16_t state; ///< Debounced levels.
+    uint16_t cnt0; ///< Low bit of each pin's vertical counter.
+    uint16_t cnt1; ///< High bit of each pin's vertical counter.
+    uint16_t rising; ///< Rising edges not yet taken.
+    uint16_t falling; ///< Falling edges not yet taken.
+    uint32_t next_sample; ///< Timebase tick of the next sample while sampling.
+    bool is_sampling; ///< Flag indicating if the sample alarm is running.
+} debounce;
 
 void gpio_init(void)
 {
-    for (gpio_e io = (gpio_e)IO_10; io < ARRAY_SIZE(io_initial_configs); io++) {
-        gpio_configure(io, &io_initial_configs[io]);
-    }
+    // Select the pin functions first so peripheral pins never glitch as GPIOs,
+    // then set the output levels before enabling the output drivers.
+    P1SEL = PORT_BYTE(BOARD_MASK(MASK_SEL1), 0);
+    P1SEL2 = PORT_BYTE(BOARD_MASK(MASK_SEL2), 0);
+    P1OUT = PORT_BYTE(BOARD_MASK(MASK_OUT), 0);
+    P1REN = PORT_BYTE(BOARD_MASK(MASK_REN), 0);
+    P1DIR = PORT_BYTE(BOARD_MASK(MASK_DIR), 0);
+
+    P2SEL = PORT_BYTE(BOARD_MASK(MASK_SEL1), 1);
+    P2SEL2 = PORT_BYTE(BOARD_MASK(MASK_SEL2), 1);
+    P2OUT = PORT_BYTE(BOARD_MASK(MASK_OUT), 1);
+    P2REN = PORT_BYTE(BOARD_MASK(MASK_REN), 1);
+    P2DIR = PORT_BYTE(BOARD_MASK(MASK_DIR), 1);
 }
 
 /**
@@ -115,17 +100,16 @@ void gpio_init(void)
  */
 void gpio_set_direction(gpio_e gpio, gpio_dir_e direction)
 {
-    uint8_t port = gpio_port(gpio);
-    uint8_t pin = gpio_pin_bit(gpio);
+    uint8_t pin = GPIO_PIN_BIT(gpio);
 
     switch (direction) {
     case IO_DIR_INPUT:
         // Clear the corresponding bit in the Port Direction register (PxDIR) to set as input.
-        *port_dir_regs[port] &= ~pin;
+        GPIO_PORT_REG(gpio, DIR) &= ~pin;
         break;
     case IO_DIR_OUTPUT:
         // Set the corresponding bit in the Port Direction register (PxDIR) to set as output.
-        *port_dir_regs[port] |= pin;
+        GPIO_PORT_REG(gpio, DIR) |= pin;
         break;
     }
 }
@@ -137,17 +121,16 @@ void gpio_set_direction(gpio_e gpio, gpio_dir_e direction)
  */
 void gpio_set_resistor(gpio_e gpio, gpio_resistor_e resistor)
 {
-    uint8_t port = gpio_port(gpio);
-    uint8_t pin = gpio_pin_bit(gpio);
+    uint8_t pin = GPIO_PIN_BIT(gpio);
 
     switch (resistor) {
     case IO_RESISTOR_DISABLED:
         // Clear the corresponding bit in the Port Resistor Enable register (PxREN).
-        *port_ren_regs[port] &= ~pin;
+        GPIO_PORT_REG(gpio, REN) &= ~pin;
         break;
     case IO_RESISTOR_ENABLED:
         // Set the corresponding bit in the Port Resistor Enable register (PxREN).
-        *port_ren_regs[port] |= pin;
+        GPIO_PORT_REG(gpio, REN) |= pin;
         break;
     }
 }
@@ -163,84 +146,282 @@ void gpio_set_resistor(gpio_e gpio, gpio_resistor_e resistor)
  */
 void gpio_set_select(gpio_e gpio, gpio_select_e select)
 {
-    uint8_t port = gpio_port(gpio);
-    uint8_t pin = gpio_pin_bit(gpio);
+    uint8_t pin = GPIO_PIN_BIT(gpio);
 
     switch (select) {
     case IO_SELECT_GPIO:
         // PxSEL=0, PxSEL2=0 for General-purpose I/O.
-        *port_sel1_regs[port] &= ~pin;
-        *port_sel2_regs[port] &= ~pin;
+        GPIO_PORT_REG(gpio, SEL) &= ~pin;
+        GPIO_PORT_REG(gpio, SEL2) &= ~pin;
         break;
     case IO_SELECT_ALT1:
         // PxSEL=1, PxSEL2=0 for Primary peripheral module function.
-        *port_sel1_regs[port] |= pin;
-        *port_sel2_regs[port] &= ~pin;
+        GPIO_PORT_REG(gpio, SEL) |= pin;
+        GPIO_PORT_REG(gpio, SEL2) &= ~pin;
         break;
     case IO_SELECT_ALT2:
         // PxSEL=0, PxSEL2=1 for Secondary peripheral module function.
-        *port_sel1_regs[port] &= ~pin;
-        *port_sel2_regs[port] |= pin;
+        GPIO_PORT_REG(gpio, SEL) &= ~pin;
+        GPIO_PORT_REG(gpio, SEL2) |= pin;
         break;
     case IO_SELECT_ALT3:
         // PxSEL=1, PxSEL2=1 for Tertiary peripheral module function.
-        *port_sel1_regs[port] |= pin;
-        *port_sel2_regs[port] |= pin;
+        GPIO_PORT_REG(gpio, SEL) |= pin;
+        GPIO_PORT_REG(gpio, SEL2) |= pin;
         break;
     }
 }
 
 /**
- * @brief Sets the output logic level of a specific GPIO pin.
+ * @brief Configures a single GPIO pin using a configuration structure.
  *
- * If the pin is an output, this drives the pin high or low via the PxOUT register.
- * If the pin is an input with the resistor enabled, this selects between
- * pull-up (IO_OUT_HIGH) and pull-down (IO_OUT_LOW) via the same PxOUT register.
+ * This function provides a convenient way to set all major properties of a pin
+ * by calling the individual configuration functions.
  *
- * @param gpio The application-specific pin to configure.
- * @param out The desired output state (IO_OUT_HIGH or IO_OUT_LOW).
+ * @param gpio The application-specific pin to configure (from gpio_e).
+ * @param config A pointer to the gpio_config_t structure containing the desired settings.
  */
-void gpio_set_out(gpio_e gpio, gpio_out_e out)
+void gpio_configure(gpio_e gpio, const gpio_config_t *config)
 {
-    uint8_t port = gpio_port(gpio);
-    uint8_t pin = gpio_pin_bit(gpio);
+    gpio_set_select(gpio, config->select);
+    gpio_set_resistor(gpio, config->resistor);
+    gpio_set_direction(gpio, config->dir);
+    gpio_set_out(gpio, config->out);
+}
+
+void gpio_enable_interrupt(gpio_e gpio, gpio_trigger_e trigger, gpio_isr_cb_t callback)
+{
+    uint8_t pin = GPIO_PIN_BIT(gpio);
+    uint8_t port = GPIO_PORT_IDX(gpio);
+
+    // Keep the pin quiet while it is being reconfigured.
+    GPIO_PORT_REG(gpio, IE) &= ~pin;
+    isr_callbacks[gpio] = callback;
 
-    switch (out) {
-    case IO_OUT_LOW:
-        // Clear the corresponding bit in the Port Output register (PxOUT).
-        *port_out_regs[port] &= ~pin;
+    switch (trigger) {
+    case IO_TRIGGER_RISING:
+        // PxIES=0: flag set on a low-to-high transition.
+        GPIO_PORT_REG(gpio, IES) &= ~pin;
+        both_edge_pins[port] &= ~pin;
         break;
-    case IO_OUT_HIGH:
-        // Set the corresponding bit in the Port Output register (PxOUT).
-        *port_out_regs[port] |= pin;
+    case IO_TRIGGER_FALLING:
+        // PxIES=1: flag set on a high-to-low transition.
+        GPIO_PORT_REG(gpio, IES) |= pin;
+        both_edge_pins[port] &= ~pin;
+        break;
+    case IO_TRIGGER_BOTH:
+        // Wait for the edge leaving the current level.
+        if (GPIO_PORT_REG(gpio, IN) & pin) {
+            GPIO_PORT_REG(gpio, IES) |= pin;
+        } else {
+            GPIO_PORT_REG(gpio, IES) &= ~pin;
+        }
+        both_edge_pins[port] |= pin;
         break;
     }
+
+    // Writing PxIES may set PxIFG, so clear it only now.
+    GPIO_PORT_REG(gpio, IFG) &= ~pin;
+    GPIO_PORT_REG(gpio, IE) |= pin;
+}
+
+void gpio_disable_interrupt(gpio_e gpio)
+{
+    uint8_t pin = GPIO_PIN_BIT(gpio);
+
+    GPIO_PORT_REG(gpio, IE) &= ~pin;
+    GPIO_PORT_REG(gpio, IFG) &= ~pin;
+    both_edge_pins[GPIO_PORT_IDX(gpio)] &= ~pin;
+    isr_callbacks[gpio] = NULL;
 }
 
 /**
- * @brief Reads the current logic level of a specific GPIO pin.
- * @param gpio The application-specific pin to read.
- * @return The input state (IO_IN_HIGH or IO_IN_LOW).
+ * @brief Reads both input ports as a single 16-bit value, P1 in the low byte.
  */
-gpio_in_e gpio_get_input(gpio_e gpio)
+static uint16_t read_inputs(void)
 {
-    // Read the Port Input register (PxIN) and check if the pin's bit is set.
-    return (*port_in_regs[gpio_port(gpio)] & gpio_pin_bit(gpio)) ? IO_IN_HIGH : IO_IN_LOW;
+    return P1IN | ((uint16_t)P2IN << IO_PIN_CNT_PER_PORT);
 }
 
+static void debounce_start_sampling(void);
+
 /**
- * @brief Configures a single GPIO pin using a configuration structure.
+ * @brief Edge callback of debounced pins, runs in interrupt context.
+ */
+static void debounce_edge_handler(gpio_e gpio)
+{
+    UNUSED(gpio);
+    debounce_start_sampling();
+}
+
+/**
+ * @brief Re-enables the edge interrupts of debounced pins once they are stable.
  *
- * This function provides a convenient way to set all major properties of a pin
- * by calling the individual configuration functions.
+ * Each pin waits for the edge leaving its debounced level. If a pin already
+ * left it before the interrupt was armed, sampling restarts straight away.
+ */
+static void debounce_arm_edges(void)
+{
+    uint8_t p1 = PORT_BYTE(debounce.mask, 0);
+    uint8_t p2 = PORT_BYTE(debounce.mask, 1);
+
+    // PxIES=1 (falling) for pins settled high, PxIES=0 (rising) for pins settled low.
+    P1IES = (P1IES & ~p1) | (PORT_BYTE(debounce.state, 0) & p1);
+    P2IES = (P2IES & ~p2) | (PORT_BYTE(debounce.state, 1) & p2);
+    P1IFG &= ~p1;
+    P2IFG &= ~p2;
+    P1IE |= p1;
+    P2IE |= p2;
+
+    if ((read_inputs() ^ debounce.state) & debounce.mask) {
+        debounce_start_sampling();
+    }
+}
+
+/**
+ * @brief Takes one debouncer sample of all pins, runs in interrupt context.
+ */
+static void debounce_sample(void)
+{
+    uint16_t delta = (read_inputs() ^ debounce.state) & debounce.mask;
+
+    // Count consecutive samples differing from the debounced state; a counter
+    // is reset as soon as its pin matches again, and wraps after 4 samples.
+    debounce.cnt1 = (debounce.cnt1 ^ debounce.cnt0) & delta;
+    debounce.cnt0 = ~debounce.cnt0 & delta;
+    uint16_t toggle = delta & ~(debounce.cnt0 | debounce.cnt1);
+
+    if (toggle) {
+        debounce.state ^= toggle;
+        debounce.rising |= toggle & debounce.state;
+        debounce.falling |= toggle & ~debounce.state;
+        runloop_post(RUNLOOP_EVENT_INPUT);
+    }
+
+    if (delta & ~toggle) {
+        // Some pin is still bouncing: keep sampling at a fixed rate.
+        debounce.next_sample += TIMEBASE_MS_TO_TICKS(GPIO_DEBOUNCE_SAMPLE_MS);
+        timebase_alarm_set(TIMEBASE_ALARM_DEBOUNCE, debounce.next_sample, debounce_sample);
+    } else {
+        debounce.is_sampling = false;
+        debounce_arm_edges();
+    }
+}
+
+/**
+ * @brief Starts the sample alarm and masks the edge interrupts of debounced pins.
  *
- * @param gpio The application-specific pin to configure (from gpio_e).
- * @param config A pointer to the gpio_config_t structure containing the desired settings.
+ * Bounces are not worth an interrupt each; the sampler takes over until the
+ * pins settle.
  */
-void gpio_configure(gpio_e gpio, const gpio_config_t *config)
+static void debounce_start_sampling(void)
 {
-    gpio_set_select(gpio, config->select);
-    gpio_set_resistor(gpio, config->resistor);
-    gpio_set_direction(gpio, config->dir);
-    gpio_set_out(gpio, config->out);
+    P1IE &= ~PORT_BYTE(debounce.mask, 0);
+    P2IE &= ~PORT_BYTE(debounce.mask, 1);
+
+    if (!debounce.is_sampling) {
+        debounce.is_sampling = true;
+        debounce.next_sample = timebase_ticks() + TIMEBASE_MS_TO_TICKS(GPIO_DEBOUNCE_SAMPLE_MS);
+        timebase_alarm_set(TIMEBASE_ALARM_DEBOUNCE, debounce.next_sample, debounce_sample);
+    }
+}
+
+void gpio_debounce_init(uint16_t mask)
+{
+    critical_state_t state = critical_enter();
+    debounce.mask = mask;
+    debounce.state = read_inputs() & mask;
+    debounce.cnt0 = 0;
+    debounce.cnt1 = 0;
+    debounce.rising = 0;
+    debounce.falling = 0;
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(isr_callbacks); i++) {
+        if (mask & GPIO_MASK(i)) {
+            isr_callbacks[i] = debounce_edge_handler;
+        }
+    }
+    both_edge_pins[0] &= ~PORT_BYTE(mask, 0);
+    both_edge_pins[1] &= ~PORT_BYTE(mask, 1);
+
+    debounce_arm_edges();
+    critical_exit(state);
+}
+
+uint16_t gpio_debounced_state(void)
+{
+    return debounce.state;
+}
+
+gpio_edges_t gpio_debounce_take_edges(void)
+{
+    gpio_edges_t edges;
+
+    // --- Critical Section: read and clear the edges set by the sampler ISR ---
+    critical_state_t state = critical_enter();
+    edges.rising = debounce.rising;
+    edges.falling = debounce.falling;
+    debounce.rising = 0;
+    debounce.falling = 0;
+    critical_exit(state);
+    // --- End Critical Section ---
+
+    return edges;
+}
+
+/**
+ * @brief Services every pending edge of a port in a single ISR entry.
+ *
+ * PxIFG is read once and only the flags taken are cleared, so an edge arriving
+ * while callbacks run is kept for the next ISR entry instead of being lost.
+ *
+ * @param port_idx The port index (0 for Port 1, 1 for Port 2), a constant.
+ */
+FORCE_INLINE void gpio_port_isr(uint8_t port_idx)
+{
+    gpio_e first = PORT_FIRST_PIN(port_idx);
+    uint8_t flags = GPIO_PORT_REG(first, IFG) & GPIO_PORT_REG(first, IE);
+    uint8_t both = flags & both_edge_pins[port_idx];
+
+    if (both) {
+        // Re-arm both-edge pins for the opposite edge of their current level.
+        // The level is re-read so an edge missed during the flip is not lost.
+        uint8_t level = GPIO_PORT_REG(first, IN) & both;
+        GPIO_PORT_REG(first, IES) = (GPIO_PORT_REG(first, IES) & ~both) | level;
+        GPIO_PORT_REG(first, IFG) &= ~flags;
+        uint8_t changed = (GPIO_PORT_REG(first, IN) & both) ^ level;
+        GPIO_PORT_REG(first, IFG) |= changed;
+    } else {
+        GPIO_PORT_REG(first, IFG) &= ~flags;
+    }
+
+    for (uint8_t i = 0; flags != 0; i++, flags >>= 1) {
+        if ((flags & 1u) && isr_callbacks[first + i] != NULL) {
+            isr_callbacks[first + i]((gpio_e)(first + i));
+        }
+    }
+}
+
+// --- Interrupt Service Routines ---
+
+INTERRUPT_VECTOR(PORT1_VECTOR)
+void gpio_port1_isr(void)
+{
+    ISR_PROFILE_ENTER();
+    TRACE(TRACE_EVENT_ISR_BEGIN, PORT1_VECTOR);
+    gpio_port_isr(0);
+    TRACE(TRACE_EVENT_ISR_END, PORT1_VECTOR);
+    ISR_PROFILE_EXIT(ISR_PROFILE_PORT1);
+    RUNLOOP_ISR_EXIT(PORT1_VECTOR);
+}
+
+INTERRUPT_VECTOR(PORT2_VECTOR)
+void gpio_port2_isr(void)
+{
+    ISR_PROFILE_ENTER();
+    TRACE(TRACE_EVENT_ISR_BEGIN, PORT2_VECTOR);
+    gpio_port_isr(1);
+    TRACE(TRACE_EVENT_ISR_END, PORT2_VECTOR);
+    ISR_PROFILE_EXIT(ISR_PROFILE_PORT2);
+    RUNLOOP_ISR_EXIT(PORT2_VECTOR);
 }
@@ -13,6 +13,9 @@
 #include <msp430.h>
 // This header is required for standard integer types like uint8_t
 #include <stdint.h>
+// This header provides the board pin table used to generate gpio_e
+#include "../common/board.h"
+#include "../common/defines.h"
 
 /**
  * @enum gpio_generic_e
@@ -43,32 +46,6 @@ typedef enum {
     IO_27,
 } gpio_generic_e;
 
-/**
- * @enum gpio_e
- * @brief Application-specific aliases for GPIO pins.
- *
- * This enumeration assigns meaningful names to GPIO pins based on their
- * function in the application (e.g., controlling an LED or for UART communication).
- */
-typedef enum {
-    IO_UART_RX = IO_11, ///< UART Receive Pin
-    IO_UART_TX = IO_12, ///< UART Transmit Pin
-    IO_LED_RED = IO_10, ///< Red LED
-    IO_LED_GREEN = IO_16, ///< Green LED
-    IO_UNUSED_1 = IO_13, ///< Unused pin
-    IO_UNUSED_2 = IO_14, ///< Unused pin
-    IO_UNUSED_3 = IO_15, ///< Unused pin
-    IO_UNUSED_4 = IO_17, ///< Unused pin
-    IO_UNUSED_5 = IO_20, ///< Unused pin
-    IO_UNUSED_6 = IO_21, ///< Unused pin
-    IO_UNUSED_7 = IO_22, ///< Unused pin
-    IO_UNUSED_8 = IO_23, ///< Unused pin
-    IO_UNUSED_9 = IO_24, ///< Unused pin
-    IO_UNUSED_10 = IO_25, ///< Unused pin
-    IO_UNUSED_11 = IO_26, ///< Unused pin
-    IO_UNUSED_12 = IO_27, ///< Unused pin
-} gpio_e;
-
 /**
  * @enum gpio_select_e
  * @brief Enumeration for selecting the pin's function.
@@ -128,13 +105,64 @@ typedef enum {
 /**
  * @enum gpio_trigger_e
  * @brief Enumeration for configuring interrupt edge triggers.
- * @note This functionality is declared but not implemented in the driver.
+ *
+ * The port hardware only detects one edge at a time. IO_TRIGGER_BOTH is
+ * emulated by flipping the pin's edge select (PxIES) after every interrupt.
  */
 typedef enum {
     IO_TRIGGER_RISING, ///< Interrupt on a rising edge (low to high).
     IO_TRIGGER_FALLING, ///< Interrupt on a falling edge (high to low).
+    IO_TRIGGER_BOTH, ///< Interrupt on both edges (emulated in software).
 } gpio_trigger_e;
 
+/**
+ * @enum gpio_e
+ * @brief Application-specific aliases for GPIO pins.
+ *
+ * This enumeration assigns meaningful names to GPIO pins based on their
+ * function in the application (e.g., controlling an LED or for UART communication).
+ * It is generated from the BOARD_PINS() table in common/board.h.
+ */
+#define GPIO_ALIAS(alias, port, pin, select, resistor, dir, out) alias = IO_##port##pin,
+typedef enum {
+    BOARD_PINS(GPIO_ALIAS)
+} gpio_e;
+#undef GPIO_ALIAS
+
+// MACROS to decode the port and pin information from a gpio_e enum value.
+// The enum is structured such that:
+// - Bits 3-4 represent the port index (0 for Port 1, 1 for Port 2).
+// - Bits 0-2 represent the pin index (0-7).
+// When the pin is a compile-time constant they fold down to a fixed register
+// address and bitmask, so each access compiles to a single BIS.B/BIC.B/BIT.B.
+
+#define IO_PORT_CNT (2u) ///< Number of GPIO ports handled by this driver (P1, P2).
+#define IO_PIN_CNT_PER_PORT (8u)
+#define IO_PORT_OFFSET (3u) ///< Bit offset for the port number within the enum value.
+#define IO_PORT_MASK (0x3u << IO_PORT_OFFSET) ///< Mask to isolate the port number bits.
+#define IO_PIN_MASK (0x7u) ///< Mask to isolate the pin number bits.
+
+#define GPIO_PORT_IDX(gpio) (((gpio) & IO_PORT_MASK) >> IO_PORT_OFFSET) ///< 0 for P1, 1 for P2.
+#define GPIO_PIN_BIT(gpio) ((uint8_t)(1u << ((gpio) & IO_PIN_MASK))) ///< Bitmask within the port.
+
+/**
+ * @brief Selects a port register (e.g. OUT -> P1OUT or P2OUT) for a pin.
+ */
+#define GPIO_PORT_REG(gpio, reg) (*(GPIO_PORT_IDX(gpio) == 0 ? &P1##reg : &P2##reg))
+
+/**
+ * @brief 16-bit mask of a pin across both ports: P1 in the low byte, P2 in the high byte.
+ */
+#define GPIO_MASK(gpio) ((uint16_t)(1u << (gpio)))
+
+/**
+ * @brief Interval between two debouncer samples while an input is unstable.
+ *
+ * An input must read the same level for 4 consecutive samples (20 ms) before
+ * its debounced state changes.
+ */
+#define GPIO_DEBOUNCE_SAMPLE_MS 5
+
 /**
  * @struct gpio_config_t
  * @brief A structure for holding the complete configuration for a single GPIO pin.
@@ -151,9 +179,28 @@ typedef struct
 } gpio_config_t;
 
 /**
- * @brief Initializes the GPIO module.
- * @note This function is declared but not implemented in the driver.
- * It could be used for global GPIO settings, like unlocking pins.
+ * @brief Callback invoked from the port ISR when an enabled edge is detected.
+ * @param gpio The pin on which the edge occurred.
+ * @note Runs in interrupt context; it should do minimal work, such as posting
+ * a run loop event.
+ */
+typedef void (*gpio_isr_cb_t)(gpio_e gpio);
+
+/**
+ * @struct gpio_edges_t
+ * @brief Debounced edges accumulated since they were last taken, as GPIO_MASK() bits.
+ */
+typedef struct
+{
+    uint16_t rising; ///< Inputs that settled high (e.g. an active-low button released).
+    uint16_t falling; ///< Inputs that settled low (e.g. an active-low button pressed).
+} gpio_edges_t;
+
+/**
+ * @brief Initializes all port pins to the configuration given in common/board.h.
+ *
+ * Each port register is written once with a value precomputed from the board
+ * pin table, instead of configuring the pins one at a time.
  */
 void gpio_init(void);
 
@@ -185,6 +232,48 @@ void gpio_set_direction(gpio_e gpio, gpio_dir_e direction);
  */
 void gpio_set_resistor(gpio_e gpio, gpio_resistor_e resistor);
 
+/**
+ * @brief Enables an edge interrupt on a pin and registers its callback.
+ *
+ * Any stale interrupt flag is cleared first, so only edges occurring after
+ * this call are reported.
+ *
+ * @param gpio The application-specific pin to watch. Must be configured as an input.
+ * @param trigger The edge(s) on which to interrupt.
+ * @param callback Function called from the port ISR for each detected edge.
+ */
+void gpio_enable_interrupt(gpio_e gpio, gpio_trigger_e trigger, gpio_isr_cb_t callback);
+
+/**
+ * @brief Disables the edge interrupt of a pin and unregisters its callback.
+ * @param gpio The application-specific pin to stop watching.
+ */
+void gpio_disable_interrupt(gpio_e gpio);
+
+/**
+ * @brief Starts debouncing a set of input pins.
+ *
+ * All pins are debounced together with 2-bit vertical counters, one bit-slice
+ * per pin, so a sample costs a handful of bitwise operations whatever the
+ * number of pins. Sampling only runs while some pin is unstable: an edge
+ * interrupt starts it and it stops once every pin has settled. The
+ * RUNLOOP_EVENT_INPUT event is posted whenever a debounced state changes.
+ *
+ * @param mask The pins to debounce, built from GPIO_MASK(). They must be inputs
+ * and are taken over from gpio_enable_interrupt().
+ */
+void gpio_debounce_init(uint16_t mask);
+
+/**
+ * @brief Returns the debounced level of every debounced pin, as GPIO_MASK() bits.
+ */
+uint16_t gpio_debounced_state(void);
+
+/**
+ * @brief Returns and clears the debounced edges accumulated since the last call.
+ */
+gpio_edges_t gpio_debounce_take_edges(void);
+
 /**
  * @brief Sets the output logic level of a specific GPIO pin.
  *
@@ -195,13 +284,35 @@ void gpio_set_resistor(gpio_e gpio, gpio_resistor_e resistor);
  * @param gpio The application-specific pin to configure.
  * @param out The desired output state (IO_OUT_HIGH or IO_OUT_LOW).
  */
-void gpio_set_out(gpio_e gpio, gpio_out_e out);
+FORCE_INLINE void gpio_set_out(gpio_e gpio, gpio_out_e out)
+{
+    if (out == IO_OUT_HIGH) {
+        // Set the corresponding bit in the Port Output register (PxOUT).
+        GPIO_PORT_REG(gpio, OUT) |= GPIO_PIN_BIT(gpio);
+    } else {
+        // Clear the corresponding bit in the Port Output register (PxOUT).
+        GPIO_PORT_REG(gpio, OUT) &= ~GPIO_PIN_BIT(gpio);
+    }
+}
+
+/**
+ * @brief Inverts the output logic level of a specific GPIO pin.
+ * @param gpio The application-specific pin to toggle.
+ */
+FORCE_INLINE void gpio_toggle_out(gpio_e gpio)
+{
+    GPIO_PORT_REG(gpio, OUT) ^= GPIO_PIN_BIT(gpio);
+}
 
 /**
  * @brief Reads the current logic level of a specific GPIO pin.
  * @param gpio The application-specific pin to read.
  * @return The input state (IO_IN_HIGH or IO_IN_LOW).
  */
-gpio_in_e gpio_get_input(gpio_e gpio);
+FORCE_INLINE gpio_in_e gpio_get_input(gpio_e gpio)
+{
+    // Read the Port Input register (PxIN) and check if the pin's bit is set.
+    return (GPIO_PORT_REG(gpio, IN) & GPIO_PIN_BIT(gpio)) ? IO_IN_HIGH : IO_IN_LOW;
+}
 
 #endif // GPIO_H
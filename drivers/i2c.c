@@ -0,0 +1,417 @@
+/**
+ * @file i2c.c
+ * @brief Implementation of the interrupt-driven USCI_B0 I2C master.
+ *
+ * The queue holds pointers to the caller's transfers, with free-running 8-bit
+ * indices. The transfer in progress stays at queue_tail until it completes.
+ * The queue is only updated with interrupts disabled: submissions may come
+ * from any ISR.
+ */
+#include "i2c.h"
+
+#if BOARD_I2C_ENABLED
+
+#include <msp430.h>
+#include <stddef.h>
+#include "../common/critical.h"
+#include "clock.h"
+#include "gpio.h"
+#include "isr_profile.h"
+#include "runloop.h"
+#include "timebase.h"
+
+_Static_assert((I2C_QUEUE_LEN & (I2C_QUEUE_LEN - 1)) == 0 && I2C_QUEUE_LEN <= 128,
+    "I2C_QUEUE_LEN must be a power of two up to 128");
+
+// --- Private Module Constants ---
+
+#define QUEUE_MASK (I2C_QUEUE_LEN - 1)
+
+/**
+ * @brief Transfer timeout: a fixed allowance for the START and STOP, plus a
+ * byte time at the slowest bus rate (333 kHz) with a margin for clock stretching.
+ */
+#define TIMEOUT_BASE_TICKS TIMEBASE_MS_TO_TICKS(1)
+#define TIMEOUT_BYTE_TICKS 200 // 100 us
+
+/**
+ * @brief Longest busy wait for the USCI to clear UCTXSTT or UCTXSTP: two byte
+ * times at the slowest bus rate. Only a slave stretching the clock takes longer.
+ */
+#define WAIT_MAX_TICKS (2 * TIMEOUT_BYTE_TICKS)
+
+/**
+ * @brief Half SCL period of the bus recovery, 5 us at 16 MHz (longer in slower profiles).
+ */
+#define RECOVERY_HALF_BIT_CYCLES 80
+#define RECOVERY_PULSES 9 ///< Enough for a slave to finish the byte it is sending.
+
+// --- Private Module Variables ---
+
+static i2c_transfer_t *queue[I2C_QUEUE_LEN];
+static uint8_t queue_head = 0; ///< Advanced by i2c_submit().
+static uint8_t queue_tail = 0; ///< Advanced when the transfer in progress completes.
+static volatile bool is_running = false; ///< A transfer is in progress.
+static volatile bool is_timed_out = false; ///< The timeout alarm fired for the transfer in progress.
+static uint8_t tx_pos = 0;
+static uint8_t rx_pos = 0;
+static i2c_stats_t stats;
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Sets the SCL divider to the fastest SMCLK division within I2C_BUS_HZ.
+ * @note USCI_B0 must be held in reset.
+ */
+static void set_divider(void)
+{
+    uint16_t divider = (uint16_t)((clock_smclk_hz() + I2C_BUS_HZ - 1) / I2C_BUS_HZ);
+    UCB0BR0 = (uint8_t)divider;
+    UCB0BR1 = (uint8_t)(divider >> 8);
+}
+
+/**
+ * @brief Releases a bus held by a slave that was cut in the middle of a read.
+ *
+ * SCL is pulsed until the slave lets SDA go high, then a STOP is sent. The
+ * pins are driven open-drain through their direction bits, against the
+ * external pull-ups.
+ *
+ * @note USCI_B0 must be held in reset.
+ */
+static void recover_bus(void)
+{
+    if (gpio_get_input(IO_I2C_SDA) == IO_IN_HIGH) return;
+
+    stats.recoveries++;
+    gpio_set_select(IO_I2C_SCL, IO_SELECT_GPIO);
+    gpio_set_select(IO_I2C_SDA, IO_SELECT_GPIO);
+    gpio_set_out(IO_I2C_SCL, IO_OUT_LOW);
+    gpio_set_out(IO_I2C_SDA, IO_OUT_LOW);
+
+    for (uint8_t i = 0; i < RECOVERY_PULSES && gpio_get_input(IO_I2C_SDA) == IO_IN_LOW; i++) {
+        gpio_set_direction(IO_I2C_SCL, IO_DIR_OUTPUT);
+        __delay_cycles(RECOVERY_HALF_BIT_CYCLES);
+        gpio_set_direction(IO_I2C_SCL, IO_DIR_INPUT);
+        __delay_cycles(RECOVERY_HALF_BIT_CYCLES);
+    }
+
+    // STOP: SDA rises while SCL is high.
+    gpio_set_direction(IO_I2C_SDA, IO_DIR_OUTPUT);
+    __delay_cycles(RECOVERY_HALF_BIT_CYCLES);
+    gpio_set_direction(IO_I2C_SDA, IO_DIR_INPUT);
+    __delay_cycles(RECOVERY_HALF_BIT_CYCLES);
+
+    gpio_set_select(IO_I2C_SCL, IO_SELECT_ALT3);
+    gpio_set_select(IO_I2C_SDA, IO_SELECT_ALT3);
+}
+
+/**
+ * @brief Resets USCI_B0 and the bus, then configures the master from the current clocks.
+ *
+ * Setting UCSWRST clears the USCI_B0 interrupt enables, so they are restored
+ * for a transfer in progress.
+ *
+ * @note Must be called with interrupts disabled.
+ */
+static void reset_bus(void)
+{
+    // - UCMODE_3 | UCSYNC: I2C. UCMST: master, 7-bit addresses, single master.
+    // - UCSSEL_2: SCL from SMCLK, divided down to at most I2C_BUS_HZ.
+    UCB0CTL1 = UCSSEL_2 | UCSWRST;
+    UCB0CTL0 = UCMST | UCMODE_3 | UCSYNC;
+    set_divider();
+    recover_bus();
+    UCB0CTL1 &= ~UCSWRST;
+    if (is_running) {
+        UCB0I2CIE = UCNACKIE | UCALIE;
+        IE2 |= UCB0TXIE | UCB0RXIE;
+    }
+}
+
+/**
+ * @brief Timeout alarm callback: hands the bus reset to the run loop.
+ */
+static void timeout_alarm(void)
+{
+    is_timed_out = true;
+    runloop_post(RUNLOOP_EVENT_I2C);
+}
+
+/**
+ * @brief Waits for the USCI to clear control bits of UCB0CTL1, for at most WAIT_MAX_TICKS.
+ *
+ * The wait runs with interrupts disabled, so the timeout alarm cannot end it:
+ * the timebase counter bounds it instead.
+ *
+ * @return false if the bits are still set, i.e. a slave holds SCL low.
+ */
+static bool wait_ctl1_clear(uint8_t bits)
+{
+    uint32_t deadline = timebase_ticks() + WAIT_MAX_TICKS;
+    while (UCB0CTL1 & bits) {
+        if (timebase_reached(timebase_ticks(), deadline)) return false;
+    }
+    return true;
+}
+
+static void abort_transfer(i2c_status_e status);
+
+/**
+ * @brief Switches to the read phase with a (repeated) START.
+ * @note Must be called with interrupts disabled. The transfer may have completed on return.
+ */
+static void start_read(const i2c_transfer_t *transfer)
+{
+    UCB0CTL1 &= ~UCTR;
+    UCB0CTL1 |= UCTXSTT;
+    if (transfer->rx_len == 1) {
+        // The only byte is NACKed, so the STOP is set once the address is sent.
+        // No interrupt marks the end of the address in receive mode.
+        if (!wait_ctl1_clear(UCTXSTT)) {
+            abort_transfer(I2C_STATUS_TIMEOUT);
+            return;
+        }
+        UCB0CTL1 |= UCTXSTP;
+    }
+}
+
+/**
+ * @brief Starts the transfer at the queue tail, or stops the driver when the queue is empty.
+ * @note Must be called with interrupts disabled.
+ */
+static void start_next(void)
+{
+    if (queue_head == queue_tail) {
+        if (is_running) {
+            is_running = false;
+            IE2 &= ~(UCB0TXIE | UCB0RXIE);
+            UCB0I2CIE = 0;
+            timebase_alarm_cancel(TIMEBASE_ALARM_I2C);
+            runloop_release_lpm0();
+        }
+        return;
+    }
+
+    const i2c_transfer_t *transfer = queue[queue_tail & QUEUE_MASK];
+    if (!is_running) {
+        is_running = true;
+        UCB0I2CIE = UCNACKIE | UCALIE;
+        IE2 |= UCB0TXIE | UCB0RXIE;
+        runloop_hold_lpm0(); // SMCLK clocks the bus
+    }
+    is_timed_out = false;
+    tx_pos = 0;
+    rx_pos = 0;
+    timebase_alarm_set(TIMEBASE_ALARM_I2C,
+        timebase_ticks() + TIMEOUT_BASE_TICKS
+            + (uint32_t)(transfer->tx_len + transfer->rx_len + 2) * TIMEOUT_BYTE_TICKS,
+        timeout_alarm);
+
+    // The STOP of the previous transfer may still be on the bus. It also
+    // reports a NACK of the last byte written, which is too late to count.
+    // If a slave holds SCL low past the bound, the bus is reset before the START.
+    if (!wait_ctl1_clear(UCTXSTP)) {
+        reset_bus();
+    }
+    UCB0STAT &= ~UCNACKIFG;
+    UCB0I2CSA = transfer->address;
+    if (transfer->tx_len > 0 || transfer->rx_len == 0) {
+        UCB0CTL1 |= UCTR | UCTXSTT;
+    } else {
+        start_read(transfer);
+    }
+}
+
+/**
+ * @brief Completes the transfer in progress and starts the next one.
+ * @note Must be called with interrupts disabled.
+ */
+static void finish(i2c_status_e status)
+{
+    i2c_transfer_t *transfer = queue[queue_tail & QUEUE_MASK];
+    queue_tail++;
+
+    stats.transfers++;
+    if (status == I2C_STATUS_NACK) {
+        stats.nacks++;
+    } else if (status != I2C_STATUS_OK) {
+        stats.errors++;
+    }
+
+    transfer->status = status;
+    if (transfer->done != NULL) {
+        transfer->done(transfer);
+    }
+    start_next();
+}
+
+/**
+ * @brief Ends the transfer in progress with an error after resetting the bus.
+ * @note Must be called with interrupts disabled.
+ */
+static void abort_transfer(i2c_status_e status)
+{
+    reset_bus();
+    IFG2 &= ~(UCB0TXIFG | UCB0RXIFG);
+    finish(status);
+}
+
+/**
+ * @brief Run loop handler of RUNLOOP_EVENT_I2C: aborts a transfer that timed out.
+ */
+static void i2c_handle_timeout(void)
+{
+    critical_state_t state = critical_enter();
+    // The transfer may have completed after the alarm fired.
+    if (is_running && is_timed_out) {
+        abort_transfer(I2C_STATUS_TIMEOUT);
+    }
+    critical_exit(state);
+}
+
+/**
+ * @brief Clock change callback: sets the divider for the new SMCLK frequency.
+ *
+ * The divider can only change with USCI_B0 in reset, which cuts a transfer in
+ * progress.
+ */
+static void i2c_clock_changed(void)
+{
+    if (is_running) {
+        abort_transfer(I2C_STATUS_ABORTED);
+        return;
+    }
+    UCB0CTL1 |= UCSWRST;
+    set_divider();
+    UCB0CTL1 &= ~UCSWRST;
+}
+
+/**
+ * @brief Body of i2c_data_isr(): moves the next byte, or ends the transfer.
+ */
+static void service_data(void)
+{
+    if (!is_running) return;
+    const i2c_transfer_t *transfer = queue[queue_tail & QUEUE_MASK];
+
+    if (IFG2 & UCB0RXIFG) {
+        // Set the STOP before reading the second to last byte, so that the last one is NACKed.
+        uint8_t remaining = transfer->rx_len - rx_pos;
+        if (remaining == 2) {
+            UCB0CTL1 |= UCTXSTP;
+        }
+        transfer->rx[rx_pos++] = UCB0RXBUF;
+        if (remaining == 1) {
+            finish(I2C_STATUS_OK);
+        }
+        return;
+    }
+
+    if (IFG2 & UCB0TXIFG) {
+        if (tx_pos < transfer->tx_len) {
+            UCB0TXBUF = transfer->tx[tx_pos++];
+            return;
+        }
+        IFG2 &= ~UCB0TXIFG;
+        if (transfer->rx_len > 0) {
+            start_read(transfer); // Repeated START once the last byte is acknowledged
+        } else if (transfer->tx_len == 0) {
+            // Address only: TXIFG comes with the START, the acknowledge only
+            // once the USCI clears UCTXSTT.
+            if (!wait_ctl1_clear(UCTXSTT)) {
+                abort_transfer(I2C_STATUS_TIMEOUT);
+            } else if (!(UCB0STAT & UCNACKIFG)) {
+                UCB0CTL1 |= UCTXSTP;
+                finish(I2C_STATUS_OK);
+            }
+            // Otherwise service_state() ends it with the NACK, next.
+        } else {
+            UCB0CTL1 |= UCTXSTP;
+            finish(I2C_STATUS_OK);
+        }
+    }
+}
+
+/**
+ * @brief Body of i2c_state_isr(): ends the transfer on a NACK or a lost arbitration.
+ */
+static void service_state(void)
+{
+    uint8_t flags = UCB0STAT & (UCNACKIFG | UCALIFG);
+    if (flags == 0) return;
+
+    UCB0STAT &= ~flags;
+    if (!is_running) return;
+
+    if (flags & UCALIFG) {
+        // Losing arbitration switches the USCI to slave mode, which only a reset undoes.
+        abort_transfer(I2C_STATUS_ARB_LOST);
+    } else {
+        IFG2 &= ~UCB0TXIFG;
+        UCB0CTL1 |= UCTXSTP;
+        finish(I2C_STATUS_NACK);
+    }
+}
+
+// --- Public Function Definitions ---
+
+void i2c_init(void)
+{
+    critical_state_t state = critical_enter();
+    reset_bus();
+    critical_exit(state);
+
+    runloop_register(RUNLOOP_EVENT_I2C, i2c_handle_timeout);
+    clock_register(CLOCK_CLIENT_I2C, i2c_clock_changed);
+}
+
+bool i2c_submit(i2c_transfer_t *transfer)
+{
+    if (transfer == NULL || (transfer->tx_len > 0 && transfer->tx == NULL)
+        || (transfer->rx_len > 0 && transfer->rx == NULL)) {
+        return false;
+    }
+
+    critical_state_t state = critical_enter();
+    bool is_queued = (uint8_t)(queue_head - queue_tail) < I2C_QUEUE_LEN;
+    if (is_queued) {
+        transfer->status = I2C_STATUS_PENDING;
+        queue[queue_head & QUEUE_MASK] = transfer;
+        queue_head++;
+        // From a completion callback, finish() starts it once the callback returns.
+        if (!is_running) {
+            start_next();
+        }
+    }
+    critical_exit(state);
+    return is_queued;
+}
+
+bool i2c_is_busy(void)
+{
+    return is_running;
+}
+
+void i2c_get_stats(i2c_stats_t *out)
+{
+    critical_state_t state = critical_enter();
+    *out = stats;
+    critical_exit(state);
+}
+
+void i2c_data_isr(void)
+{
+    ISR_PROFILE_ENTER();
+    service_data();
+    ISR_PROFILE_EXIT(ISR_PROFILE_I2C_DATA);
+}
+
+void i2c_state_isr(void)
+{
+    ISR_PROFILE_ENTER();
+    service_state();
+    ISR_PROFILE_EXIT(ISR_PROFILE_I2C_STATE);
+}
+
+#endif // BOARD_I2C_ENABLED
@@ -0,0 +1,139 @@
+/**
+ * @file i2c.h
+ * @brief Interrupt-driven I2C master on USCI_B0, P1.6 (SCL) and P1.7 (SDA).
+ *
+ * Transfers are queued and run back to back by the USCI interrupts: each one
+ * writes its bytes, then reads with a repeated START, then sends a STOP. The
+ * CPU sleeps between bytes, and the transfer's callback runs as soon as it
+ * completes, so a sensor can be read from a timer ISR without involving the
+ * run loop. The bus runs at up to I2C_BUS_HZ from SMCLK and follows the clock
+ * profile (333 kHz in the 1 MHz profile).
+ *
+ * Errors end the transfer with a status: an address or data NACK, a lost
+ * arbitration, or a timeout. A timed out transfer, or one cut by a clock
+ * change, resets USCI_B0, and a slave left holding SDA low is released by
+ * clocking SCL by hand (up to 9 pulses) and sending a STOP.
+ *
+ * Three short busy waits remain, with interrupts disabled, as none of their
+ * events raises an interrupt: before each START, for the STOP of the previous
+ * transfer (at most one byte after a write-only transfer); for the address of
+ * single-byte reads, which must set the STOP before their only byte is
+ * received; and for the address of address-only transfers, whose acknowledge
+ * is only known then. All are bounded to two byte times with the timebase
+ * counter, since the timeout alarm cannot fire meanwhile: a slave holding SCL
+ * low past that resets the bus before the START, or ends the transfer with
+ * I2C_STATUS_TIMEOUT.
+ *
+ * The driver is only built when the board fits the bus, see BOARD_I2C_ENABLED.
+ */
+#ifndef I2C_H
+#define I2C_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "../common/board.h"
+#include "../common/defines.h"
+
+// --- Public Constants ---
+
+#define I2C_BUS_HZ 400000UL ///< Fast-mode SCL frequency, an upper bound.
+#define I2C_QUEUE_LEN 4 ///< Queued transfers, including the one in progress. Power of two.
+
+// --- Public Type Definitions ---
+
+/**
+ * @brief Outcome of a transfer.
+ */
+typedef enum {
+    I2C_STATUS_PENDING, ///< Queued or in progress.
+    I2C_STATUS_OK,
+    I2C_STATUS_NACK, ///< The slave did not acknowledge its address or a byte written.
+    I2C_STATUS_ARB_LOST, ///< Another master took the bus.
+    I2C_STATUS_TIMEOUT, ///< The transfer did not end in time; the bus was reset.
+    I2C_STATUS_ABORTED, ///< Cut short by a clock change; the bus was reset.
+} i2c_status_e;
+
+typedef struct i2c_transfer_s i2c_transfer_t;
+
+/**
+ * @brief Completion callback, executed in interrupt context (or with interrupts
+ * disabled, after a bus reset). It may queue the next transfer.
+ */
+typedef void (*i2c_done_cb_t)(i2c_transfer_t *transfer);
+
+/**
+ * @brief A write-then-read transfer, owned by the caller until it completes.
+ *
+ * Either phase may be empty. A transfer with neither only addresses the
+ * slave: it probes for it, ending with I2C_STATUS_NACK if it is absent.
+ */
+struct i2c_transfer_s
+{
+    const uint8_t *tx; ///< Bytes to write, usually a register address.
+    uint8_t *rx; ///< Buffer for the bytes read.
+    uint8_t tx_len;
+    uint8_t rx_len;
+    uint8_t address; ///< 7-bit slave address.
+    volatile i2c_status_e status; ///< Set by the driver.
+    i2c_done_cb_t done; ///< Called on completion, or NULL.
+};
+
+/**
+ * @brief Counters since i2c_init() (they wrap).
+ */
+typedef struct
+{
+    uint16_t transfers; ///< Transfers completed, whatever their status.
+    uint16_t nacks;
+    uint16_t errors; ///< Arbitration losses, timeouts and aborts.
+    uint16_t recoveries; ///< Bus resets that found SDA held low.
+} i2c_stats_t;
+
+#if BOARD_I2C_ENABLED
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Configures USCI_B0 as an I2C master, releasing the bus first if a slave holds it.
+ * @note Must be called after gpio_init() and timebase_init().
+ */
+void i2c_init(void);
+
+/**
+ * @brief Queues a transfer, starting it at once if the bus is idle.
+ * @note Safe to call from an ISR, including from a completion callback.
+ * @param transfer The transfer, which must stay valid until its callback.
+ * @return false if the queue is full or a buffer is missing.
+ */
+bool i2c_submit(i2c_transfer_t *transfer);
+
+/**
+ * @brief Returns true while transfers are queued or in progress.
+ */
+bool i2c_is_busy(void);
+
+/**
+ * @brief Copies the counters.
+ * @param out Destination of the counters. Must not be NULL.
+ */
+void i2c_get_stats(i2c_stats_t *out);
+
+/**
+ * @brief Handles the USCI_B0 data interrupts, from the USCIAB0TX vector shared with the UART.
+ */
+void i2c_data_isr(void);
+
+/**
+ * @brief Handles the USCI_B0 state interrupts, from the USCIAB0RX vector shared with the UART.
+ */
+void i2c_state_isr(void);
+
+#else
+
+// Without a bus, the UART ISRs have no USCI_B0 interrupt to forward.
+FORCE_INLINE void i2c_data_isr(void) { }
+FORCE_INLINE void i2c_state_isr(void) { }
+
+#endif // BOARD_I2C_ENABLED
+
+#endif // I2C_H
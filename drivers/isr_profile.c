@@ -0,0 +1,108 @@
+/**
+ * @file isr_profile.c
+ * @brief Implementation of the ISR profiler measurements and report.
+ */
+#include "isr_profile.h"
+
+#if ISR_PROFILE_ENABLE
+
+#include "../common/critical.h"
+#include "../common/format.h"
+#include "uart.h"
+
+// --- Private Module Constants ---
+
+#define ISR_PROFILE_LABEL(isr, label) label,
+static const char *const isr_labels[ISR_PROFILE_CNT] = { ISR_PROFILE_ISRS(ISR_PROFILE_LABEL) };
+#undef ISR_PROFILE_LABEL
+
+#define STATS_INIT { 0, UINT16_MAX, 0, 0, 0, 0, 0 }
+
+#define LINE_MAX 80 ///< 74 with a 9-character label and every field at 65535.
+
+// --- Private Module Variables ---
+
+volatile isr_profile_stats_t isr_profile_stats[ISR_PROFILE_CNT] = {
+    [0 ... ISR_PROFILE_CNT - 1] = STATS_INIT,
+};
+
+// --- Private Function Definitions ---
+
+// --- Public Function Definitions ---
+
+void isr_profile_record(isr_profile_e isr, uint16_t entry_count, uint16_t latency_counts)
+{
+    uint16_t counts = TA0R - entry_count;
+    volatile isr_profile_stats_t *stats = &isr_profile_stats[isr];
+
+    if (counts < stats->min_counts) {
+        stats->min_counts = counts;
+    }
+    if (counts > stats->max_counts) {
+        stats->max_counts = counts;
+    }
+    // The sums stop with their counters, so the averages stay those of the first runs.
+    if (stats->run_cnt != UINT16_MAX) {
+        stats->run_cnt++;
+        stats->total_counts += counts;
+    }
+
+    if (latency_counts != UINT16_MAX) {
+        if (latency_counts > stats->max_latency_counts) {
+            stats->max_latency_counts = latency_counts;
+        }
+        if (stats->latency_cnt != UINT16_MAX) {
+            stats->latency_cnt++;
+            stats->total_latency_counts += latency_counts;
+        }
+    }
+}
+
+void isr_profile_reset(void)
+{
+    critical_state_t state = critical_enter();
+    for (uint8_t i = 0; i < ISR_PROFILE_CNT; i++) {
+        isr_profile_stats[i] = (isr_profile_stats_t)STATS_INIT;
+    }
+    critical_exit(state);
+}
+
+void isr_profile_get_stats(isr_profile_e isr, isr_profile_stats_t *out)
+{
+    critical_state_t state = critical_enter();
+    *out = isr_profile_stats[isr];
+    critical_exit(state);
+}
+
+void isr_profile_report(void)
+{
+    for (uint8_t i = 0; i < ISR_PROFILE_CNT; i++) {
+        isr_profile_stats_t stats;
+        isr_profile_get_stats((isr_profile_e)i, &stats);
+        if (stats.run_cnt == 0) continue;
+
+        // e.g. "isr WDT: 40 runs, 96/101/130 counts, latency 4/9\r\n"
+        char line[LINE_MAX];
+        char *end = format_str(line, "isr ");
+        end = format_str(end, isr_labels[i]);
+        end = format_str(end, ": ");
+        end = format_u32(end, stats.run_cnt);
+        end = format_str(end, " runs, ");
+        end = format_u32(end, stats.min_counts);
+        *end++ = '/';
+        end = format_u32(end, stats.total_counts / stats.run_cnt);
+        *end++ = '/';
+        end = format_u32(end, stats.max_counts);
+        end = format_str(end, " counts");
+        if (stats.latency_cnt != 0) {
+            end = format_str(end, ", latency ");
+            end = format_u32(end, stats.total_latency_counts / stats.latency_cnt);
+            *end++ = '/';
+            end = format_u32(end, stats.max_latency_counts);
+        }
+        end = format_str(end, "\r\n");
+        uart_write_all(line, (uint16_t)(end - line));
+    }
+}
+
+#endif // ISR_PROFILE_ENABLE
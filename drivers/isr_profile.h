@@ -0,0 +1,150 @@
+/**
+ * @file isr_profile.h
+ * @brief Optional ISR duration and entry latency profiler.
+ *
+ * Each ISR opens with ISR_PROFILE_ENTER() and closes with ISR_PROFILE_EXIT(),
+ * which time its body with the free-running Timer0_A counter. ISRs whose
+ * event left a counter value behind (a compare register, or the CCR2 capture
+ * of the ACLK edge that also clocks the watchdog) report it with
+ * ISR_PROFILE_LATENCY(), giving how late the body started after the event.
+ *
+ * The USCIAB0TX and USCIAB0RX vectors are shared by the UART and the I2C
+ * driver, and each half is timed on its own: the USCIA0 entries cover the
+ * vector up to the UART bytes, the USCIB0 entries the I2C handlers called
+ * after them. A run of the vector counts once in each.
+ *
+ * Profiling is enabled with make ISR_PROFILE=1 (after a make clean).
+ * Otherwise the macros and functions below compile to nothing. The results
+ * are kept in isr_profile_stats, readable from a debugger, and
+ * isr_profile_report() prints them over the UART.
+ *
+ * Times are in Timer0_A counts: 0.5 us, or 1 us in the 1 MHz clock profile
+ * (see timebase.h). The hardware interrupt entry and the return (11 cycles)
+ * are not included.
+ */
+#ifndef ISR_PROFILE_H
+#define ISR_PROFILE_H
+
+#include <msp430.h>
+#include <stdint.h>
+#include "../common/defines.h"
+
+#ifndef ISR_PROFILE_ENABLE
+#define ISR_PROFILE_ENABLE 0
+#endif
+
+// --- Public Type Definitions ---
+
+// clang-format off
+/**
+ * @brief The profiled ISRs. Columns: X(isr, label)
+ */
+#define ISR_PROFILE_ISRS(X)                                                                        \
+    X(ISR_PROFILE_PORT1,     "PORT1")                                                              \
+    X(ISR_PROFILE_PORT2,     "PORT2")                                                              \
+    X(ISR_PROFILE_ADC10,     "ADC10")                                                              \
+    X(ISR_PROFILE_UART_TX,   "USCIA0TX")                                                           \
+    X(ISR_PROFILE_UART_RX,   "USCIA0RX")                                                           \
+    X(ISR_PROFILE_I2C_DATA,  "USCIB0TX")                                                           \
+    X(ISR_PROFILE_I2C_STATE, "USCIB0RX")                                                           \
+    X(ISR_PROFILE_TIMER0_A1, "TIMER0_A1")                                                          \
+    X(ISR_PROFILE_TIMER0_A0, "TIMER0_A0")                                                          \
+    X(ISR_PROFILE_WDT,       "WDT")                                                                \
+    X(ISR_PROFILE_TIMER1_A1, "TIMER1_A1")                                                          \
+    X(ISR_PROFILE_TIMER1_A0, "TIMER1_A0")
+// clang-format on
+
+#define ISR_PROFILE_ENUM(isr, label) isr,
+typedef enum {
+    ISR_PROFILE_ISRS(ISR_PROFILE_ENUM)
+    ISR_PROFILE_CNT,
+} isr_profile_e;
+#undef ISR_PROFILE_ENUM
+
+/**
+ * @brief Measurements of one ISR since the last isr_profile_reset().
+ */
+typedef struct
+{
+    uint16_t run_cnt; ///< Number of runs. Saturates, and the sums stop with it.
+    uint16_t min_counts; ///< Shortest run, or UINT16_MAX before the first one.
+    uint16_t max_counts; ///< Longest run.
+    uint32_t total_counts; ///< Sum of the durations of the counted runs, for the average.
+    uint16_t latency_cnt; ///< Runs that reported a latency (saturates).
+    uint16_t max_latency_counts; ///< Latest start after the event.
+    uint32_t total_latency_counts; ///< Sum of the counted latencies, for the average.
+} isr_profile_stats_t;
+
+#if ISR_PROFILE_ENABLE
+
+// --- Public Variables ---
+
+/**
+ * @brief Measurements per ISR, indexed by isr_profile_e. Written by the ISRs only.
+ */
+extern volatile isr_profile_stats_t isr_profile_stats[ISR_PROFILE_CNT];
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Adds one run to the measurements of an ISR. Called by ISR_PROFILE_EXIT().
+ */
+void isr_profile_record(isr_profile_e isr, uint16_t entry_count, uint16_t latency_counts);
+
+/**
+ * @brief Opens the measurement of an ISR. Must be the first statement of the ISR.
+ */
+#define ISR_PROFILE_ENTER()                                                                        \
+    const uint16_t isr_profile_entry = TA0R;                                                       \
+    uint16_t isr_profile_latency = UINT16_MAX
+
+/**
+ * @brief Reports the Timer0_A count at which the event serviced by the ISR occurred.
+ */
+#define ISR_PROFILE_LATENCY(event_count)                                                           \
+    (isr_profile_latency = (uint16_t)(isr_profile_entry - (uint16_t)(event_count)))
+
+/**
+ * @brief Closes the measurement of an ISR, before RUNLOOP_ISR_EXIT().
+ */
+#define ISR_PROFILE_EXIT(isr) isr_profile_record((isr), isr_profile_entry, isr_profile_latency)
+
+/**
+ * @brief Clears the measurements, e.g. after a clock profile change.
+ */
+void isr_profile_reset(void);
+
+/**
+ * @brief Copies the measurements of an ISR.
+ * @note All zero unless built with ISR_PROFILE=1.
+ * @param isr The ISR.
+ * @param out Destination of the measurements. Must not be NULL.
+ */
+void isr_profile_get_stats(isr_profile_e isr, isr_profile_stats_t *out);
+
+/**
+ * @brief Prints one line per ISR that ran over the UART: runs, min/avg/max duration and
+ * avg/max latency, in Timer0_A counts.
+ * @note Sleeps while the UART transmit buffer is full. Must not be called from an ISR.
+ */
+void isr_profile_report(void);
+
+#else
+
+#define ISR_PROFILE_ENTER() ((void)0)
+#define ISR_PROFILE_LATENCY(event_count) ((void)0)
+#define ISR_PROFILE_EXIT(isr) ((void)0)
+
+FORCE_INLINE void isr_profile_reset(void) { }
+
+FORCE_INLINE void isr_profile_get_stats(isr_profile_e isr, isr_profile_stats_t *out)
+{
+    UNUSED(isr);
+    *out = (isr_profile_stats_t) { 0, 0, 0, 0, 0, 0, 0 };
+}
+
+FORCE_INLINE void isr_profile_report(void) { }
+
+#endif // ISR_PROFILE_ENABLE
+
+#endif // ISR_PROFILE_H
@@ -2,16 +2,43 @@
 #include <msp430.h>
 #include <stddef.h>
 #include "../common/defines.h" // Assuming ARRAY_SIZE and GPIO definitions are here
+#include "boot.h"
+#include "clock.h"
+#include "led_panel.h"
+#include "runloop.h"
+#include "timebase.h"
+#include "trace.h"
+#include <stdint.h>
 
 // --- Private Module Constants ---
-#define SMCLK_FREQ_HZ       16000000UL
-#define TIMER_CLK_DIVIDER   8
-#define TIMER_FREQ_HZ       (SMCLK_FREQ_HZ / TIMER_CLK_DIVIDER) // 2 MHz
-#define TIMER_PERIOD_MS     1
-#define TIMER_COUNTS_PER_MS (TIMER_FREQ_HZ / 1000) // 2000 counts
+
+/**
+ * @brief Timer1_A compare channel whose output (TA1.1 or TA1.2) is on a pin, or 0 if none.
+ * TA1.0 is not usable: CCR0 sets the shared timer period.
+ */
+#define LED_TIMER_CHANNEL(io)                                                                      \
+    (((int)(io) == IO_21 || (int)(io) == IO_22)       ? 1u                                         \
+            : ((int)(io) == IO_24 || (int)(io) == IO_25) ? 2u                                      \
+                                                         : 0u)
+
+#define BLINK_TIMER_ID      ID_3 // ACLK / 8: 4096 Hz from LFXT1, periods up to 16 s
+#define PWM_COUNT_HZ        2000000UL // SMCLK divided down to 2 MHz, 1 MHz at the 1 MHz profile
+#define PWM_STEP_COUNTS     8 // Counts per brightness step
+#define PWM_PERIOD_COUNTS   (255u * PWM_STEP_COUNTS) // 2040 counts at 2 MHz, ~980 Hz
+#define FADE_UPDATE_MS      20 // Brightness update interval during a fade step
+#define LEVEL_TO_BRIGHTNESS(level) ((uint8_t)((level) * (LED_BRIGHTNESS_MAX / LED_LEVEL_MAX)))
 
 // --- Private Structure Definition ---
 
+/**
+ * @brief What the Timer1_A output of an LED, or the timer itself, is currently doing.
+ */
+typedef enum {
+    LED_HW_NONE,  ///< Static level (OUTMOD_0), or the timer is stopped.
+    LED_HW_BLINK, ///< Blinking from ACLK, period up to 16 s.
+    LED_HW_PWM,   ///< Dimming from SMCLK at ~980 Hz.
+} led_hw_e;
+
 /**
  * @brief The internal, private definition of the LED control structure.
  * @note This structure is hidden from any file that only includes led.h.
@@ -20,68 +47,423 @@
 struct led_s
 {
     const gpio_e io;        ///< GPIO pin associated with the LED (read-only).
+    const uint8_t timer_channel; ///< Timer1_A channel driving the pin, or 0 for software only.
+    led_hw_e hw_mode;       ///< What the timer output is doing, LED_HW_NONE if not in use.
     led_state_e state;      ///< Current physical state of the LED (ON or OFF).
     uint16_t on_period_ms;  ///< Duration (ms) the LED stays ON during blinking.
     uint16_t off_period_ms; ///< Duration (ms) the LED stays OFF during blinking.
     bool is_blinking;       ///< Flag indicating if the LED is currently blinking.
-    uint32_t last_toggle_time; ///< System time (ms) when the LED state was last changed.
+    uint32_t next_toggle_tick; ///< Timebase tick at which the LED state must next change.
+    const led_pattern_t *pattern; ///< Pattern being played, or NULL.
+    uint8_t step_idx;       ///< Index of the current pattern step.
+    uint8_t repeats_left;   ///< Remaining plays of a finite pattern (unused if repeating forever).
+    uint8_t brightness;     ///< Current brightness, used as the start point of fades.
+    uint8_t fade_from;      ///< Brightness at the start of the current fade step.
+    uint16_t fade_elapsed_ms; ///< Time elapsed in the current fade step.
 };
 
 // --- Private Module Variables ---
 
 /**
- * @brief Millisecond system tick counter, incremented by the Timer A0 ISR.
- * @warning This variable is modified by an ISR. Access from the main context
- * must be atomic (i.e., performed with interrupts disabled).
+ * @brief Timer1_A configuration shared by all LEDs driven from its outputs.
+ *
+ * Both channels share the period set by CCR0, so an LED can only use the
+ * timer if the other one is idle or runs in the same mode with the same period.
  */
-static volatile uint32_t system_tick_ms = 0;
+static struct
+{
+    led_hw_e mode;   ///< Current timer clocking, LED_HW_NONE when stopped.
+    uint16_t period; ///< Current period in timer counts.
+    uint32_t clock_hz; ///< Source clock frequency the timer was started with.
+} timer1 = { LED_HW_NONE, 0, 0 };
 
 /**
  * @brief Array of LED control structures. Declared 'static' to encapsulate it
  * within this module, preventing direct external access.
  */
 static volatile struct led_s leds[] = {
+#if BOARD_HAS_LED_GREEN
     {
         .io = IO_LED_GREEN,
+        .timer_channel = LED_TIMER_CHANNEL(IO_LED_GREEN),
+        .hw_mode = LED_HW_NONE,
         .state = LED_OFF,
         .on_period_ms = LED_ON_PERIOD_MS_DEFAULT,
         .off_period_ms = LED_OFF_PERIOD_MS_DEFAULT,
         .is_blinking = false,
-        .last_toggle_time = 0,
+        .next_toggle_tick = 0,
+        .pattern = NULL,
     },
+#endif
     {
         .io = IO_LED_RED,
+        .timer_channel = LED_TIMER_CHANNEL(IO_LED_RED),
+        .hw_mode = LED_HW_NONE,
         .state = LED_OFF,
         .on_period_ms = LED_ON_PERIOD_MS_DEFAULT,
         .off_period_ms = LED_OFF_PERIOD_MS_DEFAULT,
         .is_blinking = false,
-        .last_toggle_time = 0,
+        .next_toggle_tick = 0,
+        .pattern = NULL,
     }
 };
 
+#if LED_PANEL_CHANNELS > 0
+/**
+ * @brief Handle targets for the panel channels.
+ *
+ * A panel handle points into this flash array instead of a struct led_s, so
+ * the channels cost no RAM. The handle is only compared, never dereferenced.
+ */
+static const uint8_t panel_handle_ids[LED_PANEL_CHANNELS];
+#endif
+
+// --- Built-in Patterns ---
+
+static const led_step_t heartbeat_steps[] = {
+    LED_STEP(LED_LEVEL_MAX, 100),
+    LED_STEP(0, 100),
+    LED_STEP(LED_LEVEL_MAX, 100),
+    LED_STEP(0, 700),
+};
+const led_pattern_t led_pattern_heartbeat = LED_PATTERN(heartbeat_steps, 0);
+
+static const led_step_t breathe_steps[] = {
+    LED_STEP_FADE(LED_LEVEL_MAX, 1500),
+    LED_STEP_FADE(0, 1500),
+    LED_STEP(0, 500),
+};
+const led_pattern_t led_pattern_breathe = LED_PATTERN(breathe_steps, 0);
+
+static const led_step_t sos_steps[] = {
+    LED_MORSE_DOT, LED_MORSE_DOT, LED_MORSE_DOT, LED_MORSE_LETTER_GAP,
+    LED_MORSE_DASH, LED_MORSE_DASH, LED_MORSE_DASH, LED_MORSE_LETTER_GAP,
+    LED_MORSE_DOT, LED_MORSE_DOT, LED_MORSE_DOT, LED_MORSE_WORD_GAP,
+};
+const led_pattern_t led_pattern_sos = LED_PATTERN(sos_steps, 0);
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Returns the Timer1_A count rate of hardware blinking, in Hz.
+ */
+static uint32_t blink_timer_hz(void)
+{
+    return clock_aclk_hz() >> 3;
+}
+
+/**
+ * @brief Returns the frequency of the clock feeding Timer1_A in a mode, in Hz.
+ */
+static uint32_t timer1_source_hz(led_hw_e mode)
+{
+    return (mode == LED_HW_BLINK) ? clock_aclk_hz() : clock_smclk_hz();
+}
+
+/**
+ * @brief Returns the TA1CTL value that starts Timer1_A in a mode, from the current clocks.
+ */
+static uint16_t timer1_ctl(led_hw_e mode)
+{
+    /*
+     * Up mode (MC_1), counting 0 -> CCR0:
+     * - Blinking: ACLK / 8 (TASSEL_1), independent of the SMCLK divider.
+     * - Dimming: SMCLK divided down to PWM_COUNT_HZ (TASSEL_2), needs LPM0.
+     */
+    if (mode == LED_HW_BLINK) {
+        return TASSEL_1 | BLINK_TIMER_ID | MC_1 | TACLR;
+    }
+    return TASSEL_2 | CLOCK_TIMER_ID(clock_smclk_div_log2(PWM_COUNT_HZ)) | MC_1 | TACLR;
+}
+
+/**
+ * @brief Checks whether a handle addresses a panel channel.
+ * @param handle The handle to check.
+ * @param channel Receives the panel channel when the function returns true.
+ */
+static bool is_panel_handle(led_handle_t handle, uint8_t *channel)
+{
+#if LED_PANEL_CHANNELS > 0
+    uintptr_t first = (uintptr_t)&panel_handle_ids[0];
+    uintptr_t addr = (uintptr_t)handle;
+
+    if (addr >= first && addr < first + LED_PANEL_CHANNELS) {
+        *channel = (uint8_t)(addr - first);
+        return true;
+    }
+#else
+    UNUSED(handle);
+    UNUSED(channel);
+#endif
+    return false;
+}
+
+/**
+ * @brief Returns the TA1CCTLx register of an LED's timer channel.
+ */
+static volatile uint16_t *timer_cctl(const struct led_s *led)
+{
+    return (led->timer_channel == 1) ? &TA1CCTL1 : &TA1CCTL2;
+}
+
+/**
+ * @brief Returns the TA1CCRx register of an LED's timer channel.
+ */
+static volatile uint16_t *timer_ccr(const struct led_s *led)
+{
+    return (led->timer_channel == 1) ? &TA1CCR1 : &TA1CCR2;
+}
+
+/**
+ * @brief Reserves Timer1_A for an LED in the given mode and period.
+ *
+ * Starts the timer if it is idle. Fails if another LED uses it with a
+ * different mode or period, in which case the caller falls back to software.
+ *
+ * @return true if the LED may drive its channel in this mode.
+ */
+static bool timer1_claim(const struct led_s *led, led_hw_e mode, uint16_t period)
+{
+    for (uint8_t i = 0; i < ARRAY_SIZE(leds); i++) {
+        const struct led_s *other = (const struct led_s *)&leds[i];
+        if (other != led && other->hw_mode != LED_HW_NONE
+            && (timer1.mode != mode || timer1.period != period)) {
+            return false;
+        }
+    }
+
+    if (timer1.mode == mode && timer1.period == period) {
+        return true; // Already running as required, keep the phase of other channels.
+    }
+    if (timer1.mode == LED_HW_PWM) {
+        runloop_release_lpm0();
+    }
+
+    TA1CTL = timer1_ctl(mode);
+    TA1CCR0 = period - 1;
+    if (mode == LED_HW_PWM) {
+        runloop_hold_lpm0();
+    }
+
+    timer1.mode = mode;
+    timer1.period = period;
+    timer1.clock_hz = timer1_source_hz(mode);
+    return true;
+}
+
+/**
+ * @brief Stops Timer1_A once no LED uses its outputs any more.
+ */
+static void timer1_release_if_idle(void)
+{
+    for (uint8_t i = 0; i < ARRAY_SIZE(leds); i++) {
+        if (leds[i].hw_mode != LED_HW_NONE) return;
+    }
+
+    if (timer1.mode == LED_HW_PWM) {
+        runloop_release_lpm0();
+    }
+    TA1CTL = MC_0;
+    timer1.mode = LED_HW_NONE;
+}
+
+/**
+ * @brief Clock change callback: keeps the Timer1_A outputs at their rate in time.
+ *
+ * Dimming keeps its period in counts and only changes the SMCLK divider. Blink
+ * periods are restarted from their durations, in software if they no longer
+ * fit the timer at the new ACLK rate.
+ */
+static void led_clock_changed(void)
+{
+    if (timer1.mode == LED_HW_NONE || timer1_source_hz(timer1.mode) == timer1.clock_hz) return;
+
+    if (timer1.mode == LED_HW_PWM) {
+        TA1CTL = timer1_ctl(LED_HW_PWM);
+        timer1.clock_hz = clock_smclk_hz();
+        return;
+    }
+
+    uint8_t restart_mask = 0;
+    for (uint8_t i = 0; i < ARRAY_SIZE(leds); i++) {
+        if (leds[i].hw_mode == LED_HW_BLINK) {
+            leds[i].hw_mode = LED_HW_NONE;
+            restart_mask |= 1u << i;
+        }
+    }
+    timer1_release_if_idle();
+    for (uint8_t i = 0; i < ARRAY_SIZE(leds); i++) {
+        if (restart_mask & (1u << i)) {
+            led_start_blinking((led_handle_t)&leds[i], leds[i].on_period_ms, leds[i].off_period_ms);
+        }
+    }
+}
+
+/**
+ * @brief Starts a Timer1_A output mode on an LED's channel.
+ *
+ * OUTMOD_7 (reset/set) drives the output high from the start of each period
+ * until TAR reaches @p high_counts, without any interrupt.
+ */
+static bool hw_start(struct led_s *led, led_hw_e mode, uint16_t period, uint16_t high_counts)
+{
+    if (led->timer_channel == 0) return false;
+    boot_mark(BOOT_MARK_FIRST_LED); // Before Timer1_A stops counting the boot
+    if (!timer1_claim(led, mode, period)) return false;
+
+    *timer_ccr(led) = high_counts;
+    // Start from the ON level, as the output only changes on the next compare.
+    *timer_cctl(led) = OUTMOD_0 | OUT;
+    *timer_cctl(led) = OUTMOD_7;
+    led->hw_mode = mode;
+    led->state = LED_ON;
+    return true;
+}
+
+/**
+ * @brief Drives the LED pin to a static level without touching the blinking state.
+ */
+static void led_drive(struct led_s *led, led_state_e state)
+{
+    if (led->timer_channel != 0) {
+        // The pin stays on the timer output; OUTMOD_0 outputs the OUT bit.
+        *timer_cctl(led) = OUTMOD_0 | ((state == LED_ON) ? OUT : 0);
+        if (led->hw_mode != LED_HW_NONE) {
+            led->hw_mode = LED_HW_NONE;
+            timer1_release_if_idle();
+        }
+    } else {
+        gpio_set_out(led->io, (state == LED_ON) ? IO_OUT_HIGH : IO_OUT_LOW);
+    }
+    led->state = state;
+    led->brightness = (state == LED_ON) ? LED_BRIGHTNESS_MAX : 0;
+    if (state == LED_ON) {
+        boot_mark(BOOT_MARK_FIRST_LED);
+    }
+}
+
+/**
+ * @brief Shows a brightness level, with PWM if the LED has a timer output.
+ *
+ * Without a timer output the LED is switched on from half brightness up.
+ */
+static void led_apply_brightness(struct led_s *led, uint8_t brightness)
+{
+    if (brightness > 0 && brightness < LED_BRIGHTNESS_MAX && led->timer_channel != 0) {
+        if (led->hw_mode == LED_HW_PWM) {
+            // Already dimming: only move the compare, without restarting the output.
+            *timer_ccr(led) = (uint16_t)brightness * PWM_STEP_COUNTS;
+            led->brightness = brightness;
+            return;
+        }
+        if (hw_start(led, LED_HW_PWM, PWM_PERIOD_COUNTS, (uint16_t)brightness * PWM_STEP_COUNTS)) {
+            led->brightness = brightness;
+            return;
+        }
+    }
+
+    led_drive(led, (brightness >= (LED_BRIGHTNESS_MAX + 1) / 2) ? LED_ON : LED_OFF);
+    led->brightness = brightness;
+}
+
+/**
+ * @brief Stops any software blinking or pattern playback on an LED.
+ */
+static void led_stop_sequencing(struct led_s *led)
+{
+    led->is_blinking = false;
+    led->pattern = NULL;
+}
+
+/**
+ * @brief Starts the current pattern step at led->next_toggle_tick.
+ *
+ * Plain steps set their level and end after their duration. Fade steps are
+ * split into FADE_UPDATE_MS updates that interpolate towards their level.
+ */
+static void pattern_enter_step(struct led_s *led)
+{
+    led_step_t step = led->pattern->steps[led->step_idx];
+    uint8_t level = LEVEL_TO_BRIGHTNESS(step >> LED_STEP_LEVEL_OFFSET);
+    uint16_t duration_ms = (step & LED_STEP_DURATION_MASK) * LED_STEP_UNIT_MS;
+
+    if ((step & LED_STEP_FADE_FLAG) && duration_ms > FADE_UPDATE_MS) {
+        led->fade_from = led->brightness;
+        led->fade_elapsed_ms = 0;
+        led->next_toggle_tick += TIMEBASE_MS_TO_TICKS(FADE_UPDATE_MS);
+    } else {
+        led_apply_brightness(led, level);
+        led->next_toggle_tick += TIMEBASE_MS_TO_TICKS(duration_ms);
+    }
+}
+
+/**
+ * @brief Advances a pattern once its deadline is reached.
+ */
+static void pattern_advance(struct led_s *led)
+{
+    led_step_t step = led->pattern->steps[led->step_idx];
+
+    if (step & LED_STEP_FADE_FLAG) {
+        uint16_t duration_ms = (step & LED_STEP_DURATION_MASK) * LED_STEP_UNIT_MS;
+        if (duration_ms > FADE_UPDATE_MS && led->fade_elapsed_ms < duration_ms) {
+            // Intermediate fade update: interpolate between the two levels.
+            led->fade_elapsed_ms += FADE_UPDATE_MS;
+            if (led->fade_elapsed_ms > duration_ms) {
+                led->fade_elapsed_ms = duration_ms;
+            }
+            int16_t span = (int16_t)LEVEL_TO_BRIGHTNESS(step >> LED_STEP_LEVEL_OFFSET) - led->fade_from;
+            led_apply_brightness(led,
+                (uint8_t)(led->fade_from + ((int32_t)span * led->fade_elapsed_ms) / duration_ms));
+
+            if (led->fade_elapsed_ms < duration_ms) {
+                uint16_t remaining_ms = duration_ms - led->fade_elapsed_ms;
+                led->next_toggle_tick += TIMEBASE_MS_TO_TICKS(
+                    (remaining_ms < FADE_UPDATE_MS) ? remaining_ms : FADE_UPDATE_MS);
+                return;
+            }
+            // The final level has just been applied; the step ends now.
+        }
+    }
+
+    if (++led->step_idx >= led->pattern->step_cnt) {
+        led->step_idx = 0;
+        if (led->pattern->repeat_cnt != 0 && --led->repeats_left == 0) {
+            led_stop_sequencing(led);
+            led_drive(led, LED_OFF);
+            return;
+        }
+    }
+    pattern_enter_step(led);
+}
+
 // --- Public Function Definitions ---
 
 void led_init(void)
 {
-    // Configure GPIO pins for all LEDs as outputs, initially turned off for power saving
-    gpio_config_t cfg = {
+    // gpio_init() already made the LED pins low outputs from board.h. Only the
+    // pins with a timer output are rerouted, to Timer1_A held low by OUTMOD_0.
+    const gpio_config_t timer_cfg = {
         .dir = IO_DIR_OUTPUT,
         .out = IO_OUT_LOW,
         .resistor = IO_RESISTOR_DISABLED,
-        .select = IO_SELECT_GPIO,
+        .select = IO_SELECT_ALT1,
     };
 
     for (uint8_t i = 0; i < ARRAY_SIZE(leds); i++) {
-        gpio_configure(leds[i].io, &cfg);
+        if (leds[i].timer_channel != 0) {
+            struct led_s *led = (struct led_s *)&leds[i];
+            *timer_cctl(led) = OUTMOD_0;
+            gpio_configure(leds[i].io, &timer_cfg);
+        }
     }
 
-    /*
-     * Configure Timer A0 to generate a 1ms interrupt for the system tick.
-     * ... (timer configuration comments remain the same) ...
-     */
-    TA0CTL = TASSEL_2 | ID_3 | MC_1 | TACLR;
-    TA0CCR0 = (TIMER_COUNTS_PER_MS * TIMER_PERIOD_MS) - 1;
-    TA0CCTL0 |= CCIE; // Enable the Capture/Compare Register 0 interrupt
+#if LED_PANEL_CHANNELS > 0
+    led_panel_init();
+#endif
+
+    runloop_register(RUNLOOP_EVENT_LED, led_handle_blinking);
+    clock_register(CLOCK_CLIENT_LED, led_clock_changed);
 }
 
 led_handle_t led_get_handle(gpio_e io)
@@ -95,89 +477,169 @@ led_handle_t led_get_handle(gpio_e io)
     return NULL; // Return NULL if no matching LED is found
 }
 
+led_handle_t led_get_panel_handle(uint8_t channel)
+{
+#if LED_PANEL_CHANNELS > 0
+    if (channel < LED_PANEL_CHANNELS) {
+        return (led_handle_t)(uintptr_t)&panel_handle_ids[channel];
+    }
+#else
+    UNUSED(channel);
+#endif
+    return NULL;
+}
+
 // NOTE: The function parameter is now 'handle' for clarity.
 void led_set_state(led_handle_t handle, led_state_e state)
 {
     if (handle == NULL) return;
 
+    uint8_t channel;
+    if (is_panel_handle(handle, &channel)) {
+        led_panel_set(channel, (state == LED_ON) ? LED_BRIGHTNESS_MAX : 0);
+        return;
+    }
+
     // The 'volatile' is cast away implicitly by the assignment.
     // This is safe within this controlled API.
     struct led_s* led = handle;
 
-    if (state == LED_ON) {
-        gpio_set_out(led->io, IO_OUT_HIGH);
-        led->state = LED_ON;
-    } else {
-        gpio_set_out(led->io, IO_OUT_LOW);
-        led->state = LED_OFF;
-    }
+    led_stop_sequencing(led);
+    led_drive(led, state);
 }
 
 void led_start_blinking(led_handle_t handle, uint16_t on_period_ms, uint16_t off_period_ms)
 {
-    if (handle == NULL) return;
+    uint8_t channel;
+    if (handle == NULL || is_panel_handle(handle, &channel)) return;
 
     // We can directly access members because this file has the full struct definition.
     struct led_s* led = handle;
 
+    led_stop_sequencing(led);
     led->on_period_ms = on_period_ms;
     led->off_period_ms = off_period_ms;
-    
-    // --- Critical Section: Atomically read the system tick ---
-    __disable_interrupt();
-    led->last_toggle_time = system_tick_ms;
-    __enable_interrupt();
-    // --- End Critical Section ---
 
+    // Prefer the timer output: no interrupts and no jitter from the main loop.
+    // Widened before the sum: with a 16-bit int, periods over 65535 ms would wrap.
+    uint32_t on_counts = ((uint32_t)on_period_ms * blink_timer_hz()) / 1000;
+    uint32_t period_counts = (((uint32_t)on_period_ms + off_period_ms) * blink_timer_hz()) / 1000;
+    if (on_counts > 0 && on_counts <= period_counts && period_counts <= 0xFFFFu
+        && hw_start(led, LED_HW_BLINK, (uint16_t)period_counts, (uint16_t)on_counts)) {
+        return;
+    }
+
+    led->next_toggle_tick = timebase_ticks() + TIMEBASE_MS_TO_TICKS(on_period_ms);
+    led_drive(led, LED_ON); // Start the blinking sequence with the LED ON
     led->is_blinking = true;
-    led_set_state(led, LED_ON); // Start the blinking sequence with the LED ON
-    led->is_blinking = true;    // Restore flag, as led_set_state might clear it.
+
+    // Let led_handle_blinking() fold this LED into the next alarm deadline.
+    runloop_post(RUNLOOP_EVENT_LED);
 }
 
 void led_stop_blinking(led_handle_t handle)
 {
     if (handle == NULL) return;
     
+    led_set_state(handle, LED_OFF); // Ensure LED is off when blinking stops
+}
+
+void led_set_brightness(led_handle_t handle, uint8_t brightness)
+{
+    if (handle == NULL) return;
+
+    uint8_t channel;
+    if (is_panel_handle(handle, &channel)) {
+        led_panel_set(channel, brightness);
+        return;
+    }
+
     struct led_s* led = handle;
 
-    led->is_blinking = false;
-    led_set_state(led, LED_OFF); // Ensure LED is off when blinking stops
+    led_stop_sequencing(led);
+    if (brightness > 0 && brightness < LED_BRIGHTNESS_MAX
+        && hw_start(led, LED_HW_PWM, PWM_PERIOD_COUNTS, (uint16_t)brightness * PWM_STEP_COUNTS)) {
+        led->brightness = brightness;
+        return;
+    }
+
+    // Full scale, or no timer output available: plain on/off.
+    led_drive(led, (brightness > 0) ? LED_ON : LED_OFF);
 }
 
-void led_handle_blinking(void)
+void led_play_pattern(led_handle_t handle, const led_pattern_t *pattern)
+{
+    uint8_t channel;
+    if (handle == NULL || pattern == NULL || pattern->step_cnt == 0) return;
+    if (is_panel_handle(handle, &channel)) return;
+
+    struct led_s* led = handle;
+
+    led_stop_sequencing(led);
+    led->step_idx = 0;
+    led->repeats_left = pattern->repeat_cnt;
+    led->next_toggle_tick = timebase_ticks();
+    led->pattern = pattern;
+    pattern_enter_step(led);
+
+    // Let led_handle_blinking() fold this LED into the next alarm deadline.
+    runloop_post(RUNLOOP_EVENT_LED);
+}
+
+/**
+ * @brief Timebase alarm callback, runs in interrupt context.
+ */
+static void led_alarm_handler(void)
 {
-    uint32_t current_time;
+    runloop_post(RUNLOOP_EVENT_LED);
+}
 
-    // --- Critical Section: Atomically read the shared system tick variable ---
-    __disable_interrupt();
-    current_time = system_tick_ms;
-    __enable_interrupt();
-    // --- End Critical Section ---
+void led_handle_blinking(void)
+{
+    uint32_t current_time = timebase_ticks();
+    bool any_pending = false;
+    uint32_t next_deadline = 0;
 
     for (uint8_t i = 0; i < ARRAY_SIZE(leds); i++) {
         // Use a non-volatile pointer for manipulation within this function
         struct led_s *led = (struct led_s*)&leds[i];
 
         if (led->is_blinking) {
-            // Unsigned subtraction correctly handles timer rollover
-            uint32_t elapsed_time = current_time - led->last_toggle_time;
-            
-            uint16_t current_period = (led->state == LED_ON) ? led->on_period_ms : led->off_period_ms;
-
-            if (elapsed_time >= current_period) {
+            if (timebase_reached(current_time, led->next_toggle_tick)) {
                 // Toggle state
                 led_state_e new_state = (led->state == LED_ON) ? LED_OFF : LED_ON;
-                led_set_state(led, new_state);
-                led->is_blinking = true; // led_set_state clears this, so restore it.
-                led->last_toggle_time = current_time;
+                led_drive(led, new_state);
+                TRACE(TRACE_EVENT_LED_TOGGLE, i | ((new_state == LED_ON) ? 0x80 : 0));
+
+                // Advance from the previous deadline so that periods do not drift.
+                uint16_t next_period = (new_state == LED_ON) ? led->on_period_ms : led->off_period_ms;
+                led->next_toggle_tick += TIMEBASE_MS_TO_TICKS(next_period);
+                if (timebase_reached(current_time, led->next_toggle_tick)) {
+                    // Fell behind by more than a full period: resynchronise.
+                    led->next_toggle_tick = current_time + TIMEBASE_MS_TO_TICKS(next_period);
+                }
+            }
+        } else if (led->pattern != NULL) {
+            // Catch up on every step that ended since the last call, bounded so
+            // that a pattern made only of zero-length steps cannot hang the loop.
+            for (uint8_t n = 0; n <= led->pattern->step_cnt; n++) {
+                if (!timebase_reached(current_time, led->next_toggle_tick)) break;
+                pattern_advance(led);
+                if (led->pattern == NULL) break;
             }
         }
+
+        if ((led->is_blinking || led->pattern != NULL)
+            && (!any_pending || !timebase_reached(led->next_toggle_tick, next_deadline))) {
+            next_deadline = led->next_toggle_tick;
+            any_pending = true;
+        }
     }
-}
 
-// --- Interrupt Service Routine ---
-__attribute__((interrupt(TIMER0_A0_VECTOR)))
-void Timer0_A0_ISR(void)
-{
-    system_tick_ms++;
+    // A single alarm for the earliest deadline of all LEDs: nothing runs in between.
+    if (any_pending) {
+        timebase_alarm_set(TIMEBASE_ALARM_LED, next_deadline, led_alarm_handler);
+    } else {
+        timebase_alarm_cancel(TIMEBASE_ALARM_LED);
+    }
 }
@@ -3,7 +3,19 @@
  * @brief LED driver for handling GPIO-based LEDs, including non-blocking blinking.
  *
  * This module initializes and controls LEDs connected to GPIO pins. It relies
- * on a periodic timer interrupt to provide non-blocking blinking functionality.
+ * on a timebase alarm set to the next toggle deadline to provide non-blocking
+ * blinking functionality, so no periodic timer interrupt is needed.
+ *
+ * LEDs on a Timer1_A output pin (P2.1/P2.2 for TA1.1, P2.4/P2.5 for TA1.2)
+ * are blinked and dimmed entirely in hardware instead. Both channels share
+ * the timer period, so when the other channel is busy with a different period
+ * or mode the LED falls back to the software path.
+ *
+ * Channels of the shift-register LED panel (see led_panel.h) are addressed
+ * through the same handles, obtained with led_get_panel_handle(). They support
+ * led_set_state(), led_set_brightness() and led_stop_blinking(); blinking and
+ * patterns need per-LED state that the 512 bytes of RAM cannot afford for
+ * every channel, so they are ignored on panel handles.
  * The internal state of an LED is encapsulated and can only be manipulated
  * through the provided API using an opaque handle.
  */
@@ -13,6 +25,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "gpio.h" // Assuming gpio.h defines gpio_e
+#include "../common/defines.h"
 
 // --- Public Constants ---
 
@@ -22,6 +35,61 @@
 #define LED_ON_PERIOD_MS_DEFAULT 800
 #define LED_OFF_PERIOD_MS_DEFAULT 200
 
+/**
+ * @brief Full-scale value for led_set_brightness().
+ */
+#define LED_BRIGHTNESS_MAX 255
+
+/**
+ * @brief Pattern step encoding, one 16-bit word per step stored in flash.
+ * - Bits 12-15: brightness level (0 = off, LED_LEVEL_MAX = fully on).
+ * - Bit 11: fade linearly from the previous level instead of jumping to it.
+ * - Bits 0-10: step duration in units of LED_STEP_UNIT_MS (up to 20.47 s).
+ */
+#define LED_LEVEL_MAX 15
+#define LED_STEP_UNIT_MS 10
+#define LED_STEP_FADE_FLAG 0x0800u
+#define LED_STEP_LEVEL_OFFSET 12
+#define LED_STEP_DURATION_MASK 0x07FFu
+
+/**
+ * @brief Holds a brightness level for a duration.
+ */
+#define LED_STEP(level, duration_ms)                                                               \
+    ((led_step_t)(((level) << LED_STEP_LEVEL_OFFSET) | ((duration_ms) / LED_STEP_UNIT_MS)))
+
+/**
+ * @brief Fades from the previous step's level to a new level over a duration.
+ * Fades need a Timer1_A output; other LEDs switch when crossing half brightness.
+ */
+#define LED_STEP_FADE(level, duration_ms)                                                          \
+    ((led_step_t)(LED_STEP(level, duration_ms) | LED_STEP_FADE_FLAG))
+
+/**
+ * @brief Building blocks for n-blink codes: n short flashes.
+ */
+#define LED_BLINKS_1 LED_STEP(LED_LEVEL_MAX, 200), LED_STEP(0, 300)
+#define LED_BLINKS_2 LED_BLINKS_1, LED_BLINKS_1
+#define LED_BLINKS_3 LED_BLINKS_2, LED_BLINKS_1
+#define LED_BLINKS_4 LED_BLINKS_3, LED_BLINKS_1
+#define LED_BLINKS_5 LED_BLINKS_4, LED_BLINKS_1
+
+/**
+ * @brief Building blocks for Morse-style codes (200 ms unit).
+ * Each symbol includes the one-unit gap that follows it.
+ */
+#define LED_MORSE_DOT LED_STEP(LED_LEVEL_MAX, 200), LED_STEP(0, 200)
+#define LED_MORSE_DASH LED_STEP(LED_LEVEL_MAX, 600), LED_STEP(0, 200)
+#define LED_MORSE_LETTER_GAP LED_STEP(0, 400) ///< Extends the symbol gap to 3 units.
+#define LED_MORSE_WORD_GAP LED_STEP(0, 1200) ///< Extends the symbol gap to 7 units.
+
+/**
+ * @brief Defines a flash-resident pattern from an array of steps.
+ * @param steps A const led_step_t array.
+ * @param repeat Number of times the steps are played, or 0 to repeat forever.
+ */
+#define LED_PATTERN(steps, repeat) { (steps), ARRAY_SIZE(steps), (repeat) }
+
 // --- Public Type Definitions ---
 
 /**
@@ -41,11 +109,33 @@ typedef enum {
  */
 typedef struct led_s *led_handle_t;
 
+/**
+ * @brief One encoded pattern step, see LED_STEP() and LED_STEP_FADE().
+ */
+typedef uint16_t led_step_t;
+
+/**
+ * @brief A sequence of steps played by led_play_pattern(), meant to live in flash.
+ */
+typedef struct
+{
+    const led_step_t *steps; ///< Encoded steps.
+    uint8_t step_cnt; ///< Number of steps.
+    uint8_t repeat_cnt; ///< Number of times the steps are played, 0 for forever.
+} led_pattern_t;
+
+// --- Built-in Patterns ---
+
+extern const led_pattern_t led_pattern_heartbeat; ///< Double pulse once per second.
+extern const led_pattern_t led_pattern_breathe; ///< Slow fade in and out.
+extern const led_pattern_t led_pattern_sos; ///< Morse "SOS" error code.
+
 // --- Public Function Prototypes ---
 
 /**
- * @brief Initializes GPIO pins for all LEDs and the system tick timer.
- * @note This function must be called once before any other LED function.
+ * @brief Initializes GPIO pins for all LEDs.
+ * @note This function must be called once, after timebase_init(), before any
+ * other LED function.
  */
 void led_init(void);
 
@@ -58,6 +148,10 @@ void led_set_state(led_handle_t handle, led_state_e state);
 
 /**
  * @brief Starts blinking an LED with specified on/off periods.
+ *
+ * On a Timer1_A output pin the blinking runs from ACLK with no interrupts,
+ * as long as the total period fits in 16 seconds.
+ *
  * @param handle Handle to the LED object. Must not be NULL.
  * @param on_period_ms The time in milliseconds the LED should be ON.
  * @param off_period_ms The time in milliseconds the LED should be OFF.
@@ -71,9 +165,31 @@ void led_start_blinking(led_handle_t handle, uint16_t on_period_ms, uint16_t off
 void led_stop_blinking(led_handle_t handle);
 
 /**
- * @brief Handles the state machine for all blinking LEDs.
- * @note This function must be called periodically in the main application loop
- * to update the state of any blinking LEDs.
+ * @brief Sets the brightness of an LED and stops any blinking.
+ *
+ * On a Timer1_A output pin the LED is dimmed with ~980 Hz hardware PWM.
+ * Other LEDs cannot be dimmed: any non-zero brightness turns them fully on.
+ *
+ * @param handle Handle to the LED object. Must not be NULL.
+ * @param brightness Duty cycle, from 0 (off) to LED_BRIGHTNESS_MAX (fully on).
+ */
+void led_set_brightness(led_handle_t handle, uint8_t brightness);
+
+/**
+ * @brief Plays a step pattern on an LED, replacing any blinking or pattern.
+ *
+ * When a finite pattern completes, the LED is turned off.
+ *
+ * @param handle Handle to the LED object. Must not be NULL.
+ * @param pattern The pattern to play. Must stay valid while playing (e.g. const).
+ */
+void led_play_pattern(led_handle_t handle, const led_pattern_t *pattern);
+
+/**
+ * @brief Handles the state machine for all blinking LEDs and patterns.
+ * @note This function is registered by led_init() as the RUNLOOP_EVENT_LED
+ * handler, which the timebase alarm posts whenever a toggle is due. It does
+ * not need to be called from the application.
  */
 void led_handle_blinking(void);
 
@@ -84,4 +200,11 @@ void led_handle_blinking(void);
  */
 led_handle_t led_get_handle(gpio_e io);
 
+/**
+ * @brief Gets a handle to a channel of the shift-register LED panel.
+ * @param channel The panel channel, from 0 to LED_PANEL_CHANNELS - 1.
+ * @return A handle to the channel, or NULL if it does not exist.
+ */
+led_handle_t led_get_panel_handle(uint8_t channel);
+
 #endif // LED_H
\ No newline at end of file
@@ -0,0 +1,309 @@
+/**
+ * @file led_panel.c
+ * @brief Implementation of the 74HC595 LED panel backend with bit-angle modulation.
+ *
+ * The brightness values are stored as 8 bit-planes of LED_PANEL_CHANNELS bits.
+ * At the start of each plane interval the CCR1 ISR pulses RCLK to show the
+ * plane shifted during the previous interval, then shifts out the next plane
+ * and returns the duration of the plane now shown.
+ */
+#include "led_panel.h"
+#include <msp430.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../common/critical.h"
+#include "../common/defines.h"
+#include "../common/format.h"
+#include "clock.h"
+#include "gpio.h"
+#include "timebase.h"
+#include "uart.h"
+
+#if LED_PANEL_CHANNELS > 0
+
+_Static_assert(LED_PANEL_CHANNELS % 8 == 0 && LED_PANEL_CHANNELS <= 32,
+    "The LED panel supports 1 to 4 chained 8-bit shift registers");
+
+// --- Private Module Constants ---
+
+#define PANEL_BYTES (LED_PANEL_CHANNELS / 8)
+#define PLANE_CNT 8
+#define FRAME_UNITS 255u
+#define SPI_CLK_MAX_HZ 8000000UL // 74HC595 limit at 3.3 V
+#define LINE_MAX 96
+
+/**
+ * @brief Shortest plane at the slowest refreshed clock, in ticks. The longest plane is 128 units.
+ */
+#define UNIT_TICKS_MAX (LED_PANEL_UNIT_CYCLES * TIMEBASE_TICK_HZ / LED_PANEL_MCLK_MIN_HZ)
+_Static_assert(UNIT_TICKS_MAX << (PLANE_CNT - 1) <= UINT16_MAX,
+    "The longest plane must fit in a periodic channel interval");
+
+/**
+ * @brief Register contents switching every channel off.
+ */
+static const uint8_t dark_bytes[PANEL_BYTES] = { 0 };
+
+// --- Private Module Variables ---
+
+/**
+ * @brief Bit-planes: bit n of planes[k][i] is bit k of channel 8 * i + n.
+ */
+static volatile uint8_t planes[PLANE_CNT][PANEL_BYTES];
+
+/**
+ * @brief Brightness of each channel, kept to answer led_panel_get().
+ */
+static uint8_t channel_brightness[LED_PANEL_CHANNELS];
+
+/**
+ * @brief Bit-plane waiting in the shift registers for the next RCLK pulse.
+ */
+static volatile uint8_t shifted_plane = 0;
+
+static volatile bool is_refreshing = false; ///< A channel is lit: the refresh should run.
+static bool is_clock_fast = false; ///< MCLK is at least LED_PANEL_MCLK_MIN_HZ.
+static volatile uint16_t unit_ticks = 0; ///< LED_PANEL_UNIT_CYCLES at the current clock.
+static volatile uint16_t frame_busy_ticks = 0;
+static volatile led_panel_stats_t stats;
+static uint16_t misses_at_reset = 0; ///< timebase_periodic_misses() at the last reset.
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Shifts one byte per register into the chain.
+ *
+ * The last byte sent ends up in the first register, so the bytes go out from
+ * the far end of the chain. The burst takes about 1 us per byte at 8 MHz,
+ * short enough to poll even during the shortest plane.
+ */
+static void shift_bytes(const volatile uint8_t *bytes)
+{
+    for (int8_t i = PANEL_BYTES - 1; i >= 0; i--) {
+        while (!(IFG2 & UCB0TXIFG));
+        UCB0TXBUF = bytes[i];
+    }
+    while (UCB0STAT & UCBUSY);
+}
+
+/**
+ * @brief Shifts one bit-plane into the register chain.
+ */
+static void shift_plane(uint8_t plane)
+{
+    shift_bytes(planes[plane]);
+}
+
+/**
+ * @brief Pulses RCLK to copy the shift registers to their outputs.
+ */
+static void latch(void)
+{
+    gpio_set_out(IO_PANEL_LATCH, IO_OUT_HIGH);
+    gpio_set_out(IO_PANEL_LATCH, IO_OUT_LOW);
+}
+
+/**
+ * @brief CCR1 periodic callback showing one bit-plane, runs in interrupt context.
+ * @return The duration of the plane just latched, in ticks.
+ */
+static uint16_t plane_isr(void)
+{
+    uint32_t start = timebase_ticks();
+
+    latch();
+    uint8_t shown = shifted_plane;
+    shifted_plane = (shown + 1) & (PLANE_CNT - 1);
+    shift_plane(shifted_plane);
+
+    frame_busy_ticks += (uint16_t)(timebase_ticks() - start);
+    if (shown == PLANE_CNT - 1) {
+        // End of frame: publish the CPU budget of the refresh.
+        stats.frame_cnt++;
+        stats.busy_ticks = frame_busy_ticks;
+        if (frame_busy_ticks > stats.busy_ticks_max) {
+            stats.busy_ticks_max = frame_busy_ticks;
+        }
+        frame_busy_ticks = 0;
+    }
+
+    if (!is_refreshing) {
+        // Everything was switched off: the all-off plane just shifted is shown
+        // right away and the refresh stops until a channel is lit again.
+        latch();
+        return 0;
+    }
+    return unit_ticks << shown;
+}
+
+/**
+ * @brief Starts the refresh from the first plane.
+ * @note Must be called with interrupts disabled.
+ */
+static void start_refresh(void)
+{
+    shifted_plane = 0;
+    shift_plane(0);
+    frame_busy_ticks = 0;
+    timebase_periodic_start(unit_ticks, plane_isr);
+}
+
+/**
+ * @brief Checks whether any channel is lit.
+ */
+static bool any_lit(void)
+{
+    // A lit channel has at least one bit set in some plane.
+    for (uint8_t k = 0; k < PLANE_CNT; k++) {
+        for (uint8_t i = 0; i < PANEL_BYTES; i++) {
+            if (planes[k][i]) return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Sets the SPI clock to the fastest SMCLK division within SPI_CLK_MAX_HZ.
+ *
+ * The plane ISR waits for each shift to complete, so the USCI is idle
+ * whenever this runs.
+ */
+static void configure_spi_clock(void)
+{
+    uint16_t divider = (uint16_t)((clock_smclk_hz() + SPI_CLK_MAX_HZ - 1) / SPI_CLK_MAX_HZ);
+
+    UCB0CTL1 |= UCSWRST;
+    UCB0BR0 = (uint8_t)divider;
+    UCB0BR1 = (uint8_t)(divider >> 8);
+    UCB0CTL1 &= ~UCSWRST;
+}
+
+/**
+ * @brief Clock change callback: rescales the planes, or suspends the refresh below
+ * LED_PANEL_MCLK_MIN_HZ.
+ * @note Runs with interrupts disabled.
+ */
+static void led_panel_clock_changed(void)
+{
+    configure_spi_clock();
+
+    // MCLK runs undivided from the DCO, like SMCLK.
+    uint32_t mclk_hz = clock_smclk_hz();
+    bool was_fast = is_clock_fast;
+    is_clock_fast = (mclk_hz >= LED_PANEL_MCLK_MIN_HZ);
+    if (is_clock_fast) {
+        unit_ticks = (uint16_t)((LED_PANEL_UNIT_CYCLES * TIMEBASE_TICK_HZ) / mclk_hz);
+        stats.frame_ticks = FRAME_UNITS * unit_ticks;
+        if (!was_fast && is_refreshing) {
+            start_refresh();
+        }
+    } else if (was_fast && (TA0CCTL1 & CCIE)) {
+        // Too slow to refresh without flicker: leave the panel dark until the clock is back.
+        timebase_periodic_stop();
+        shift_bytes(dark_bytes);
+        latch();
+    }
+}
+
+// --- Public Function Definitions ---
+
+void led_panel_init(void)
+{
+    /*
+     * Configure USCI_B0 as a 3-wire SPI master:
+     * - UCCKPH: data captured on the first (rising) SCLK edge, as the 74HC595 expects.
+     * - UCMSB: MSB first, so bit 0 of each byte lands on QA.
+     * - UCSSEL_2: clocked from SMCLK, divided down to at most SPI_CLK_MAX_HZ.
+     */
+    UCB0CTL1 = UCSWRST;
+    UCB0CTL0 = UCCKPH | UCMSB | UCMST | UCSYNC;
+    UCB0CTL1 = UCSSEL_2 | UCSWRST;
+    led_panel_clock_changed();
+    clock_register(CLOCK_CLIENT_LED_PANEL, led_panel_clock_changed);
+
+    // Clear the chain so the panel starts dark.
+    shift_plane(0);
+    latch();
+}
+
+void led_panel_set(uint8_t channel, uint8_t brightness)
+{
+    if (channel >= LED_PANEL_CHANNELS) return;
+
+    uint8_t byte = channel >> 3;
+    uint8_t bit = 1u << (channel & 7u);
+
+    channel_brightness[channel] = brightness;
+    // Spread the brightness over the bit-planes once here, so the refresh
+    // itself never has to look at individual channels.
+    for (uint8_t k = 0; k < PLANE_CNT; k++) {
+        if (brightness & (1u << k)) {
+            planes[k][byte] |= bit;
+        } else {
+            planes[k][byte] &= ~bit;
+        }
+    }
+
+    bool lit = any_lit();
+
+    // --- Critical Section: the plane ISR may still be winding down ---
+    critical_state_t state = critical_enter();
+    if (lit && !is_refreshing) {
+        is_refreshing = true;
+        if (is_clock_fast && !(TA0CCTL1 & CCIE)) {
+            start_refresh();
+        }
+    } else if (!lit) {
+        // The ISR stops the refresh once the all-off planes have been latched.
+        is_refreshing = false;
+    }
+    critical_exit(state);
+    // --- End Critical Section ---
+}
+
+uint8_t led_panel_get(uint8_t channel)
+{
+    return (channel < LED_PANEL_CHANNELS) ? channel_brightness[channel] : 0;
+}
+
+void led_panel_get_stats(led_panel_stats_t *out)
+{
+    critical_state_t state = critical_enter();
+    *out = stats;
+    out->late_planes = timebase_periodic_misses() - misses_at_reset;
+    critical_exit(state);
+}
+
+void led_panel_reset_stats(void)
+{
+    critical_state_t state = critical_enter();
+    stats.frame_cnt = 0;
+    stats.busy_ticks = 0;
+    stats.busy_ticks_max = 0;
+    misses_at_reset = timebase_periodic_misses();
+    critical_exit(state);
+}
+
+void led_panel_report(void)
+{
+    led_panel_stats_t counts;
+    led_panel_get_stats(&counts);
+
+    // e.g. "led_panel: 1225 frames of 8160 us, busy 97/98 us per frame, 0 late planes\r\n"
+    char line[LINE_MAX];
+    char *end = format_str(line, "led_panel: ");
+    end = format_u32(end, counts.frame_cnt);
+    end = format_str(end, " frames of ");
+    end = format_u32(end, counts.frame_ticks >> TIMEBASE_TICKS_PER_US_LOG2);
+    end = format_str(end, " us, busy ");
+    end = format_u32(end, counts.busy_ticks >> TIMEBASE_TICKS_PER_US_LOG2);
+    *end++ = '/';
+    end = format_u32(end, counts.busy_ticks_max >> TIMEBASE_TICKS_PER_US_LOG2);
+    end = format_str(end, " us per frame, ");
+    end = format_u32(end, counts.late_planes);
+    end = format_str(end, " late planes\r\n");
+
+    uart_write_all(line, (uint16_t)(end - line));
+}
+
+#endif // LED_PANEL_CHANNELS > 0
@@ -0,0 +1,97 @@
+/**
+ * @file led_panel.h
+ * @brief Many-channel LED backend driving chained 74HC595 shift registers over SPI.
+ *
+ * Brightness is produced with bit-angle modulation (BAM): each frame shows the
+ * 8 bit-planes of the channel brightness values for 1, 2, 4 ... 128 time units.
+ * A refresh therefore costs one SPI burst of BOARD_LED_PANEL_CHANNELS / 8
+ * bytes per bit-plane, whatever the number of channels, instead of one toggle
+ * per channel. The planes are timed by the Timer0_A CCR1 periodic channel.
+ *
+ * Applications normally use the LED driver through led_get_panel_handle().
+ */
+#ifndef LED_PANEL_H
+#define LED_PANEL_H
+
+#include <stdint.h>
+#include "../common/board.h"
+
+// --- Public Constants ---
+
+#define LED_PANEL_CHANNELS BOARD_LED_PANEL_CHANNELS
+
+/**
+ * @brief Duration of the shortest bit-plane, in MCLK cycles: 32 us at 16 MHz.
+ *
+ * The plane ISR takes a fixed number of cycles, so the unit follows the clock
+ * profile to leave it the same share of the shortest plane. A frame lasts 255
+ * units: 8.16 ms (122 Hz) at 16 MHz, 16.3 ms (61 Hz) at 8 MHz.
+ */
+#define LED_PANEL_UNIT_CYCLES 512
+
+/**
+ * @brief Slowest MCLK at which the panel is refreshed.
+ *
+ * Below it the frame rate would fall under 60 Hz and visibly flicker. The
+ * refresh is then suspended with the panel dark, and resumes with the
+ * brightness values kept once the clock is fast enough again.
+ */
+#define LED_PANEL_MCLK_MIN_HZ 8000000UL
+
+// --- Public Type Definitions ---
+
+/**
+ * @brief Measured CPU cost of the refresh, in timebase ticks (0.5 us).
+ */
+typedef struct
+{
+    uint16_t frame_ticks; ///< Duration of one frame at the current clock.
+    uint16_t frame_cnt; ///< Frames shown (wraps).
+    uint16_t busy_ticks; ///< Time spent in the plane ISR during the last frame.
+    uint16_t busy_ticks_max; ///< Worst busy_ticks seen.
+    uint16_t late_planes; ///< Planes shown late because the previous ISR overran (wraps).
+} led_panel_stats_t;
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Configures USCI_B0 as an SPI master for the shift register chain.
+ * @note Must be called after gpio_init() and timebase_init(). All channels start off.
+ */
+void led_panel_init(void);
+
+/**
+ * @brief Sets the brightness of one channel.
+ *
+ * The refresh only runs while at least one channel is lit. Channels at 0 or
+ * full scale have all their bit-planes equal, so they do not flicker.
+ *
+ * @param channel The channel, from 0 to LED_PANEL_CHANNELS - 1.
+ * @param brightness Duty cycle, from 0 (off) to 255 (fully on).
+ */
+void led_panel_set(uint8_t channel, uint8_t brightness);
+
+/**
+ * @brief Returns the brightness last set on a channel, or 0 for an invalid channel.
+ */
+uint8_t led_panel_get(uint8_t channel);
+
+/**
+ * @brief Copies the refresh CPU budget measurements since led_panel_init() or the last
+ * led_panel_reset_stats().
+ * @param out Destination of the measurements. Must not be NULL.
+ */
+void led_panel_get_stats(led_panel_stats_t *out);
+
+/**
+ * @brief Clears the measurements, e.g. after a clock profile change to measure it alone.
+ */
+void led_panel_reset_stats(void);
+
+/**
+ * @brief Writes the measurements as one line on the UART, waiting for room if needed.
+ * @note Must be called after uart_init().
+ */
+void led_panel_report(void);
+
+#endif // LED_PANEL_H
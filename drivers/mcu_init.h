@@ -3,4 +3,4 @@
 
 void mcu_init(void);
 
-#endif // MCU_INIT_H
\ No newline at end of file
+#endif // MCU_INIT_H
@@ -1,73 +1,69 @@
 #include <msp430.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include "millis.h"
+#include "../common/critical.h"
+#include "runloop.h"
+#include "timebase.h"
 
-// Volatile is crucial: tells the compiler that this value can change at any time
-// (e.g., from an interrupt) and prevents incorrect optimizations.
-static volatile uint32_t millis_counter = 0;
+// Longest single delay_until() step. Tick deadlines are compared with signed
+// arithmetic, so a single wait must stay well below 2^31 ticks (~17.9 min).
+#define DELAY_CHUNK_MS 60000UL
 
-// This variable handles the fractional part of a millisecond.
-static volatile uint16_t millis_remainder_us = 0;
+// Set by the timebase alarm once the current delay_until() deadline is reached.
+static volatile bool delay_elapsed = false;
 
 /**
- * @brief Initializes the watchdog timer as a millisecond interval timer.
+ * @brief Timebase alarm callback ending a delay_until(), runs in interrupt context.
  */
-void millis_init(void) {
-    // Stop WDT to prevent reset
-    WDTCTL = WDTPW | WDTHOLD;
-
-    // --- CHANGE 2: Configure WDT Divider for 16MHz Clock ---
-    // We want an interrupt interval close to what we had before.
-    // SMCLK is now 16MHz. We use the /8192 divider.
-    // Interval = 8192 cycles / 16,000,000 cycles/sec = 0.000512 seconds = 512 microseconds.
-    // This gives us the same 512µs tick rate as the 1MHz version.
-    WDTCTL = WDT_MDLY_8;
-
-    // Enable WDT interrupt
-    IE1 |= WDTIE;
+static void delay_alarm_handler(void) {
+    delay_elapsed = true;
+    runloop_wake();
 }
 
 /**
  * @brief Returns the number of milliseconds since program start.
  */
 uint32_t millis(void) {
-    uint32_t ms;
-
-    // Disable interrupts to ensure we get a consistent, multi-byte value.
-    // This prevents the ISR from modifying millis_counter while we are reading it.
-    __disable_interrupt();
-    ms = millis_counter;
-    __enable_interrupt();
+    return timebase_millis();
+}
 
-    return ms;
+/**
+ * @brief Returns the number of microseconds since program start.
+ */
+uint32_t micros(void) {
+    return timebase_micros();
 }
 
 /**
- * @brief Pauses the program for a number of milliseconds (busy-wait).
+ * @brief Pauses the program for a number of milliseconds (low-power sleep).
  */
 void delay_ms(uint32_t ms) {
-    uint32_t start = millis();
-    // Unsigned subtraction handles counter rollover correctly.
-    while (millis() - start < ms);
+    uint32_t deadline = timebase_ticks();
+
+    // Advance the deadline from its previous value so chunks do not drift.
+    while (ms > DELAY_CHUNK_MS) {
+        deadline += TIMEBASE_MS_TO_TICKS(DELAY_CHUNK_MS);
+        delay_until(deadline);
+        ms -= DELAY_CHUNK_MS;
+    }
+    delay_until(deadline + TIMEBASE_MS_TO_TICKS(ms));
 }
 
 /**
- * @brief Watchdog Timer Interrupt Service Routine.
- *
- * This ISR is triggered every 512 microseconds.
- * It accumulates these short intervals to count full milliseconds.
- * NOTE: This logic remains IDENTICAL to the 1MHz version because we
- * adjusted the WDT divider to keep the same 512µs interval.
+ * @brief Pauses the program until a timebase deadline (low-power sleep).
  */
-__attribute__((interrupt(WDT_VECTOR))) void watchdog_timer(void) {
-    // Add the 512 microsecond interval to our remainder accumulator.
-    millis_remainder_us += 512;
+void delay_until(uint32_t deadline) {
+    delay_elapsed = false;
+    // The alarm fires straight away if the deadline has already passed.
+    timebase_alarm_set(TIMEBASE_ALARM_DELAY, deadline, delay_alarm_handler);
 
-    // If we have accumulated at least a full millisecond (1000µs)...
-    if (millis_remainder_us >= 1000) {
-        // ...increment the main millisecond counter...
-        millis_counter++;
-        // ...and subtract exactly one millisecond from the remainder.
-        millis_remainder_us -= 1000;
+    // Any interrupt may wake us up, so re-check the flag after each one. It is
+    // tested with interrupts disabled so the alarm cannot slip in before sleeping.
+    critical_state_t state = critical_enter();
+    while (!delay_elapsed) {
+        runloop_sleep(); // Ends the section; a new one is entered for the next test
+        (void)critical_enter();
     }
+    critical_exit(state);
 }
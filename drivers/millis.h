@@ -3,30 +3,41 @@
 
 #include <stdint.h>
 
-/**
- * @brief Initializes the watchdog timer as a millisecond interval timer.
- * * This function configures the DCO to run at 1MHz and sets up the
- * watchdog timer to generate an interrupt periodically. The interrupt
- * service routine handles the counting of milliseconds.
- * * This must be called once before using millis() or delay_ms().
- * Global interrupts are enabled by this function.
- */
-void millis_init(void);
-
 /**
  * @brief Returns the number of milliseconds since the program started.
  * * This value is returned as an unsigned 32-bit integer. The counter
  * will overflow and wrap back to 0 after approximately 49.7 days.
- * * @return The number of milliseconds since millis_init() was called.
+ * * It is derived from the Timer0_A timebase, so timebase_init() must be
+ * called once before using millis() or delay_ms().
+ * * @return The number of milliseconds since timebase_init() was called.
  */
 uint32_t millis(void);
 
+/**
+ * @brief Returns the number of microseconds since the program started.
+ * * The counter wraps after approximately 71.6 minutes; differences between
+ * two readings stay valid across the wrap. Reading it never masks interrupts,
+ * so it can timestamp pulses or profile code from anywhere, ISRs included.
+ * For 0.5 us resolution, use timebase_ticks() directly.
+ * * @return The number of microseconds since timebase_init() was called.
+ */
+uint32_t micros(void);
+
 /**
  * @brief Pauses the program for the specified number of milliseconds.
- * * This is a busy-wait delay function. It continuously polls the millis()
- * counter until the desired time has elapsed.
+ * * The CPU sleeps in low-power mode between interrupts instead of polling,
+ * using delay_until() for each chunk of the delay.
  * * @param ms The number of milliseconds to delay.
  */
 void delay_ms(uint32_t ms);
 
+/**
+ * @brief Pauses the program until the timebase reaches the given tick count.
+ * * A timebase alarm wakes the CPU at the deadline; other interrupts are
+ * still serviced while waiting. Returns immediately if the deadline has
+ * already passed.
+ * * @param deadline Absolute timebase tick count, see timebase_ticks().
+ */
+void delay_until(uint32_t deadline);
+
 #endif // MILLIS_H
@@ -0,0 +1,192 @@
+/**
+ * @file power.c
+ * @brief Implementation of the residency and supply current accounting.
+ *
+ * The open interval starts at mark_ticks. It is closed at each mode change
+ * and at each clock change, so every interval runs at a single DCO frequency.
+ * Closing an interval runs twice per wake-up, so it only takes 32-bit adds
+ * and shifts: the ticks below a residency unit are carried in a byte per mode.
+ * The accounting is only updated from the run loop, with interrupts disabled
+ * around the shared state.
+ */
+#include "power.h"
+#include <stdbool.h>
+#include "../common/board.h"
+#include "../common/critical.h"
+#include "clock.h"
+#include "timebase.h"
+
+// --- Private Module Constants ---
+
+#define HZ_PER_MHZ 1000000UL
+#define UNIT_FRAC_MASK ((1U << POWER_UNIT_TICKS_LOG2) - 1)
+
+/**
+ * @brief Typical supply currents from the datasheet, in nA (per MHz for the DCO modes), at the
+ * highest datasheet supply not above BOARD_VCC_MV.
+ */
+#if BOARD_VCC_MV >= 3000
+#define ACTIVE_NA_PER_MHZ 330000UL ///< I(AM,1MHz), 3 V
+#define LPM0_NA_PER_MHZ 75000UL ///< I(LPM0,1MHz), 3 V
+#define LPM3_NA 900UL ///< I(LPM3,LFXT1), 3 V
+#else
+#define ACTIVE_NA_PER_MHZ 230000UL ///< I(AM,1MHz), 2.2 V
+#define LPM0_NA_PER_MHZ 56000UL ///< I(LPM0,1MHz), 2.2 V
+#define LPM3_NA 700UL ///< I(LPM3,LFXT1), 2.2 V
+#endif
+
+/**
+ * @brief Current unit of the estimate, and the residency bits it keeps.
+ *
+ * The charge stays within 32 bits: with fewer than 2^12 units in total, the
+ * MHz-weighted units stay below 2^16, and 2^16 times 33000 (330 uA/MHz in
+ * 10 nA) is about 2^31.
+ */
+#define ESTIMATE_UNIT_NA 10
+#define ESTIMATE_TOTAL_BITS 12
+
+// --- Private Module Variables ---
+
+static power_stats_t stats;
+static power_mode_e mode = POWER_MODE_ACTIVE;
+static uint32_t mark_ticks = 0;
+static uint8_t mhz_log2 = 0; ///< log2 of the DCO frequency in MHz. The profiles are powers of two.
+static uint8_t mode_frac[POWER_MODE_CNT]; ///< Ticks not yet making a whole unit.
+static uint8_t mhz_frac[POWER_MODE_CNT]; ///< MHz-weighted ticks not yet making a whole unit.
+static bool is_started = false;
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Adds the open interval to the current mode and starts a new one.
+ * @note Must be called with interrupts disabled.
+ */
+static void close_interval(void)
+{
+    uint32_t now = timebase_ticks();
+    uint32_t ticks = now - mark_ticks;
+    mark_ticks = now;
+
+    uint32_t units = ticks >> POWER_UNIT_TICKS_LOG2;
+    uint8_t frac = (uint8_t)(ticks & UNIT_FRAC_MASK);
+
+    uint16_t sum = mode_frac[mode] + frac;
+    stats.mode_units[mode] += units + (sum >> POWER_UNIT_TICKS_LOG2);
+    mode_frac[mode] = (uint8_t)(sum & UNIT_FRAC_MASK);
+
+    // At most 2^8 + 2^12 for the 16 MHz profile.
+    sum = mhz_frac[mode] + ((uint16_t)frac << mhz_log2);
+    stats.mhz_units[mode] += (units << mhz_log2) + (sum >> POWER_UNIT_TICKS_LOG2);
+    mhz_frac[mode] = (uint8_t)(sum & UNIT_FRAC_MASK);
+}
+
+/**
+ * @brief Clears the counters and the carried fractions.
+ * @note Must be called with interrupts disabled.
+ */
+static void clear_stats(void)
+{
+    stats = (power_stats_t) { 0 };
+    for (uint8_t i = 0; i < POWER_MODE_CNT; i++) {
+        mode_frac[i] = 0;
+        mhz_frac[i] = 0;
+    }
+}
+
+/**
+ * @brief Reads the DCO frequency of the clock profile.
+ */
+static void update_mhz(void)
+{
+    uint32_t hz = clock_smclk_hz();
+    mhz_log2 = 0;
+    while ((HZ_PER_MHZ << mhz_log2) < hz) {
+        mhz_log2++;
+    }
+}
+
+/**
+ * @brief Clock change callback: closes the interval spent at the previous frequency.
+ */
+static void power_clock_changed(void)
+{
+    close_interval();
+    update_mhz();
+}
+
+// --- Public Function Definitions ---
+
+void power_init(void)
+{
+    critical_state_t state = critical_enter();
+    clear_stats();
+    mode = POWER_MODE_ACTIVE;
+    mark_ticks = timebase_ticks();
+    update_mhz();
+    is_started = true;
+    critical_exit(state);
+
+    clock_register(CLOCK_CLIENT_POWER, power_clock_changed);
+}
+
+void power_sleep_begin(power_mode_e sleep_mode)
+{
+    if (!is_started) return;
+
+    close_interval();
+    mode = sleep_mode;
+}
+
+void power_sleep_end(uint8_t vector)
+{
+    if (!is_started) return;
+
+    critical_state_t state = critical_enter();
+    close_interval();
+    mode = POWER_MODE_ACTIVE;
+    stats.wake_cnt[(vector < POWER_WAKE_VECTOR_CNT) ? vector : POWER_WAKE_UNKNOWN]++;
+    critical_exit(state);
+}
+
+void power_get_stats(power_stats_t *out)
+{
+    critical_state_t state = critical_enter();
+    if (is_started) {
+        close_interval();
+    }
+    *out = stats;
+    critical_exit(state);
+}
+
+void power_reset_stats(void)
+{
+    critical_state_t state = critical_enter();
+    clear_stats();
+    mark_ticks = timebase_ticks();
+    critical_exit(state);
+}
+
+uint32_t power_estimate_na(const power_stats_t *counters)
+{
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < POWER_MODE_CNT; i++) {
+        total += counters->mode_units[i];
+    }
+    uint32_t active = counters->mhz_units[POWER_MODE_ACTIVE];
+    uint32_t lpm0 = counters->mhz_units[POWER_MODE_LPM0];
+    uint32_t lpm3 = counters->mode_units[POWER_MODE_LPM3];
+
+    // Only the shares of the modes matter: drop low bits until the products fit in 32 bits.
+    while (total >= (1UL << ESTIMATE_TOTAL_BITS)) {
+        total >>= 1;
+        active >>= 1;
+        lpm0 >>= 1;
+        lpm3 >>= 1;
+    }
+    if (total == 0) return 0;
+
+    // Charge in 10 nA units, rounded to the nearest unit on division.
+    uint32_t charge = active * (ACTIVE_NA_PER_MHZ / ESTIMATE_UNIT_NA)
+        + lpm0 * (LPM0_NA_PER_MHZ / ESTIMATE_UNIT_NA) + lpm3 * (LPM3_NA / ESTIMATE_UNIT_NA);
+    return (charge + total / 2) / total * ESTIMATE_UNIT_NA;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file power.h
+ * @brief Low-power mode residency, wake-up and supply current accounting.
+ *
+ * The run loop reports every sleep entry and wake-up. Each interval is timed
+ * with the timebase and added to the residency of its mode, together with the
+ * DCO frequency it ran at. The counters are cumulative, so builds are compared
+ * by polling power_get_stats() at the start and end of the same scenario.
+ *
+ * power_estimate_na() turns the residencies into an average supply current
+ * with the typical MSP430G2553 figures (SLAS735J, section 5) at 3 V: active
+ * 330 uA/MHz, LPM0 75 uA/MHz, LPM3 with the crystal 0.9 uA. The board runs at
+ * BOARD_VCC_MV, 3.6 V from the LaunchPad emulator, where the real currents
+ * are somewhat higher still; a supply below 3 V selects the 2.2 V figures
+ * (230 uA/MHz, 56 uA/MHz, 0.7 uA) instead. Active and LPM0 currents are
+ * assumed proportional to the DCO frequency. ISRs that run and return to
+ * sleep without waking the run loop count as sleep time.
+ */
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+
+// --- Public Constants ---
+
+#define POWER_UNIT_TICKS_LOG2 8 ///< Residencies count units of 256 timebase ticks (128 us).
+#define POWER_WAKE_VECTOR_CNT 16 ///< Interrupt vectors that can wake the CPU.
+#define POWER_WAKE_UNKNOWN POWER_WAKE_VECTOR_CNT ///< Wake-ups not attributed to a vector.
+#define POWER_WAKE_SOURCE_CNT (POWER_WAKE_VECTOR_CNT + 1)
+
+// --- Public Type Definitions ---
+
+/**
+ * @brief Operating modes used by the run loop.
+ */
+typedef enum {
+    POWER_MODE_ACTIVE,
+    POWER_MODE_LPM0, ///< CPU off; SMCLK on for Timer0_A and the USCIs.
+    POWER_MODE_LPM3, ///< Only ACLK on. Never entered while the timebase holds LPM0.
+    POWER_MODE_CNT,
+} power_mode_e;
+
+/**
+ * @brief Cumulative counters since power_init() or power_reset_stats().
+ *
+ * The residencies wrap after 6.4 days, and the MHz-weighted ones after 9.5
+ * hours at 16 MHz.
+ */
+typedef struct
+{
+    uint32_t mode_units[POWER_MODE_CNT]; ///< Residency per mode, in 2^POWER_UNIT_TICKS_LOG2 ticks.
+    uint32_t mhz_units[POWER_MODE_CNT]; ///< Residency weighted by the DCO frequency in MHz.
+    uint16_t wake_cnt[POWER_WAKE_SOURCE_CNT]; ///< Wake-ups per interrupt vector (wraps).
+} power_stats_t;
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Starts the accounting, in active mode.
+ * @note Must be called after timebase_init().
+ */
+void power_init(void);
+
+/**
+ * @brief Ends the active interval before entering a low-power mode.
+ * @note Called by the run loop, with interrupts disabled.
+ * @param sleep_mode The low-power mode about to be entered.
+ */
+void power_sleep_begin(power_mode_e sleep_mode);
+
+/**
+ * @brief Ends the sleep interval after a wake-up.
+ * @note Called by the run loop.
+ * @param vector The interrupt vector that woke the CPU, or POWER_WAKE_UNKNOWN.
+ */
+void power_sleep_end(uint8_t vector);
+
+/**
+ * @brief Copies the counters, including the active interval in progress.
+ * @param out Destination of the counters. Must not be NULL.
+ */
+void power_get_stats(power_stats_t *out);
+
+/**
+ * @brief Clears the counters.
+ */
+void power_reset_stats(void);
+
+/**
+ * @brief Estimates the average supply current over the counters' residencies.
+ *
+ * Computed in 32 bits from the 12 most significant bits of the total
+ * residency, so within about 0.3 %, in steps of 10 nA.
+ *
+ * @param counters Counters from power_get_stats().
+ * @return The current in nA, or 0 if no time was counted.
+ */
+uint32_t power_estimate_na(const power_stats_t *counters);
+
+#endif // POWER_H
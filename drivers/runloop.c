@@ -0,0 +1,121 @@
+/**
+ * @file runloop.c
+ * @brief Implementation of the event-driven low-power main loop.
+ */
+#include "runloop.h"
+#include <stddef.h>
+#include "../common/critical.h"
+#include "../common/defines.h"
+#include "power.h"
+#include "trace.h"
+
+// --- Private Module Variables ---
+
+volatile bool runloop_wake_requested = false;
+volatile uint8_t runloop_wake_vector = POWER_WAKE_UNKNOWN;
+
+/**
+ * @brief Bitmask of posted events, one bit per runloop_event_e.
+ */
+static volatile uint16_t pending_events = 0;
+
+/**
+ * @brief Number of active holds preventing LPM3.
+ */
+static volatile uint8_t lpm0_holds = 0;
+
+/**
+ * @brief Event handlers, indexed by runloop_event_e.
+ */
+static runloop_handler_t handlers[RUNLOOP_EVENT_CNT];
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Returns the SR bits of the deepest low-power mode currently allowed.
+ */
+static uint16_t allowed_lpm_bits(void)
+{
+    // LPM3 keeps only ACLK running; LPM0 also keeps SMCLK for the timers using it.
+    return (lpm0_holds > 0) ? LPM0_bits : LPM3_bits;
+}
+
+// --- Public Function Definitions ---
+
+void runloop_register(runloop_event_e event, runloop_handler_t handler)
+{
+    if (event >= RUNLOOP_EVENT_CNT) return;
+
+    handlers[event] = handler;
+}
+
+void runloop_post(runloop_event_e event)
+{
+    if (event >= RUNLOOP_EVENT_CNT) return;
+
+    critical_state_t state = critical_enter();
+    pending_events |= (1u << event);
+    runloop_wake_requested = true;
+    critical_exit(state);
+}
+
+void runloop_wake(void)
+{
+    runloop_wake_requested = true;
+}
+
+void runloop_hold_lpm0(void)
+{
+    critical_state_t state = critical_enter();
+    lpm0_holds++;
+    critical_exit(state);
+}
+
+void runloop_release_lpm0(void)
+{
+    critical_state_t state = critical_enter();
+    if (lpm0_holds > 0) {
+        lpm0_holds--;
+    }
+    critical_exit(state);
+}
+
+void runloop_sleep(void)
+{
+    uint16_t lpm_bits = allowed_lpm_bits();
+    TRACE(TRACE_EVENT_SLEEP, (lpm_bits == LPM0_bits) ? 0 : 3);
+    power_sleep_begin((lpm_bits == LPM0_bits) ? POWER_MODE_LPM0 : POWER_MODE_LPM3);
+    runloop_wake_vector = POWER_WAKE_UNKNOWN;
+
+    // Setting GIE and the LPM bits in one instruction guarantees that an
+    // interrupt arriving after this point still wakes the CPU back up.
+    critical_exit_and_sleep(lpm_bits);
+
+    power_sleep_end(runloop_wake_vector);
+}
+
+void runloop_run(void)
+{
+    while (1) {
+        trace_drain();
+
+        // --- Critical Section: take the posted events or go to sleep atomically ---
+        critical_state_t state = critical_enter();
+        uint16_t events = pending_events;
+        pending_events = 0;
+        if (events == 0) {
+            runloop_sleep(); // Re-enables interrupts while entering low-power mode
+            continue;
+        }
+        critical_exit(state);
+        // --- End Critical Section ---
+
+        for (uint8_t i = 0; i < ARRAY_SIZE(handlers); i++) {
+            if ((events & (1u << i)) && handlers[i] != NULL) {
+                TRACE(TRACE_EVENT_TASK_BEGIN, i);
+                handlers[i]();
+                TRACE(TRACE_EVENT_TASK_END, i);
+            }
+        }
+    }
+}
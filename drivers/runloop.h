@@ -0,0 +1,120 @@
+/**
+ * @file runloop.h
+ * @brief Event-driven main loop that sleeps in a low-power mode between events.
+ *
+ * Interrupt handlers post events with runloop_post(). The loop runs the
+ * handler registered for each posted event, then enters the deepest low-power
+ * mode allowed by the active clock users until the next interrupt wakes it.
+ *
+ * With the current drivers that mode is always LPM0: Timer0_A counts SMCLK,
+ * so timebase_init() takes a permanent LPM0 hold and LPM3 is never entered.
+ * The LPM3 path only comes into use if the timebase moves to ACLK.
+ */
+#ifndef RUNLOOP_H
+#define RUNLOOP_H
+
+#include <msp430.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// --- Public Type Definitions ---
+
+/**
+ * @brief Events that can be posted to the run loop, one per handler.
+ */
+typedef enum {
+    RUNLOOP_EVENT_LED, ///< An LED toggle deadline is due.
+    RUNLOOP_EVENT_INPUT, ///< A debounced input changed state.
+    RUNLOOP_EVENT_UART_RX, ///< Bytes were received on the UART.
+    RUNLOOP_EVENT_I2C, ///< An I2C transfer timed out.
+    RUNLOOP_EVENT_ADC, ///< The ADC10 filled a block of conversions.
+    RUNLOOP_EVENT_APP, ///< Application-defined event.
+    RUNLOOP_EVENT_CNT,
+} runloop_event_e;
+
+/**
+ * @brief Event handler, executed from the run loop with interrupts enabled.
+ */
+typedef void (*runloop_handler_t)(void);
+
+// --- Public Variables ---
+
+/**
+ * @brief Set when an ISR wants the CPU to stay awake after it returns.
+ * @note Only accessed through runloop_wake() and RUNLOOP_ISR_EXIT().
+ */
+extern volatile bool runloop_wake_requested;
+
+/**
+ * @brief Interrupt vector of the ISR that last woke the CPU, for the power accounting.
+ * @note Only written by RUNLOOP_ISR_EXIT() and runloop_sleep().
+ */
+extern volatile uint8_t runloop_wake_vector;
+
+// --- Public Macros ---
+
+/**
+ * @brief Leaves low-power mode on ISR return if an event or wake-up was requested.
+ *
+ * __bic_SR_register_on_exit() modifies the SR saved on the ISR's own stack
+ * frame, so this must be placed at the end of the interrupt function itself,
+ * not in a function it calls.
+ *
+ * @param vector The interrupt vector of the ISR, counted as the wake-up source.
+ */
+#define RUNLOOP_ISR_EXIT(vector)                                                                   \
+    do {                                                                                           \
+        if (runloop_wake_requested) {                                                              \
+            runloop_wake_requested = false;                                                        \
+            runloop_wake_vector = (vector);                                                        \
+            __bic_SR_register_on_exit(LPM4_bits);                                                  \
+        }                                                                                          \
+    } while (0)
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Registers the handler run when an event is posted.
+ * @param event The event to handle.
+ * @param handler The function to run from the loop, or NULL to ignore the event.
+ */
+void runloop_register(runloop_event_e event, runloop_handler_t handler);
+
+/**
+ * @brief Posts an event and requests a wake-up. Safe to call from an ISR.
+ * @param event The event to post.
+ */
+void runloop_post(runloop_event_e event);
+
+/**
+ * @brief Requests that the CPU leaves low-power mode without posting an event.
+ * @note Safe to call from an ISR.
+ */
+void runloop_wake(void);
+
+/**
+ * @brief Prevents the loop from entering LPM3 because SMCLK is in use.
+ *
+ * Holds are counted; LPM3 is allowed again once every hold has been released,
+ * which the permanent hold of the timebase currently prevents.
+ */
+void runloop_hold_lpm0(void);
+
+/**
+ * @brief Releases a hold taken with runloop_hold_lpm0().
+ */
+void runloop_release_lpm0(void);
+
+/**
+ * @brief Enters the deepest allowed low-power mode until an ISR requests a wake-up.
+ *
+ * Used by blocking waits that need to re-check a condition after each interrupt.
+ */
+void runloop_sleep(void);
+
+/**
+ * @brief Runs posted event handlers and sleeps between them. Never returns.
+ */
+void runloop_run(void);
+
+#endif // RUNLOOP_H
@@ -0,0 +1,552 @@
+/**
+ * @file timebase.c
+ * @brief Implementation of the tickless Timer0_A timebase.
+ *
+ * The 16-bit hardware counter provides the ticks elapsed in the current
+ * counter period, and the tick count at the start of that period is kept in
+ * software, advanced by the TAIFG interrupt. CCR0 is only enabled when the
+ * earliest alarm deadline falls within the next counter period; otherwise the
+ * overflow ISR arms it once the deadline comes into range.
+ *
+ * Each counter count is 2^tick_shift ticks: 1 tick, or 2 ticks in the 1 MHz
+ * clock profile. A clock change ends the current period early, folding the
+ * counter into the software state, and restarts the counter with the new
+ * divider.
+ */
+#include "timebase.h"
+#include <msp430.h>
+#include <stddef.h>
+#include "../common/critical.h"
+#include "../common/defines.h"
+#include "clock.h"
+#include "isr_profile.h"
+#include "runloop.h"
+#include "trace.h"
+
+// --- Private Module Constants ---
+
+#define TIMER_PERIOD_COUNTS 0x10000UL ///< Counts per full 16-bit counter period.
+#define TICKS_PER_US (1u << TIMEBASE_TICKS_PER_US_LOG2)
+#define PERIODIC_MARGIN_COUNTS 16 ///< Lead of a late periodic compare, 16 cycles at the slowest.
+
+// --- Private Structure Definition ---
+
+/**
+ * @brief State of a single alarm slot.
+ */
+struct timebase_alarm_s
+{
+    uint32_t deadline; ///< Absolute tick count at which the alarm fires.
+    timebase_alarm_cb_t callback; ///< Function called when the deadline is reached.
+    bool is_armed; ///< Flag indicating if the slot holds a pending deadline.
+};
+
+// --- Private Module Variables ---
+
+/**
+ * @brief Number of counter periods started: overflows, plus restarts on clock changes.
+ *
+ * Only written with interrupts disabled, together with the period state below.
+ * Readers use it as a sequence number: if it changed while they read the
+ * timebase state, they read again.
+ */
+static volatile uint16_t period_cnt = 0;
+
+/**
+ * @brief Tick count at the start of the current counter period.
+ */
+static volatile uint32_t ticks_at_period = 0;
+
+/**
+ * @brief Microseconds elapsed up to the start of the current period, rounded down.
+ *
+ * The ticks below the microsecond are the low bits of ticks_at_period.
+ */
+static volatile uint32_t micros_at_period = 0;
+
+/**
+ * @brief Milliseconds elapsed up to the start of the current period.
+ */
+static volatile uint32_t millis_at_period = 0;
+
+/**
+ * @brief Ticks elapsed since millis_at_period that do not yet make a full millisecond.
+ */
+static volatile uint16_t millis_remainder_ticks = 0;
+
+/**
+ * @brief log2 of the ticks per counter count, set from the clock profile.
+ *
+ * Only changes on a clock change, which never interrupts a reader.
+ */
+static uint8_t tick_shift = 0;
+
+/**
+ * @brief Whole milliseconds and leftover ticks in a full counter period, for tick_shift.
+ */
+static uint16_t period_ms = 0;
+static uint16_t period_remainder_ticks = 0;
+
+/**
+ * @brief Alarm slots, indexed by timebase_alarm_e.
+ */
+static volatile struct timebase_alarm_s alarms[TIMEBASE_ALARM_CNT];
+
+/**
+ * @brief Earliest pending alarm deadline, valid when next_deadline_pending is set.
+ */
+static volatile uint32_t next_deadline = 0;
+static volatile bool next_deadline_pending = false;
+
+/**
+ * @brief Callback of the CCR1 periodic channel, or NULL when stopped.
+ */
+static volatile timebase_periodic_cb_t periodic_callback = NULL;
+
+/**
+ * @brief Periodic calls re-armed late because the compare fell behind the counter (wraps).
+ */
+static volatile uint16_t periodic_miss_cnt = 0;
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Returns the ticks in a full counter period.
+ */
+static inline uint32_t period_ticks(void)
+{
+    return TIMER_PERIOD_COUNTS << tick_shift;
+}
+
+/**
+ * @brief Converts a tick interval to counter counts, rounding down but to at least 1.
+ */
+static inline uint16_t ticks_to_counts(uint16_t ticks)
+{
+    uint16_t counts = ticks >> tick_shift;
+    return (counts > 0) ? counts : 1;
+}
+
+/**
+ * @brief Re-arms the periodic compare just ahead of the counter if the counter already passed it.
+ *
+ * A compare value behind the counter would only match after the counter
+ * wraps. If the match was caught anyway, the pending CCIFG is kept instead.
+ *
+ * @param counts Counts from the previous compare, or from the start, to TA0CCR1.
+ * @note Must be called with interrupts disabled.
+ */
+static void catch_late_periodic(uint16_t counts)
+{
+    if ((uint16_t)(TA0CCR1 - TA0R - 1) >= counts && !(TA0CCTL1 & CCIFG)) {
+        TA0CCR1 = TA0R + PERIODIC_MARGIN_COUNTS;
+        periodic_miss_cnt++;
+    }
+}
+
+/**
+ * @brief Reads the counter and the tick count at the start of its period, without locking.
+ *
+ * The period count is read again after the counter and the read is retried
+ * if the overflow ISR ran in between. An overflow that has happened but is not
+ * serviced yet (interrupts disabled, or another ISR running) is detected from
+ * TAIFG, and only counted if the counter value read is from after the wrap.
+ * Timer0_A runs from SMCLK, synchronous with MCLK, so a single TA0R read is exact.
+ *
+ * @param period_start Receives the tick count at the start of the counter's period.
+ * @return The counter value.
+ */
+static uint16_t read_counter(uint32_t *period_start)
+{
+    uint16_t before;
+    uint32_t start;
+    uint16_t low;
+    bool is_pending;
+
+    do {
+        before = period_cnt;
+        start = ticks_at_period;
+        low = TA0R;
+        is_pending = (TA0CTL & TAIFG) && (low < 0x8000u);
+    } while (period_cnt != before);
+
+    *period_start = start + (is_pending ? period_ticks() : 0);
+    return low;
+}
+
+/**
+ * @brief Reads the 32-bit tick count. Safe in any context.
+ */
+static uint32_t read_ticks(void)
+{
+    uint32_t start;
+    uint16_t low = read_counter(&start);
+    return start + ((uint32_t)low << tick_shift);
+}
+
+/**
+ * @brief Starts a new counter period that began a number of ticks ago.
+ * @note Must be called with interrupts disabled.
+ */
+static void start_period(uint32_t ticks)
+{
+    period_cnt++;
+
+    uint32_t sub_us_ticks = ticks_at_period & (TICKS_PER_US - 1);
+    micros_at_period += (sub_us_ticks + ticks) >> TIMEBASE_TICKS_PER_US_LOG2;
+    ticks_at_period += ticks;
+
+    // Carry the sub-millisecond remainder so millis() never drifts.
+    if (ticks == period_ticks()) {
+        millis_at_period += period_ms;
+        millis_remainder_ticks += period_remainder_ticks;
+    } else {
+        uint16_t remainder_ticks;
+        millis_at_period += fixed_divmod2000_u24(ticks, &remainder_ticks);
+        millis_remainder_ticks += remainder_ticks;
+    }
+    if (millis_remainder_ticks >= TIMEBASE_TICKS_PER_MS) {
+        millis_at_period++;
+        millis_remainder_ticks -= TIMEBASE_TICKS_PER_MS;
+    }
+}
+
+/**
+ * @brief Enables CCR0 if the next deadline falls within the current counter period.
+ * @note Must be called with interrupts disabled.
+ */
+static void arm_compare(void)
+{
+    if (!next_deadline_pending) {
+        TA0CCTL0 = 0;
+        return;
+    }
+
+    uint32_t now = read_ticks();
+    if (next_deadline - now >= period_ticks()) {
+        // Either far in the future (the overflow ISR arms it later) or already due.
+        if (!timebase_reached(now, next_deadline)) {
+            TA0CCTL0 = 0;
+            return;
+        }
+    }
+
+    // Round up to the first count at or past the deadline. A period is a
+    // whole number of counts, so this also holds if an overflow is pending.
+    uint32_t ticks = next_deadline - ticks_at_period + (1u << tick_shift) - 1;
+    TA0CCR0 = (uint16_t)(ticks >> tick_shift);
+    TA0CCTL0 = CCIE;
+
+    // The counter may have passed the compare value while it was being written.
+    if (timebase_reached(read_ticks(), next_deadline)) {
+        TA0CCTL0 |= CCIFG;
+    }
+}
+
+/**
+ * @brief Recomputes the earliest pending deadline and re-arms the compare.
+ * @note Must be called with interrupts disabled.
+ */
+static void reschedule(void)
+{
+    uint32_t now = read_ticks();
+    bool pending = false;
+    uint32_t earliest = 0;
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(alarms); i++) {
+        if (alarms[i].is_armed) {
+            if (!pending || (int32_t)(alarms[i].deadline - now) < (int32_t)(earliest - now)) {
+                earliest = alarms[i].deadline;
+                pending = true;
+            }
+        }
+    }
+
+    next_deadline = earliest;
+    next_deadline_pending = pending;
+    arm_compare();
+}
+
+/**
+ * @brief Starts the counter with the divider giving the tick rate, or the nearest below it.
+ */
+static void start_counter(void)
+{
+    uint8_t div_log2 = clock_smclk_div_log2(TIMEBASE_TICK_HZ);
+    uint32_t counts_hz = clock_smclk_hz() >> div_log2;
+
+    tick_shift = 0;
+    while ((counts_hz << tick_shift) < TIMEBASE_TICK_HZ) {
+        tick_shift++;
+    }
+    period_ms = (uint16_t)fixed_divmod2000_u24(period_ticks(), &period_remainder_ticks);
+
+    /*
+     * Configure Timer0_A as a free-running 16-bit counter:
+     * - TASSEL_2: SMCLK as clock source.
+     * - ID_x: divided down to the 2 MHz tick (0.5 us resolution), or
+     *   undivided at 1 MHz in the 1 MHz profile (one count every 2 ticks).
+     * - MC_2: continuous mode, counting 0x0000 -> 0xFFFF and wrapping.
+     * - TAIE: interrupt on each overflow to advance the period state in software.
+     */
+    TA0CTL = TASSEL_2 | CLOCK_TIMER_ID(div_log2) | MC_2 | TACLR | TAIE;
+}
+
+/**
+ * @brief Clock change callback: restarts the counter at the new rate without losing time.
+ *
+ * The counts since the start of the period are folded into the software
+ * state, then the counter restarts from zero. Only the few cycles between the
+ * DCO switch and this callback are counted at the wrong rate.
+ */
+static void timebase_clock_changed(void)
+{
+    TA0CTL &= ~MC_3; // Stop the counter; TAIFG and the compares are kept.
+
+    if (TA0CTL & TAIFG) {
+        TRACE(TRACE_EVENT_TIMER_WRAP, 0);
+        start_period(period_ticks());
+        TA0CTL &= ~TAIFG;
+    }
+    uint16_t low = TA0R;
+    start_period((uint32_t)low << tick_shift);
+
+    // Carry the time left until the next periodic call over to the new rate.
+    uint32_t periodic_ticks = 0;
+    bool is_periodic = (TA0CCTL1 & CCIE) && !(TA0CCTL1 & CCIFG);
+    if (is_periodic) {
+        periodic_ticks = (uint32_t)(uint16_t)(TA0CCR1 - low) << tick_shift;
+    }
+
+    TRACE(TRACE_EVENT_CLOCK, clock_get_profile());
+    start_counter();
+    critical_restart_window();
+
+    if (is_periodic) {
+        uint32_t counts = periodic_ticks >> tick_shift;
+        TA0CCR1 = (counts == 0) ? 1 : (counts > 0xFFFFu) ? 0xFFFFu : (uint16_t)counts;
+    } else {
+        // Stopped, or a call is already pending: the ISR then reloads from the period start.
+        TA0CCR1 = 0;
+    }
+    reschedule();
+}
+
+// --- Public Function Definitions ---
+
+void timebase_init(void)
+{
+    TA0CCTL0 = 0;
+    start_counter();
+    clock_register(CLOCK_CLIENT_TIMEBASE, timebase_clock_changed);
+
+    // Timer0_A stops with SMCLK, so the CPU must not sleep deeper than LPM0.
+    runloop_hold_lpm0();
+}
+
+uint32_t timebase_ticks(void)
+{
+    return read_ticks();
+}
+
+uint32_t timebase_micros(void)
+{
+    uint16_t before;
+    uint32_t us;
+    uint32_t start;
+    uint16_t low;
+    bool is_pending;
+
+    // Same retry scheme as read_counter().
+    do {
+        before = period_cnt;
+        us = micros_at_period;
+        start = ticks_at_period;
+        low = TA0R;
+        is_pending = (TA0CTL & TAIFG) && (low < 0x8000u);
+    } while (period_cnt != before);
+
+    if (is_pending) {
+        // Overflow pending but not yet serviced: a whole period is a whole number of us.
+        us += period_ticks() >> TIMEBASE_TICKS_PER_US_LOG2;
+    }
+    uint32_t ticks = (start & (TICKS_PER_US - 1)) + ((uint32_t)low << tick_shift);
+    return us + (ticks >> TIMEBASE_TICKS_PER_US_LOG2);
+}
+
+uint32_t timebase_millis(void)
+{
+    uint16_t before;
+    uint32_t ms;
+    uint32_t ticks;
+    uint16_t low;
+    bool is_pending;
+
+    // Same retry scheme as read_counter(): the overflow ISR updates the
+    // millisecond state and period_cnt together, so a changed period_cnt
+    // means the snapshot may be torn.
+    do {
+        before = period_cnt;
+        ms = millis_at_period;
+        ticks = millis_remainder_ticks;
+        low = TA0R;
+        is_pending = (TA0CTL & TAIFG) && (low < 0x8000u);
+    } while (period_cnt != before);
+
+    if (is_pending) {
+        // Overflow pending but not yet serviced: account for it here.
+        ms += period_ms;
+        ticks += period_remainder_ticks;
+    }
+    ticks += (uint32_t)low << tick_shift;
+    uint16_t remainder_ticks;
+    return ms + fixed_divmod2000_u24(ticks, &remainder_ticks);
+}
+
+uint32_t timebase_capture_ticks(uint16_t count)
+{
+    uint32_t start;
+    uint16_t low = read_counter(&start);
+    uint16_t elapsed = low - count;
+
+    return start + ((uint32_t)low << tick_shift) - ((uint32_t)elapsed << tick_shift);
+}
+
+void timebase_alarm_set(timebase_alarm_e alarm, uint32_t deadline, timebase_alarm_cb_t callback)
+{
+    if (alarm >= TIMEBASE_ALARM_CNT) return;
+
+    critical_state_t state = critical_enter();
+    alarms[alarm].deadline = deadline;
+    alarms[alarm].callback = callback;
+    alarms[alarm].is_armed = true;
+    reschedule();
+    critical_exit(state);
+}
+
+void timebase_alarm_cancel(timebase_alarm_e alarm)
+{
+    if (alarm >= TIMEBASE_ALARM_CNT) return;
+
+    critical_state_t state = critical_enter();
+    alarms[alarm].is_armed = false;
+    reschedule();
+    critical_exit(state);
+}
+
+void timebase_periodic_start(uint16_t delay, timebase_periodic_cb_t callback)
+{
+    critical_state_t state = critical_enter();
+    periodic_callback = callback;
+    uint16_t counts = ticks_to_counts(delay);
+    TA0CCTL1 = 0;
+    TA0CCR1 = TA0R + counts;
+    TA0CCTL1 = CCIE;
+    catch_late_periodic(counts);
+    critical_exit(state);
+}
+
+void timebase_periodic_set_trigger(bool is_enabled)
+{
+    critical_state_t state = critical_enter();
+    if (is_enabled) {
+        TA0CCTL1 |= OUTMOD_1; // Set at the compare
+    } else {
+        TA0CCTL1 &= ~OUTMOD_7; // OUTMOD_0 with OUT clear: low
+    }
+    critical_exit(state);
+}
+
+uint16_t timebase_periodic_misses(void)
+{
+    return periodic_miss_cnt;
+}
+
+void timebase_periodic_stop(void)
+{
+    critical_state_t state = critical_enter();
+    TA0CCTL1 = 0;
+    periodic_callback = NULL;
+    critical_exit(state);
+}
+
+// --- Interrupt Service Routines ---
+
+/**
+ * @brief Timer0_A CCR0 ISR, fired when the earliest alarm deadline is reached.
+ *
+ * Runs every due callback, then re-arms the compare for the next deadline.
+ * Callbacks may re-arm their own slot through timebase_alarm_set().
+ */
+INTERRUPT_VECTOR(TIMER0_A0_VECTOR)
+void timebase_compare_isr(void)
+{
+    ISR_PROFILE_ENTER();
+    TRACE(TRACE_EVENT_ISR_BEGIN, TIMER0_A0_VECTOR);
+    ISR_PROFILE_LATENCY(TA0CCR0);
+    TA0CCTL0 = 0;
+
+    uint32_t now = read_ticks();
+    for (uint8_t i = 0; i < ARRAY_SIZE(alarms); i++) {
+        if (alarms[i].is_armed && timebase_reached(now, alarms[i].deadline)) {
+            alarms[i].is_armed = false;
+            if (alarms[i].callback != NULL) {
+                alarms[i].callback();
+            }
+        }
+    }
+
+    reschedule();
+
+    TRACE(TRACE_EVENT_ISR_END, TIMER0_A0_VECTOR);
+    ISR_PROFILE_EXIT(ISR_PROFILE_TIMER0_A0);
+    RUNLOOP_ISR_EXIT(TIMER0_A0_VECTOR);
+}
+
+/**
+ * @brief Timer0_A CCR1/overflow ISR.
+ *
+ * Runs the CCR1 periodic channel and, on overflow, advances the period state.
+ */
+INTERRUPT_VECTOR(TIMER0_A1_VECTOR)
+void timebase_overflow_isr(void)
+{
+    ISR_PROFILE_ENTER();
+    TRACE(TRACE_EVENT_ISR_BEGIN, TIMER0_A1_VECTOR);
+    switch (TA0IV) {
+    case TA0IV_TACCR1: {
+        ISR_PROFILE_LATENCY(TA0CCR1);
+        if (TA0CCTL1 & OUTMOD_1) {
+            // Trigger output: back low through OUTMOD_0, so the next compare raises it again.
+            TA0CCTL1 = CCIE;
+            TA0CCTL1 = CCIE | OUTMOD_1;
+        }
+        timebase_periodic_cb_t callback = periodic_callback;
+        uint16_t interval = (callback != NULL) ? callback() : 0;
+        if (interval != 0) {
+            // Advance from the previous compare value so intervals do not drift.
+            uint16_t counts = ticks_to_counts(interval);
+            TA0CCR1 += counts;
+            catch_late_periodic(counts);
+        } else {
+            TA0CCTL1 = 0;
+        }
+        break;
+    }
+    case TA0IV_TAIFG:
+        ISR_PROFILE_LATENCY(0); // The counter overflowed to 0
+        TRACE(TRACE_EVENT_TIMER_WRAP, 0);
+        start_period(period_ticks());
+
+        // A deadline further than one counter period away may now be in range.
+        if (next_deadline_pending && !(TA0CCTL0 & CCIE)) {
+            arm_compare();
+        }
+        break;
+    default:
+        break;
+    }
+    TRACE(TRACE_EVENT_ISR_END, TIMER0_A1_VECTOR);
+    ISR_PROFILE_EXIT(ISR_PROFILE_TIMER0_A1);
+    TRACE_ISR_EXIT();
+}
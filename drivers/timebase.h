@@ -0,0 +1,194 @@
+/**
+ * @file timebase.h
+ * @brief Tickless system timebase built on Timer0_A.
+ *
+ * Timer0_A runs in continuous mode and is extended to 32 bits in software by
+ * counting counter overflows. Instead of a periodic tick, CCR0 is armed with
+ * the earliest pending alarm deadline, so the CPU is only interrupted when
+ * something is actually due (plus one overflow interrupt every 32.768 ms).
+ *
+ * Ticks are 0.5 us in every clock profile: the timebase follows clock changes
+ * and keeps counting time across them. In the 1 MHz profile the counter
+ * advances by 2 ticks at a time and overflows every 65.536 ms.
+ */
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../common/fixed.h"
+
+// --- Public Constants ---
+
+#define TIMEBASE_TICK_HZ 2000000UL ///< Same in every clock profile.
+#define TIMEBASE_TICKS_PER_MS (TIMEBASE_TICK_HZ / 1000UL) ///< 2000 ticks
+#define TIMEBASE_TICKS_PER_US_LOG2 1 ///< 2 ticks per microsecond
+
+_Static_assert(TIMEBASE_TICK_HZ == (1000000UL << TIMEBASE_TICKS_PER_US_LOG2),
+    "timebase_micros() needs a power-of-two number of ticks per microsecond");
+_Static_assert(TIMEBASE_TICKS_PER_MS == 2000, "The millisecond conversions use the x2000 kernels");
+
+/**
+ * @brief Converts a duration in milliseconds to timebase ticks.
+ *
+ * Constants fold at compile time (static initializers included), other
+ * durations go through the shift-add kernel instead of a libgcc multiplication.
+ */
+#define TIMEBASE_MS_TO_TICKS(ms)                                                                   \
+    (__builtin_constant_p(ms) ? (uint32_t)(ms) * TIMEBASE_TICKS_PER_MS                            \
+                              : fixed_mul2000_u32((uint32_t)(ms)))
+
+// --- Public Type Definitions ---
+
+/**
+ * @brief Alarm slots available on the timebase, one per client module.
+ *
+ * Each slot holds at most one pending deadline. The timebase keeps the
+ * hardware compare armed for the earliest of them.
+ */
+typedef enum {
+    TIMEBASE_ALARM_LED, ///< Next LED toggle.
+    TIMEBASE_ALARM_DELAY, ///< End of a sleeping delay_until().
+    TIMEBASE_ALARM_DEBOUNCE, ///< Next input debouncer sample.
+    TIMEBASE_ALARM_I2C, ///< Timeout of the I2C transfer in progress.
+    TIMEBASE_ALARM_APP, ///< Application-defined deadline.
+    TIMEBASE_ALARM_CNT,
+} timebase_alarm_e;
+
+/**
+ * @brief Alarm callback, executed in interrupt context when the deadline is reached.
+ *
+ * Callbacks should only post run loop events; the CPU is woken up on ISR exit
+ * when one was posted.
+ */
+typedef void (*timebase_alarm_cb_t)(void);
+
+/**
+ * @brief Periodic channel callback, executed in interrupt context.
+ * @return Ticks until the next call (1 to 65535), or 0 to stop the channel.
+ */
+typedef uint16_t (*timebase_periodic_cb_t)(void);
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Starts Timer0_A as a free-running counter clocked from SMCLK, divided down to the tick.
+ *
+ * SMCLK must keep running for the counter to advance, so this takes a
+ * permanent LPM0 hold on the run loop.
+ *
+ * @note Must be called once after mcu_init() and before any other timebase function.
+ */
+void timebase_init(void);
+
+/**
+ * @brief Returns the current 32-bit tick count, a 0.5 us resolution timestamp.
+ *
+ * The counter wraps after 2^32 ticks (about 35.8 minutes at 2 MHz). Use
+ * timebase_reached() to compare tick values so that the wrap is handled.
+ *
+ * @note Lock-free: never masks interrupts, and is safe to call from an ISR.
+ * @return The number of ticks since timebase_init() was called.
+ */
+uint32_t timebase_ticks(void);
+
+/**
+ * @brief Returns the number of microseconds since timebase_init() was called.
+ *
+ * The count wraps after 2^32 us (about 71.6 minutes), so the difference of
+ * two readings is valid across the wrap.
+ *
+ * @note Lock-free: never masks interrupts, and is safe to call from an ISR.
+ */
+uint32_t timebase_micros(void);
+
+/**
+ * @brief Returns the number of milliseconds since timebase_init() was called.
+ *
+ * The millisecond count is tracked separately from the tick count and only
+ * wraps after approximately 49.7 days.
+ *
+ * @note Lock-free: never masks interrupts, and is safe to call from an ISR.
+ */
+uint32_t timebase_millis(void);
+
+/**
+ * @brief Converts a Timer0_A capture (CCR2 or CCR0 in capture mode) into a tick count.
+ *
+ * The capture must be less than one counter period old (32.768 ms, or
+ * 65.536 ms in the 1 MHz profile), and from after the last clock change.
+ *
+ * @note Lock-free: never masks interrupts, and is safe to call from an ISR.
+ * @param count The captured counter value.
+ * @return The tick count at which the capture happened.
+ */
+uint32_t timebase_capture_ticks(uint16_t count);
+
+/**
+ * @brief Arms an alarm slot, replacing any deadline it already held.
+ * @note Safe to call from an ISR, including from an alarm callback.
+ * @param alarm The alarm slot to arm.
+ * @param deadline Absolute tick count at which the callback must run.
+ * @param callback Function called from the timer ISR once the deadline is reached.
+ */
+void timebase_alarm_set(timebase_alarm_e alarm, uint32_t deadline, timebase_alarm_cb_t callback);
+
+/**
+ * @brief Disarms an alarm slot. Does nothing if the slot is not armed.
+ * @param alarm The alarm slot to disarm.
+ */
+void timebase_alarm_cancel(timebase_alarm_e alarm);
+
+/**
+ * @brief Starts the fast periodic channel on CCR1.
+ *
+ * Unlike alarms, the channel reloads CCR1 directly from the ISR by the
+ * interval returned by the callback, so short and variable intervals
+ * (down to a few tens of microseconds) are kept exactly, without drift.
+ * Only one user can own the channel at a time. In the 1 MHz clock profile,
+ * intervals are rounded down to an even number of ticks.
+ *
+ * A call that ends after the next compare value would leave the compare
+ * behind the counter for a whole counter period. The ISR detects it, re-arms
+ * the compare a few counts ahead and counts a miss instead.
+ *
+ * @param delay Ticks until the first call.
+ * @param callback Function returning the interval to the following call.
+ */
+void timebase_periodic_start(uint16_t delay, timebase_periodic_cb_t callback);
+
+/**
+ * @brief Raises TA0.1 (OUT1) at each compare of the periodic channel, as a hardware trigger.
+ *
+ * The output rises exactly at the compare, so a peripheral triggered by its
+ * rising edge (the ADC10 with SHS_1) starts without the interrupt latency.
+ * The ISR lowers it again before the next compare.
+ *
+ * @note Must be called after timebase_periodic_start(), which clears the setting.
+ * @param is_enabled true to pulse the output, false to hold it low.
+ */
+void timebase_periodic_set_trigger(bool is_enabled);
+
+/**
+ * @brief Returns the number of periodic calls that came late because the previous one
+ * overran its interval (wraps).
+ */
+uint16_t timebase_periodic_misses(void);
+
+/**
+ * @brief Stops the fast periodic channel.
+ */
+void timebase_periodic_stop(void);
+
+/**
+ * @brief Checks whether a deadline has been reached, handling counter wrap.
+ * @param now The current tick count.
+ * @param deadline The deadline to check.
+ * @return true if @p now is at or past @p deadline.
+ */
+static inline bool timebase_reached(uint32_t now, uint32_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+#endif // TIMEBASE_H
@@ -0,0 +1,113 @@
+/**
+ * @file trace.c
+ * @brief Implementation of the trace ring draining.
+ *
+ * TRACE() only advances trace_head and trace_drain() only advances
+ * trace_tail, so records are copied out without blocking interrupts.
+ */
+#include "trace.h"
+
+#if TRACE_ENABLE
+
+#include <stdbool.h>
+#include <string.h>
+#include "clock.h"
+#include "uart.h"
+
+_Static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0 && TRACE_RING_SIZE <= 128,
+    "TRACE_RING_SIZE must be a power of two up to 128");
+
+// --- Private Module Constants ---
+
+#define RING_MASK (TRACE_RING_SIZE - 1)
+#define HEADER_BYTES 1
+#define FRAME_OVERHEAD 3 ///< Two 0x00 delimiters and the first COBS code byte.
+
+/**
+ * @brief Records per packet, so a framed packet fits in the UART copy buffer.
+ *
+ * Payloads shorter than 254 bytes need no COBS code byte beyond one per zero.
+ */
+#define PACKET_RECORDS_MAX ((UART_TX_RING_SIZE - FRAME_OVERHEAD - HEADER_BYTES) / sizeof(trace_record_t))
+#define PAYLOAD_MAX (HEADER_BYTES + PACKET_RECORDS_MAX * sizeof(trace_record_t))
+
+// --- Private Module Variables ---
+
+trace_record_t trace_ring[TRACE_RING_SIZE];
+volatile uint8_t trace_head = 0;
+volatile uint8_t trace_tail = 0;
+volatile uint8_t trace_dropped = 0;
+
+static bool is_started = false;
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief COBS-encodes a payload of less than 254 bytes between two 0x00 delimiters.
+ * @return The number of bytes written to frame: len + FRAME_OVERHEAD.
+ */
+static uint16_t frame_packet(const uint8_t *payload, uint16_t len, uint8_t *frame)
+{
+    uint16_t n = 0;
+    frame[n++] = 0;
+
+    // Each zero is replaced by the distance to the next one, or to the end.
+    uint16_t code_idx = n++;
+    for (uint16_t i = 0; i < len; i++) {
+        if (payload[i] == 0) {
+            frame[code_idx] = (uint8_t)(n - code_idx);
+            code_idx = n++;
+        } else {
+            frame[n++] = payload[i];
+        }
+    }
+    frame[code_idx] = (uint8_t)(n - code_idx);
+
+    frame[n++] = 0;
+    return n;
+}
+
+// --- Public Function Definitions ---
+
+void trace_init(void)
+{
+    critical_state_t state = critical_enter();
+    trace_tail = trace_head;
+    trace_dropped = 0;
+    is_started = true;
+    critical_exit(state);
+
+    TRACE(TRACE_EVENT_START, clock_get_profile());
+}
+
+void trace_drain(void)
+{
+    if (!is_started) return;
+
+    // Only full packets are sent: the TX ISR wakes the run loop when a packet
+    // has gone out, which records a sleep, so sending each record on its own
+    // would keep the UART busy with the trace of its own traffic.
+    uint8_t tail = trace_tail;
+    uint8_t pending = trace_head - tail;
+    if (pending < PACKET_RECORDS_MAX) return;
+    if (uart_write_room() < PAYLOAD_MAX + FRAME_OVERHEAD) return;
+    const uint8_t cnt = PACKET_RECORDS_MAX;
+
+    uint8_t payload[PAYLOAD_MAX];
+    critical_state_t state = critical_enter();
+    payload[0] = trace_dropped;
+    trace_dropped = 0;
+    critical_exit(state);
+
+    for (uint8_t i = 0; i < cnt; i++) {
+        memcpy(&payload[HEADER_BYTES + i * sizeof(trace_record_t)], &trace_ring[(tail + i) & RING_MASK],
+            sizeof(trace_record_t));
+    }
+    trace_tail = tail + (uint8_t)cnt;
+
+    uint8_t frame[PAYLOAD_MAX + FRAME_OVERHEAD];
+    uint16_t len = HEADER_BYTES + cnt * sizeof(trace_record_t);
+    (void)uart_write(frame, frame_packet(payload, len, frame));
+}
+
+#endif // TRACE_ENABLE
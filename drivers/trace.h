@@ -0,0 +1,128 @@
+/**
+ * @file trace.h
+ * @brief Binary event trace, recorded into a RAM ring and streamed over the UART.
+ *
+ * TRACE() stores a 4-byte record: the 16-bit Timer0_A count, the event and an
+ * 8-bit argument, in a few cycles with interrupts briefly disabled. The run
+ * loop drains the ring between handlers into COBS-framed packets sent with
+ * uart_write(), and tools/trace_decode turns the stream into a Chrome trace
+ * JSON timeline (make trace-decoder).
+ *
+ * Tracing is enabled with make TRACE=1 (after a make clean). Otherwise TRACE()
+ * and the functions below compile to nothing.
+ *
+ * Each packet is COBS-encoded and framed by a 0x00 byte on both sides, so the
+ * decoder can skip any other text sent over the UART. Before encoding:
+ * - 1 byte: records dropped since the previous packet because the ring was full (saturates).
+ * - 4 bytes per record: Timer0_A count (little-endian), trace_event_e, argument.
+ *
+ * The counts wrap every 65536 counts; TRACE_EVENT_TIMER_WRAP and
+ * TRACE_EVENT_CLOCK records let the decoder rebuild absolute times.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <msp430.h>
+#include <stdint.h>
+#include "../common/critical.h"
+#include "../common/defines.h"
+#include "trace_events.h"
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 0
+#endif
+
+// --- Public Constants ---
+
+#define TRACE_RING_SIZE 32 ///< Records kept until drained (4 bytes each). Power of two, at most 128.
+
+#if TRACE_ENABLE
+
+// --- Public Type Definitions ---
+
+typedef struct
+{
+    uint16_t count; ///< Timer0_A count when the record was taken.
+    uint8_t event; ///< trace_event_e
+    uint8_t arg;
+} trace_record_t;
+
+// --- Public Variables ---
+
+/**
+ * @brief The record ring. Only accessed through TRACE() and trace_drain().
+ */
+extern trace_record_t trace_ring[TRACE_RING_SIZE];
+extern volatile uint8_t trace_head;
+extern volatile uint8_t trace_tail;
+extern volatile uint8_t trace_dropped;
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Appends a record, or counts it as dropped if the ring is full. Safe in any context.
+ *
+ * Reading the counter and taking the slot in one interrupts-off window keeps
+ * the records in time order. The window is too short to be worth a
+ * CRITICAL_INSTRUMENT measurement, so the untraced primitive is used.
+ */
+FORCE_INLINE void trace_record(trace_event_e event, uint8_t arg)
+{
+    critical_state_t state = critical_save_and_disable();
+    uint8_t head = trace_head;
+    if ((uint8_t)(head - trace_tail) < TRACE_RING_SIZE) {
+        trace_record_t *record = &trace_ring[head & (TRACE_RING_SIZE - 1)];
+        record->count = TA0R;
+        record->event = (uint8_t)event;
+        record->arg = arg;
+        trace_head = head + 1;
+    } else if (trace_dropped != UINT8_MAX) {
+        trace_dropped++;
+    }
+    if (state & GIE) {
+        __enable_interrupt();
+    }
+}
+
+/**
+ * @brief Records an event with an 8-bit argument.
+ */
+#define TRACE(event, arg) trace_record((event), (uint8_t)(arg))
+
+/**
+ * @brief Wakes the run loop on ISR return once the ring is half full.
+ *
+ * For ISRs that never wake the CPU otherwise, so their records are drained
+ * before the ring overflows while the run loop sleeps. Must be used in the
+ * ISR function itself, like RUNLOOP_ISR_EXIT().
+ */
+#define TRACE_ISR_EXIT()                                                                           \
+    do {                                                                                           \
+        if ((uint8_t)(trace_head - trace_tail) >= TRACE_RING_SIZE / 2) {                          \
+            __bic_SR_register_on_exit(LPM4_bits);                                                  \
+        }                                                                                          \
+    } while (0)
+
+/**
+ * @brief Discards earlier records and starts the stream with TRACE_EVENT_START.
+ * @note Must be called after timebase_init() and uart_init().
+ */
+void trace_init(void);
+
+/**
+ * @brief Sends a packet of records once enough are pending and the UART buffer has room.
+ * @note Called by the run loop on every pass. Must not be called from an ISR.
+ */
+void trace_drain(void);
+
+#else
+
+#define TRACE(event, arg) ((void)0)
+#define TRACE_ISR_EXIT() ((void)0)
+
+FORCE_INLINE void trace_init(void) { }
+FORCE_INLINE void trace_drain(void) { }
+
+#endif // TRACE_ENABLE
+
+#endif // TRACE_H
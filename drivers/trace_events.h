@@ -0,0 +1,35 @@
+/**
+ * @file trace_events.h
+ * @brief Trace event identifiers, shared by the firmware and the host-side decoder.
+ *
+ * Plain C with no device header, so tools/trace_decode.c can include it.
+ * Columns: X(event, label)
+ */
+#ifndef TRACE_EVENTS_H
+#define TRACE_EVENTS_H
+
+// clang-format off
+#define TRACE_EVENTS(X)                                                                            \
+    X(TRACE_EVENT_START,      "start")      /* trace_init(); arg: clock_profile_e */               \
+    X(TRACE_EVENT_CLOCK,      "clock")      /* Timer0_A restarts from 0 after it; arg: new clock_profile_e */ \
+    X(TRACE_EVENT_TIMER_WRAP, "timer wrap") /* Timer0_A overflowed */                              \
+    X(TRACE_EVENT_ISR_BEGIN,  "isr")        /* arg: interrupt vector */                            \
+    X(TRACE_EVENT_ISR_END,    "isr")        /* arg: interrupt vector */                            \
+    X(TRACE_EVENT_TASK_BEGIN, "task")       /* arg: runloop_event_e */                             \
+    X(TRACE_EVENT_TASK_END,   "task")       /* arg: runloop_event_e */                             \
+    X(TRACE_EVENT_SLEEP,      "sleep")      /* arg: 0 for LPM0, 3 for LPM3 */                      \
+    X(TRACE_EVENT_LED_TOGGLE, "led")        /* arg: LED index, bit 7 set when switched on */       \
+    X(TRACE_EVENT_USER,       "user")       /* Application marker; arg is free */
+// clang-format on
+
+#define TRACE_EVENT_ENUM(event, label) event,
+/**
+ * @brief Trace events, one per TRACE_EVENTS() row.
+ */
+typedef enum {
+    TRACE_EVENTS(TRACE_EVENT_ENUM)
+    TRACE_EVENT_CNT,
+} trace_event_e;
+#undef TRACE_EVENT_ENUM
+
+#endif // TRACE_EVENTS_H
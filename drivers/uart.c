@@ -0,0 +1,348 @@
+/**
+ * @file uart.c
+ * @brief Implementation of the interrupt-driven USCI_A0 UART.
+ *
+ * The ring buffers use free-running 8-bit indices, each written by one side
+ * only: the producer advances the head, the consumer the tail, so neither
+ * needs a critical section to exchange bytes. Only the span queue, whose last
+ * span uart_write() may extend, is updated with interrupts disabled.
+ */
+#include "uart.h"
+#include <msp430.h>
+#include <stddef.h>
+#include <string.h>
+#include "../common/critical.h"
+#include "../common/defines.h"
+#include "clock.h"
+#include "i2c.h"
+#include "isr_profile.h"
+#include "runloop.h"
+#include "timebase.h"
+
+_Static_assert((UART_TX_RING_SIZE & (UART_TX_RING_SIZE - 1)) == 0 && UART_TX_RING_SIZE <= 128,
+    "UART_TX_RING_SIZE must be a power of two up to 128");
+_Static_assert((UART_TX_SPAN_CNT & (UART_TX_SPAN_CNT - 1)) == 0 && UART_TX_SPAN_CNT <= 128,
+    "UART_TX_SPAN_CNT must be a power of two up to 128");
+_Static_assert((UART_RX_RING_SIZE & (UART_RX_RING_SIZE - 1)) == 0 && UART_RX_RING_SIZE <= 128,
+    "UART_RX_RING_SIZE must be a power of two up to 128");
+
+// --- Private Module Constants ---
+
+#define TX_RING_MASK (UART_TX_RING_SIZE - 1)
+#define TX_SPAN_MASK (UART_TX_SPAN_CNT - 1)
+#define RX_RING_MASK (UART_RX_RING_SIZE - 1)
+
+/**
+ * @brief Smallest divider for which 16x oversampling is used.
+ *
+ * Oversampling gives the most accurate bit timing, but needs 16 BRCLK cycles per bit.
+ */
+#define OVERSAMPLING_MIN_DIV 16
+
+// --- Private Type Definitions ---
+
+/**
+ * @brief Bytes waiting for transmission, either in tx_ring or in the caller's constant buffer.
+ */
+typedef struct
+{
+    const uint8_t *data;
+    uint16_t len;
+} tx_span_t;
+
+// --- Private Module Variables ---
+
+static uint32_t baud_rate = 0;
+static uint32_t flush_wait_ticks = 0; ///< Two frames of 10 bits, set by uart_init().
+
+static uint8_t tx_ring[UART_TX_RING_SIZE];
+static volatile uint8_t tx_ring_head = 0; ///< Advanced by uart_write().
+static volatile uint8_t tx_ring_tail = 0; ///< Advanced by the TX ISR.
+
+/**
+ * @brief Spans in transmission order. The TX ISR sends from the span at span_tail.
+ */
+static tx_span_t tx_spans[UART_TX_SPAN_CNT];
+static volatile uint8_t span_head = 0;
+static volatile uint8_t span_tail = 0;
+
+static uint8_t rx_ring[UART_RX_RING_SIZE];
+static volatile uint8_t rx_head = 0; ///< Advanced by the RX ISR.
+static volatile uint8_t rx_tail = 0; ///< Advanced by uart_read().
+
+static volatile uart_stats_t stats = { 0, 0 };
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Programs the baud rate divider for the current SMCLK frequency.
+ *
+ * Also the clock change callback. Setting UCSWRST clears the USCI interrupt
+ * enables, so they are restored afterwards.
+ */
+static void configure_baud(void)
+{
+    uint32_t hz = clock_smclk_hz();
+    uint16_t div = (uint16_t)((hz + baud_rate / 2) / baud_rate);
+    uint16_t br;
+    uint8_t mctl;
+
+    if (div >= OVERSAMPLING_MIN_DIV) {
+        // BRCLK / 16 per sample, with the remainder as the first-stage modulation.
+        br = div / 16;
+        mctl = (uint8_t)((div % 16) * UCBRF_1) | UCOS16;
+    } else {
+        // Eighths of a BRCLK cycle per bit go to the second-stage modulation.
+        uint16_t div8 = (uint16_t)((hz * 8 + baud_rate / 2) / baud_rate);
+        br = div8 / 8;
+        mctl = (uint8_t)((div8 % 8) * UCBRS_1);
+    }
+
+    uint8_t enabled = IE2 & (UCA0RXIE | UCA0TXIE);
+    UCA0CTL1 |= UCSWRST;
+    UCA0BR0 = (uint8_t)br;
+    UCA0BR1 = (uint8_t)(br >> 8);
+    UCA0MCTL = mctl;
+    UCA0CTL1 &= ~UCSWRST;
+    IE2 |= enabled;
+}
+
+/**
+ * @brief Queues a span, merging it with the last one when they are contiguous.
+ * @note Must be called with interrupts disabled.
+ * @return false if the span queue is full.
+ */
+static bool queue_span(const uint8_t *data, uint16_t len)
+{
+    if (span_head != span_tail) {
+        // The ISR moves data and len of the span it sends in step, so its end stays put.
+        tx_span_t *last = &tx_spans[(uint8_t)(span_head - 1) & TX_SPAN_MASK];
+        if (last->data + last->len == data) {
+            last->len += len;
+            return true;
+        }
+    }
+    if ((uint8_t)(span_head - span_tail) == UART_TX_SPAN_CNT) return false;
+
+    tx_spans[span_head & TX_SPAN_MASK] = (tx_span_t) { data, len };
+    span_head++;
+    if (!(IE2 & UCA0TXIE)) {
+        // The transmit buffer is empty while idle, so the TX ISR runs right away.
+        runloop_hold_lpm0();
+        IE2 |= UCA0TXIE;
+    }
+    return true;
+}
+
+// --- Public Function Definitions ---
+
+void uart_init(uint32_t baud)
+{
+    baud_rate = baud;
+    flush_wait_ticks = (2 * 10 * TIMEBASE_TICK_HZ + baud - 1) / baud;
+
+    // 8 data bits, no parity, 1 stop bit, LSB first, clocked from SMCLK.
+    UCA0CTL1 = UCSWRST;
+    UCA0CTL0 = 0;
+    UCA0CTL1 = UCSSEL_2 | UCSWRST;
+    configure_baud();
+    clock_register(CLOCK_CLIENT_UART, configure_baud);
+
+    IE2 |= UCA0RXIE;
+}
+
+uint16_t uart_write(const void *data, uint16_t len)
+{
+    const uint8_t *src = data;
+    uint16_t written = 0;
+
+    while (written < len) {
+        // The bytes from head up to tail + size belong to this side until queued.
+        uint8_t head = tx_ring_head;
+        uint8_t idx = head & TX_RING_MASK;
+        uint16_t room = UART_TX_RING_SIZE - (uint8_t)(head - tx_ring_tail);
+        if (room > UART_TX_RING_SIZE - idx) room = UART_TX_RING_SIZE - idx;
+        uint16_t chunk = len - written;
+        if (chunk > room) chunk = room;
+        if (chunk == 0) break;
+
+        memcpy(&tx_ring[idx], &src[written], chunk);
+
+        critical_state_t state = critical_enter();
+        bool is_queued = queue_span(&tx_ring[idx], chunk);
+        if (is_queued) {
+            tx_ring_head = head + (uint8_t)chunk;
+        }
+        critical_exit(state);
+
+        if (!is_queued) break;
+        written += chunk;
+    }
+    return written;
+}
+
+void uart_write_all(const void *data, uint16_t len)
+{
+    const uint8_t *src = data;
+    while (len > 0) {
+        uint16_t sent = uart_write(src, len);
+        src += sent;
+        len -= sent;
+        if (len > 0) {
+            uart_flush();
+        }
+    }
+}
+
+uint16_t uart_write_room(void)
+{
+    uint8_t head = tx_ring_head;
+    uint16_t room = UART_TX_RING_SIZE - (uint8_t)(head - tx_ring_tail);
+    uint8_t free_spans = UART_TX_SPAN_CNT - (uint8_t)(span_head - span_tail);
+
+    // A write wrapping around the end of the ring takes two spans.
+    if (free_spans == 0) return 0;
+    if (free_spans == 1 && room > UART_TX_RING_SIZE - (head & TX_RING_MASK)) {
+        room = UART_TX_RING_SIZE - (head & TX_RING_MASK);
+    }
+    return room;
+}
+
+bool uart_write_const(const void *data, uint16_t len)
+{
+    if (len == 0) return true;
+
+    critical_state_t state = critical_enter();
+    bool is_queued = queue_span(data, len);
+    critical_exit(state);
+    return is_queued;
+}
+
+void uart_flush(void)
+{
+    // Re-check after each interrupt; the TX ISR wakes the CPU when the queue drains.
+    critical_state_t state = critical_enter();
+    while (IE2 & UCA0TXIE) {
+        runloop_sleep(); // Ends the section; a new one is entered for the next test
+        (void)critical_enter();
+    }
+    critical_exit(state);
+
+    // The last bytes are still being shifted out, which raises no interrupt:
+    // at most two frames. UCBUSY also covers a byte being received, so the
+    // wait stops after two frame times whatever the line does.
+    uint32_t deadline = timebase_ticks() + flush_wait_ticks;
+    while (UCA0STAT & UCBUSY) {
+        if (timebase_reached(timebase_ticks(), deadline)) break;
+    }
+}
+
+uint16_t uart_read(void *data, uint16_t max)
+{
+    uint8_t *dst = data;
+    uint8_t head = rx_head;
+    uint8_t tail = rx_tail;
+    uint16_t count = 0;
+
+    while (count < max && tail != head) {
+        dst[count++] = rx_ring[tail & RX_RING_MASK];
+        tail++;
+    }
+    rx_tail = tail;
+    return count;
+}
+
+void uart_get_stats(uart_stats_t *out)
+{
+    critical_state_t state = critical_enter();
+    *out = stats;
+    critical_exit(state);
+}
+
+// --- Private Function Definitions: Interrupt Handlers ---
+
+/**
+ * @brief Sends the next queued byte.
+ */
+static void send_next_byte(void)
+{
+    tx_span_t *span = &tx_spans[span_tail & TX_SPAN_MASK];
+    const uint8_t *data = span->data;
+
+    UCA0TXBUF = *data;
+    if (data >= tx_ring && data < &tx_ring[UART_TX_RING_SIZE]) {
+        tx_ring_tail++;
+    }
+    span->data = data + 1;
+    if (--span->len == 0) {
+        span_tail++;
+        if (span_tail == span_head) {
+            IE2 &= ~UCA0TXIE;
+            runloop_release_lpm0();
+            runloop_wake(); // For uart_flush()
+        }
+    }
+}
+
+/**
+ * @brief Queues the received byte.
+ */
+static void receive_byte(void)
+{
+    // Reading UCA0RXBUF clears the overrun flag, so test it first.
+    if (UCA0STAT & UCOE) {
+        stats.rx_overruns++;
+    }
+    uint8_t byte = UCA0RXBUF;
+
+    uint8_t head = rx_head;
+    if ((uint8_t)(head - rx_tail) < UART_RX_RING_SIZE) {
+        rx_ring[head & RX_RING_MASK] = byte;
+        rx_head = head + 1;
+    } else {
+        stats.rx_dropped++;
+    }
+    runloop_post(RUNLOOP_EVENT_UART_RX);
+}
+
+// --- Interrupt Service Routines ---
+
+/**
+ * @brief USCI_A0/B0 transmit ISR, sends the next queued byte.
+ *
+ * USCI_B0 shares the vector: its I2C data interrupts go to the I2C driver.
+ * The LED panel polls it without interrupts.
+ */
+INTERRUPT_VECTOR(USCIAB0TX_VECTOR)
+void uart_tx_isr(void)
+{
+    ISR_PROFILE_ENTER();
+    // UCA0TXIFG stays set while idle, so both the enable and the flag tell
+    // whether a byte is due: the vector may have been entered for USCI_B0.
+    if ((IE2 & UCA0TXIE) && (IFG2 & UCA0TXIFG)) {
+        send_next_byte();
+    }
+    ISR_PROFILE_EXIT(ISR_PROFILE_UART_TX);
+
+    i2c_data_isr(); // Profiled on its own
+    RUNLOOP_ISR_EXIT(USCIAB0TX_VECTOR);
+}
+
+/**
+ * @brief USCI_A0/B0 receive ISR, queues the received byte.
+ *
+ * USCI_B0 shares the vector: its I2C state interrupts (NACK, arbitration
+ * lost) go to the I2C driver.
+ */
+INTERRUPT_VECTOR(USCIAB0RX_VECTOR)
+void uart_rx_isr(void)
+{
+    ISR_PROFILE_ENTER();
+    if (IFG2 & UCA0RXIFG) {
+        receive_byte();
+    }
+    ISR_PROFILE_EXIT(ISR_PROFILE_UART_RX);
+
+    i2c_state_isr(); // Profiled on its own
+    RUNLOOP_ISR_EXIT(USCIAB0RX_VECTOR);
+}
@@ -0,0 +1,102 @@
+/**
+ * @file uart.h
+ * @brief Interrupt-driven USCI_A0 UART on P1.1 (RXD) and P1.2 (TXD), 8N1.
+ *
+ * Received bytes are queued by the RX ISR in a ring buffer and announced with
+ * RUNLOOP_EVENT_UART_RX. Transmission is a queue of spans sent byte by byte
+ * by the TX ISR: uart_write() copies into a ring buffer, while
+ * uart_write_const() queues a constant buffer in place, so strings in flash
+ * never take RAM.
+ *
+ * The baud rate divider follows the clock profile. Rates up to 460800 baud
+ * are accurate at 16 MHz; the 1 MHz profile is limited to 115200 baud.
+ */
+#ifndef UART_H
+#define UART_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// --- Public Constants ---
+
+#define UART_TX_RING_SIZE 32 ///< Bytes of the copy buffer. Power of two, at most 128.
+#define UART_TX_SPAN_CNT 8 ///< Queued write spans. Power of two.
+#define UART_RX_RING_SIZE 32 ///< Bytes of the receive buffer. Power of two, at most 128.
+
+// --- Public Type Definitions ---
+
+/**
+ * @brief Receive error counters since uart_init().
+ */
+typedef struct
+{
+    uint16_t rx_overruns; ///< Bytes lost because the RX ISR ran too late (UCOE).
+    uint16_t rx_dropped; ///< Bytes lost because the receive buffer was full.
+} uart_stats_t;
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Configures USCI_A0 from SMCLK and starts receiving.
+ * @note Must be called after gpio_init(). The divider is recomputed on every clock change.
+ * @param baud The baud rate, e.g. 115200.
+ */
+void uart_init(uint32_t baud);
+
+/**
+ * @brief Queues a copy of bytes for transmission, without blocking.
+ * @note Must not be called from an ISR.
+ * @param data The bytes to send.
+ * @param len Number of bytes.
+ * @return The number of bytes queued, less than len if the buffer filled up.
+ */
+uint16_t uart_write(const void *data, uint16_t len);
+
+/**
+ * @brief Queues a copy of a whole buffer, sleeping until sent whenever the buffer fills up.
+ * @note Must not be called from an ISR.
+ * @param data The bytes to send.
+ * @param len Number of bytes.
+ */
+void uart_write_all(const void *data, uint16_t len);
+
+/**
+ * @brief Returns how many bytes uart_write() can queue at once right now.
+ * @note The room only grows until the next write, as the TX ISR frees it.
+ */
+uint16_t uart_write_room(void);
+
+/**
+ * @brief Queues bytes for transmission without copying them.
+ * @note Must not be called from an ISR.
+ * @param data The bytes to send. They must stay unchanged until sent, e.g. a const in flash.
+ * @param len Number of bytes.
+ * @return false if the span queue is full and nothing was queued.
+ */
+bool uart_write_const(const void *data, uint16_t len);
+
+/**
+ * @brief Sleeps until every queued byte has been sent.
+ *
+ * A byte being shifted out when the clock profile changes is corrupted, so
+ * call this before clock_set_profile() when a message is in flight.
+ *
+ * @note Must not be called from an ISR.
+ */
+void uart_flush(void);
+
+/**
+ * @brief Takes received bytes out of the receive buffer, without blocking.
+ * @param data Destination of the bytes.
+ * @param max Size of the destination.
+ * @return The number of bytes copied.
+ */
+uint16_t uart_read(void *data, uint16_t max);
+
+/**
+ * @brief Copies the receive error counters.
+ * @param out Destination of the counters. Must not be NULL.
+ */
+void uart_get_stats(uart_stats_t *out);
+
+#endif // UART_H
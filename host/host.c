@@ -0,0 +1,1906 @@
+/**
+ * @file host.c
+ * @brief Peripheral model behind the stand-in msp430.h of the host emulation build.
+ *
+ * The model is lazy: registers are plain memory written directly by the
+ * firmware, and host_sync() reconciles the peripheral state with them on the
+ * next access. Time only advances inside the model, on register accesses,
+ * intrinsics, ISR entry and exit, and while the CPU sleeps. In low-power mode
+ * the model jumps directly to the next timer, watchdog or input event.
+ *
+ * Time is kept in picoseconds so that the DCO, crystal and divided timer
+ * clocks can all be stepped without drift.
+ */
+#include "host.h"
+#include <msp430.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../common/defines.h"
+
+// --- Private Module Constants ---
+
+#define PS_PER_S 1000000000000ULL
+#define PS_PER_MS 1000000000ULL
+#define PS_PER_NS 1000ULL
+#define MAX_STEP_PS (PS_PER_S / 10) ///< Keeps ps * Hz products within 64 bits.
+
+#define LFXT1_HZ 32768UL
+#define VLO_HZ 12000UL
+#define DCO_BASE_HZ 120000.0 ///< DCO frequency at RSEL 0, DCO 0.
+#define DCO_RSEL_RATIO 1.35 ///< Frequency ratio between two RSEL settings (datasheet typ.).
+#define DCO_STEP_RATIO 1.08 ///< Frequency ratio between two DCO taps (datasheet typ.).
+#define DCO_TAP_CNT 8
+#define DCO_MOD_CNT 32
+
+#define WDTCTL_READ_KEY 0x6900
+#define ISR_ENTRY_CYCLES 6
+#define ISR_RETURN_CYCLES 5
+#define ISR_NESTING_MAX 8
+#define INPUT_SCHEDULE_MAX 64
+#define EDGE_LOG_MAX (1UL << 20)
+#define TIMER_CNT 2
+#define TIMER_CHANNEL_CNT 3
+#define UART_FRAME_BITS 10 ///< Start, 8 data and stop bits.
+#define UART_TXBUF_EMPTY 0xFFFF ///< UCA0TXBUF value when the firmware has not written it.
+#define UART_BAUD_DEFAULT 115200
+#define UART_BAUD_TOLERANCE 0.03 ///< Largest baud mismatch received without a framing error.
+#define I2C_TXBUF_EMPTY 0xFFFF ///< UCB0TXBUF value when the firmware has not written it.
+#define I2C_PINS 0x00C0 ///< P1.6 (SCL) and P1.7 (SDA), pulled up outside the chip.
+#define I2C_ADDRESS_BITS 10 ///< START, 7 address bits, R/W and acknowledge.
+#define I2C_BYTE_BITS 9 ///< 8 data bits and acknowledge.
+#define I2C_MEM_ADDRESS 0x50
+#define I2C_MEM_SIZE 256
+#define AS5600_ADDRESS 0x36
+#define AS5600_SAMPLE_PS (150 * 1000 * PS_PER_NS) ///< Output refresh period of the sensor.
+#define AS5600_RPM_DEFAULT 600.0
+#define AS5600_STATUS_MD 0x20 ///< Magnet detected.
+#define AS5600_PWM_PIN 9 ///< P2.1, the OUT pin in PWM mode.
+#define AS5600_PWM_FRAME_CLOCKS 4351 ///< 128 high, the 4095 data clocks, then 128 low.
+#define AS5600_PWM_HEADER_CLOCKS 128
+#define TIMER_INPUT_B_PINS 0x2C00 ///< P2.2, P2.3 and P2.5 are CCIxB inputs, the others CCIxA.
+#define ADC_OSC_HZ 5000000UL ///< ADC10OSC, typical.
+#define ADC_CONVERSION_CLOCKS 13
+#define ADC_FULL_SCALE 1023
+#define ADC_VCC 3.6 ///< Supply of the LaunchPad, in volts.
+#define ADC_TEMP_C 25.0 ///< Die temperature read by the sensor.
+
+#define REG(name) (host_sfr.sfr_##name)
+
+// --- Private Structure Definitions ---
+
+/**
+ * @brief Registers and internal state of one Timer_A instance.
+ */
+struct host_timer_s
+{
+    volatile uint16_t *ctl;
+    volatile uint16_t *r;
+    volatile uint16_t *cctl[TIMER_CHANNEL_CNT];
+    volatile uint16_t *ccr[TIMER_CHANNEL_CNT];
+    uint64_t phase; ///< Input clock progress towards the next count, in ps * Hz.
+    bool out[TIMER_CHANNEL_CNT]; ///< Output unit levels (TAx.0 to TAx.2).
+};
+
+/**
+ * @brief Registers of one digital I/O port.
+ */
+struct host_port_s
+{
+    volatile uint8_t *in;
+    volatile uint8_t *out;
+    volatile uint8_t *dir;
+    volatile uint8_t *ifg;
+    volatile uint8_t *ies;
+    volatile uint8_t *sel;
+    volatile uint8_t *sel2;
+    volatile uint8_t *ren;
+};
+
+/**
+ * @brief A byte sent to the UART RX pin, not before a given time.
+ */
+struct host_uart_rx_s
+{
+    uint64_t at_ps;
+    uint8_t byte;
+};
+
+/**
+ * @brief An external input change waiting for its time.
+ */
+struct host_input_s
+{
+    uint64_t at_ps;
+    uint8_t pin;
+    host_input_e level;
+};
+
+/**
+ * @brief A slave on the I2C bus.
+ */
+struct host_i2c_device_s
+{
+    uint8_t address;
+    void (*start)(bool is_read); ///< Called once the device acknowledged its address.
+    bool (*write)(uint8_t byte); ///< Returns false to NACK the byte.
+    uint8_t (*read)(void);
+};
+
+/**
+ * @brief Bus phases of the USCI_B0 I2C master.
+ */
+enum host_i2c_phase_e {
+    I2C_PHASE_IDLE, ///< Bus free.
+    I2C_PHASE_WAIT, ///< SCL held low, waiting for the firmware.
+    I2C_PHASE_ADDRESS,
+    I2C_PHASE_TX_BYTE,
+    I2C_PHASE_RX_BYTE,
+    I2C_PHASE_STOP,
+};
+
+typedef void (*host_isr_t)(void);
+
+// --- Interrupt Service Routine Lookup ---
+
+// The linker defines __start_host_isr_<n> for each section that exists, see
+// HOST_INTERRUPT_VECTOR(). Vectors without an ISR resolve to NULL.
+#define HOST_ISR_DECLARE(vector) extern void __start_host_isr_##vector(void) __attribute__((weak));
+HOST_ISR_DECLARE(3)
+HOST_ISR_DECLARE(4)
+HOST_ISR_DECLARE(6)
+HOST_ISR_DECLARE(7)
+HOST_ISR_DECLARE(8)
+HOST_ISR_DECLARE(9)
+HOST_ISR_DECLARE(10)
+HOST_ISR_DECLARE(11)
+HOST_ISR_DECLARE(12)
+HOST_ISR_DECLARE(13)
+HOST_ISR_DECLARE(14)
+HOST_ISR_DECLARE(15)
+
+static const host_isr_t isr_table[HOST_VECTOR_CNT] = {
+    [PORT1_VECTOR] = __start_host_isr_3,
+    [PORT2_VECTOR] = __start_host_isr_4,
+    [ADC10_VECTOR] = __start_host_isr_6,
+    [USCIAB0TX_VECTOR] = __start_host_isr_7,
+    [USCIAB0RX_VECTOR] = __start_host_isr_8,
+    [TIMER0_A1_VECTOR] = __start_host_isr_9,
+    [TIMER0_A0_VECTOR] = __start_host_isr_10,
+    [WDT_VECTOR] = __start_host_isr_11,
+    [COMPARATORA_VECTOR] = __start_host_isr_12,
+    [TIMER1_A1_VECTOR] = __start_host_isr_13,
+    [TIMER1_A0_VECTOR] = __start_host_isr_14,
+    [NMI_VECTOR] = __start_host_isr_15,
+};
+
+static const char *const vector_names[HOST_VECTOR_CNT] = {
+    [PORT1_VECTOR] = "PORT1",
+    [PORT2_VECTOR] = "PORT2",
+    [ADC10_VECTOR] = "ADC10",
+    [USCIAB0TX_VECTOR] = "USCIAB0TX",
+    [USCIAB0RX_VECTOR] = "USCIAB0RX",
+    [TIMER0_A1_VECTOR] = "TIMER0_A1",
+    [TIMER0_A0_VECTOR] = "TIMER0_A0",
+    [WDT_VECTOR] = "WDT",
+    [COMPARATORA_VECTOR] = "COMPARATORA",
+    [TIMER1_A1_VECTOR] = "TIMER1_A1",
+    [TIMER1_A0_VECTOR] = "TIMER1_A0",
+    [NMI_VECTOR] = "NMI",
+};
+
+/**
+ * @brief Timer output routed to each pin when PxSEL is set: timer * 3 + channel, or -1.
+ */
+static const int8_t timer_output_pins[HOST_PIN_CNT] = {
+    -1, 0, 1, -1, -1, 0, 1, -1, // P1.1/P1.5: TA0.0, P1.2/P1.6: TA0.1
+    3, 4, 4, 3, 5, 5, -1, -1, // P2.0/P2.3: TA1.0, P2.1/P2.2: TA1.1, P2.4/P2.5: TA1.2
+};
+
+/**
+ * @brief Timer capture input of each pin when PxSEL is set: timer * 3 + channel, or -1.
+ */
+static const int8_t timer_input_pins[HOST_PIN_CNT] = {
+    -1, 0, 1, -1, -1, -1, -1, -1, // P1.1: CCI0A, P1.2: CCI1A of Timer0_A
+    3, 4, 4, 3, 5, 5, -1, -1, // P2.0/P2.3: CCI0A/B, P2.1/P2.2: CCI1A/B, P2.4/P2.5: CCI2A/B
+};
+
+// --- Private Module Variables ---
+
+host_sfr_t host_sfr;
+
+static uint16_t sr = 0;
+static uint16_t saved_sr[ISR_NESTING_MAX];
+static uint8_t isr_depth = 0;
+static uint32_t isr_counts[HOST_VECTOR_CNT];
+
+static uint64_t now_ps = 0;
+static uint64_t end_ps = HOST_RUN_MS_DEFAULT * PS_PER_MS;
+static uint64_t mode_ps[6]; ///< Time spent active and in LPM0 to LPM4.
+static struct timespec wall_start;
+
+static struct host_timer_s timers[TIMER_CNT] = {
+    {
+        .ctl = &REG(TA0CTL),
+        .r = &REG(TA0R),
+        .cctl = { &REG(TA0CCTL0), &REG(TA0CCTL1), &REG(TA0CCTL2) },
+        .ccr = { &REG(TA0CCR0), &REG(TA0CCR1), &REG(TA0CCR2) },
+    },
+    {
+        .ctl = &REG(TA1CTL),
+        .r = &REG(TA1R),
+        .cctl = { &REG(TA1CCTL0), &REG(TA1CCTL1), &REG(TA1CCTL2) },
+        .ccr = { &REG(TA1CCR0), &REG(TA1CCR1), &REG(TA1CCR2) },
+    },
+};
+
+static const struct host_port_s ports[HOST_PORT_CNT] = {
+    { &REG(P1IN), &REG(P1OUT), &REG(P1DIR), &REG(P1IFG), &REG(P1IES), &REG(P1SEL), &REG(P1SEL2),
+        &REG(P1REN) },
+    { &REG(P2IN), &REG(P2OUT), &REG(P2DIR), &REG(P2IFG), &REG(P2IES), &REG(P2SEL), &REG(P2SEL2),
+        &REG(P2REN) },
+};
+
+static uint32_t wdt_cnt = 0;
+static uint64_t wdt_phase = 0;
+static uint64_t aclk_phase = 0; ///< ACLK progress towards the next rising edge, in ps * Hz.
+
+static uint16_t pin_levels = 0;
+static uint16_t input_driven = 0; ///< Pins driven from outside.
+static uint16_t input_levels = 0; ///< Level of the driven pins.
+static struct host_input_s input_schedule[INPUT_SCHEDULE_MAX];
+static uint8_t input_schedule_cnt = 0;
+
+static host_edge_t *edge_log = NULL;
+static size_t edge_cnt = 0;
+static size_t edge_capacity = 0;
+static host_pin_stats_t pin_stats[HOST_PIN_CNT];
+static uint64_t last_rise_ps[HOST_PIN_CNT];
+static const char *edge_file = NULL;
+
+static bool uart_tx_busy = false; ///< A frame is being shifted out.
+static uint8_t uart_tx_shift = 0;
+static uint64_t uart_tx_end_ps = 0;
+static FILE *uart_tx_file = NULL;
+static uint32_t uart_baud = UART_BAUD_DEFAULT; ///< Rate of the bytes sent to the RX pin.
+static struct host_uart_rx_s *uart_rx_queue = NULL;
+static size_t uart_rx_cnt = 0;
+static size_t uart_rx_pos = 0; ///< Next byte of uart_rx_queue to arrive.
+static uint64_t uart_rx_end_ps = 0; ///< End of the frame of the next byte.
+static uint32_t uart_stats_sent = 0;
+static uint32_t uart_stats_received = 0;
+static uint32_t uart_stats_overruns = 0;
+static uint32_t uart_stats_framing = 0;
+
+static enum host_i2c_phase_e i2c_phase = I2C_PHASE_IDLE;
+static uint64_t i2c_phase_end_ps = 0;
+static const struct host_i2c_device_s *i2c_device = NULL; ///< Slave addressed since the last START.
+static bool i2c_is_read = false;
+static bool i2c_is_nacked = false; ///< The transfer only continues with a START or a STOP.
+static uint8_t i2c_tx_shift = 0;
+static bool i2c_is_rx_held = false; ///< A received byte waits for UCB0RXBUF to be read.
+static uint8_t i2c_rx_held = 0;
+static uint32_t i2c_stats_starts = 0;
+static uint32_t i2c_stats_bytes = 0;
+static uint32_t i2c_stats_nacks = 0;
+
+static bool spi_is_shifting = false; ///< A byte is being shifted out.
+static uint64_t spi_shift_end_ps = 0;
+static uint32_t spi_stats_bytes = 0;
+
+static uint8_t i2c_mem[I2C_MEM_SIZE];
+static uint8_t i2c_mem_pointer = 0;
+static bool i2c_mem_has_pointer = false;
+
+static double as5600_rpm = AS5600_RPM_DEFAULT;
+static uint8_t as5600_pointer = 0;
+static bool as5600_has_pointer = false;
+static uint8_t as5600_read_start = 0; ///< Register pointer at the START of the read.
+static uint16_t as5600_angle = 0; ///< Angle latched at the START of the read.
+static double as5600_pwm_hz = 0.0; ///< PWM output frequency, 0 when the pin is not connected.
+static uint64_t as5600_pwm_edge_ps = 0; ///< Time of the next PWM edge.
+static uint64_t as5600_pwm_frame_end_ps = 0;
+
+static bool adc_is_converting = false;
+static uint64_t adc_conversion_end_ps = 0;
+static uint8_t adc_channel = 0; ///< Channel of the conversion in progress or next.
+static uint16_t adc_dtc_pos = 0; ///< Transfers into the current DTC buffer.
+static uintptr_t adc_dtc_start = 0; ///< ADC10SA at the last DTC restart.
+static bool adc_trigger_level = false;
+static bool adc_is_enabled_prev = false;
+static uint32_t adc_stats_conversions = 0;
+static uint32_t adc_stats_blocks = 0;
+static uint32_t adc_stats_missed = 0;
+
+static uint16_t dco_cache_key = 0xFFFF;
+static uint32_t dco_cache_hz = 0;
+
+// --- Private Function Definitions: Clocks ---
+
+static double dco_model_hz(uint8_t rsel, uint8_t dco, uint8_t mod)
+{
+    // At DCO tap 7 the modulator has no higher tap to mix in.
+    double tap = (dco == DCO_TAP_CNT - 1) ? dco : dco + (double)mod / DCO_MOD_CNT;
+    return DCO_BASE_HZ * pow(DCO_RSEL_RATIO, rsel) * pow(DCO_STEP_RATIO, tap);
+}
+
+static uint32_t dco_hz(void)
+{
+    uint16_t key = ((uint16_t)(REG(BCSCTL1) & 0x0F) << 8) | REG(DCOCTL);
+    if (key != dco_cache_key) {
+        dco_cache_key = key;
+        dco_cache_hz = (uint32_t)dco_model_hz(key >> 8, (key >> 5) & 7, key & 0x1F);
+    }
+    return dco_cache_hz;
+}
+
+static uint32_t lfxt1_hz(void)
+{
+    return (REG(BCSCTL3) & LFXT1S_2) ? VLO_HZ : LFXT1_HZ;
+}
+
+static uint32_t aclk_hz(void)
+{
+    return (sr & OSCOFF) ? 0 : lfxt1_hz() >> ((REG(BCSCTL1) >> 4) & 3);
+}
+
+static uint32_t smclk_hz(void)
+{
+    if (sr & SCG1) return 0;
+    uint32_t source = (REG(BCSCTL2) & SELS) ? lfxt1_hz() : dco_hz();
+    return source >> ((REG(BCSCTL2) >> 1) & 3);
+}
+
+static uint32_t mclk_hz(void)
+{
+    uint32_t source = (REG(BCSCTL2) & SELM_2) ? lfxt1_hz() : dco_hz(); // SELM_2 and SELM_3
+    return source >> ((REG(BCSCTL2) >> 4) & 3);
+}
+
+static uint64_t cycles_to_ps(uint32_t cycles)
+{
+    return (uint64_t)cycles * PS_PER_S / mclk_hz();
+}
+
+/**
+ * @brief Fills the calibration constants with the model settings closest to each frequency.
+ */
+static void calibrate_dco(void)
+{
+    static const uint32_t targets_hz[] = { 1000000, 8000000, 12000000, 16000000 };
+    volatile uint8_t *const bc1[] = { &REG(CALBC1_1MHZ), &REG(CALBC1_8MHZ), &REG(CALBC1_12MHZ),
+        &REG(CALBC1_16MHZ) };
+    volatile uint8_t *const dco[] = { &REG(CALDCO_1MHZ), &REG(CALDCO_8MHZ), &REG(CALDCO_12MHZ),
+        &REG(CALDCO_16MHZ) };
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(targets_hz); i++) {
+        double best_err = INFINITY;
+        for (uint16_t setting = 0; setting < 16 * DCO_TAP_CNT * DCO_MOD_CNT; setting++) {
+            uint8_t rsel = setting >> 8;
+            uint8_t tap = (setting >> 5) & 7;
+            uint8_t mod = setting & 0x1F;
+            double err = fabs(dco_model_hz(rsel, tap, mod) - targets_hz[i]);
+            if (err < best_err) {
+                best_err = err;
+                *bc1[i] = XT2OFF | rsel;
+                *dco[i] = (uint8_t)((tap << 5) | mod);
+            }
+        }
+    }
+}
+
+// --- Private Function Definitions: Pins ---
+
+static void record_edge(uint8_t pin, bool level)
+{
+    host_pin_stats_t *stats = &pin_stats[pin];
+
+    if (edge_cnt < EDGE_LOG_MAX) {
+        if (edge_cnt == edge_capacity) {
+            edge_capacity = edge_capacity ? edge_capacity * 2 : 1024;
+            edge_log = realloc(edge_log, edge_capacity * sizeof(*edge_log));
+            if (edge_log == NULL) {
+                perror("host: edge log");
+                exit(EXIT_FAILURE);
+            }
+        }
+        edge_log[edge_cnt++] = (host_edge_t) { now_ps / PS_PER_NS, pin, level };
+    }
+
+    if (level) {
+        if (stats->rising > 0) {
+            uint64_t period = (now_ps - last_rise_ps[pin]) / PS_PER_NS;
+            if (stats->rising == 1 || period < stats->period_min_ns) stats->period_min_ns = period;
+            if (period > stats->period_max_ns) stats->period_max_ns = period;
+            stats->period_sum_ns += period;
+        }
+        stats->rising++;
+        last_rise_ps[pin] = now_ps;
+    } else {
+        if (stats->rising > 0) {
+            uint64_t high = (now_ps - last_rise_ps[pin]) / PS_PER_NS;
+            if (stats->high_cnt == 0 || high < stats->high_min_ns) stats->high_min_ns = high;
+            if (high > stats->high_max_ns) stats->high_max_ns = high;
+            stats->high_sum_ns += high;
+            stats->high_cnt++;
+        }
+        stats->falling++;
+    }
+}
+
+static bool pin_level(uint8_t pin)
+{
+    const struct host_port_s *port = &ports[pin / 8];
+    uint8_t bit = 1u << (pin % 8);
+    bool is_output = *port->dir & bit;
+    bool sel = *port->sel & bit;
+    bool sel2 = *port->sel2 & bit;
+    uint16_t mask = 1u << pin;
+
+    if (is_output && !sel && !sel2) {
+        return *port->out & bit;
+    }
+    if (is_output && sel && !sel2) {
+        int8_t output = timer_output_pins[pin];
+        return output >= 0 && timers[output / TIMER_CHANNEL_CNT].out[output % TIMER_CHANNEL_CNT];
+    }
+    if (input_driven & mask) {
+        return input_levels & mask;
+    }
+    if (!sel && !sel2 && (*port->ren & bit)) {
+        return *port->out & bit; // Pull-up or pull-down.
+    }
+    if ((I2C_PINS & mask) && (REG(UCB0CTL0) & (UCMODE_3 | UCSYNC)) == (UCMODE_3 | UCSYNC)) {
+        return true; // Bus pull-ups. The SCL and SDA waveforms are not modelled.
+    }
+    return pin_levels & mask; // Floating: keeps its last level.
+}
+
+/**
+ * @brief Latches the timer of a capture channel whose input pin changed.
+ *
+ * The capture is taken with the counter as of the current step, and every
+ * capture is synchronous (SCS) since the pins change between timer counts.
+ */
+static void capture_input_edge(uint8_t pin, bool level)
+{
+    const struct host_port_s *port = &ports[pin / 8];
+    uint8_t bit = 1u << (pin % 8);
+    int8_t input = timer_input_pins[pin];
+    if (input < 0 || !(*port->sel & bit) || (*port->sel2 & bit) || (*port->dir & bit)) return;
+
+    struct host_timer_s *timer = &timers[input / TIMER_CHANNEL_CNT];
+    uint8_t ch = input % TIMER_CHANNEL_CNT;
+    uint16_t cctl = *timer->cctl[ch];
+    uint16_t ccis = (TIMER_INPUT_B_PINS & (1u << pin)) ? CCIS_1 : CCIS_0;
+    if (!(cctl & CAP) || (cctl & CCIS_3) != ccis) return;
+
+    cctl = level ? (cctl | CCI) : (cctl & ~CCI);
+    if (cctl & (level ? CM_1 : CM_2)) {
+        *timer->ccr[ch] = *timer->r;
+        if (cctl & CCIFG) cctl |= COV;
+        cctl |= CCIFG;
+    }
+    *timer->cctl[ch] = cctl;
+}
+
+/**
+ * @brief Samples every pin, records edges and sets the port interrupt flags.
+ */
+static void update_pins(void)
+{
+    uint16_t levels = 0;
+    for (uint8_t pin = 0; pin < HOST_PIN_CNT; pin++) {
+        if (pin_level(pin)) levels |= 1u << pin;
+    }
+
+    uint16_t changed = levels ^ pin_levels;
+    pin_levels = levels;
+    for (uint8_t p = 0; p < HOST_PORT_CNT; p++) {
+        uint8_t port_changed = changed >> (8 * p);
+        uint8_t port_levels = levels >> (8 * p);
+        const struct host_port_s *port = &ports[p];
+
+        *port->in = port_levels;
+        if (port_changed == 0) continue;
+
+        // PxIES selects the edge: 0 for rising, 1 for falling.
+        *port->ifg |= port_changed & (port_levels ^ *port->ies);
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            if (port_changed & (1u << bit)) {
+                record_edge(8 * p + bit, port_levels & (1u << bit));
+                capture_input_edge(8 * p + bit, port_levels & (1u << bit));
+            }
+        }
+    }
+}
+
+static void apply_due_inputs(void)
+{
+    while (input_schedule_cnt > 0 && input_schedule[0].at_ps <= now_ps) {
+        uint16_t mask = 1u << input_schedule[0].pin;
+        input_driven &= ~mask;
+        input_levels &= ~mask;
+        if (input_schedule[0].level != HOST_INPUT_RELEASED) {
+            input_driven |= mask;
+            if (input_schedule[0].level == HOST_INPUT_HIGH) input_levels |= mask;
+        }
+        input_schedule_cnt--;
+        memmove(&input_schedule[0], &input_schedule[1], input_schedule_cnt * sizeof(input_schedule[0]));
+    }
+}
+
+// --- Private Function Definitions: Timers and Watchdog ---
+
+static uint32_t timer_hz(const struct host_timer_s *timer)
+{
+    uint16_t ctl = *timer->ctl;
+    uint32_t source;
+
+    if ((ctl & MC_3) == MC_0) return 0;
+    switch (ctl & TASSEL_3) {
+    case TASSEL_1:
+        source = aclk_hz();
+        break;
+    case TASSEL_2:
+        source = smclk_hz();
+        break;
+    default:
+        return 0; // External clock inputs are not modelled.
+    }
+    return source >> ((ctl >> 6) & 3);
+}
+
+/**
+ * @brief Returns the value after which the counter rolls to zero.
+ *
+ * Up/down mode is modelled as up mode.
+ */
+static uint16_t timer_top(const struct host_timer_s *timer)
+{
+    uint16_t top = ((*timer->ctl & MC_3) == MC_2) ? 0xFFFF : *timer->ccr[0];
+    // The counter rolls to zero right away when CCR0 is set below it.
+    return (*timer->r > top) ? *timer->r : top;
+}
+
+static uint32_t counts_until(uint16_t r, uint16_t top, uint16_t value)
+{
+    return (value > r) ? (uint32_t)(value - r) : (uint32_t)(top - r) + 1 + value;
+}
+
+static uint32_t timer_next_event_counts(const struct host_timer_s *timer)
+{
+    uint16_t r = *timer->r;
+    uint16_t top = timer_top(timer);
+    uint32_t counts = counts_until(r, top, 0);
+
+    for (uint8_t i = 0; i < TIMER_CHANNEL_CNT; i++) {
+        uint16_t ccr = *timer->ccr[i];
+        if (!(*timer->cctl[i] & CAP) && ccr <= top) {
+            uint32_t d = counts_until(r, top, ccr);
+            if (d < counts) counts = d;
+        }
+    }
+    return counts;
+}
+
+static void timer_compare_event(struct host_timer_s *timer, uint8_t channel)
+{
+    *timer->cctl[channel] |= CCIFG;
+
+    // Output action when the counter reaches CCRx.
+    switch (*timer->cctl[channel] & OUTMOD_7) {
+    case OUTMOD_1:
+    case OUTMOD_3:
+        timer->out[channel] = true;
+        break;
+    case OUTMOD_2:
+    case OUTMOD_4:
+    case OUTMOD_6:
+        timer->out[channel] = !timer->out[channel];
+        break;
+    case OUTMOD_5:
+    case OUTMOD_7:
+        timer->out[channel] = false;
+        break;
+    default:
+        break;
+    }
+
+    if (channel != 0) return;
+
+    // Output action of the other channels when the counter reaches CCR0.
+    for (uint8_t i = 1; i < TIMER_CHANNEL_CNT; i++) {
+        switch (*timer->cctl[i] & OUTMOD_7) {
+        case OUTMOD_2:
+        case OUTMOD_3:
+            timer->out[i] = false;
+            break;
+        case OUTMOD_6:
+        case OUTMOD_7:
+            timer->out[i] = true;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static void timer_count(struct host_timer_s *timer, uint64_t counts)
+{
+    while (counts > 0) {
+        uint32_t next = timer_next_event_counts(timer);
+        uint32_t step = (counts < next) ? (uint32_t)counts : next;
+        uint16_t top = timer_top(timer);
+        uint32_t r = *timer->r + step;
+
+        *timer->r = (r > top) ? 0 : (uint16_t)r;
+        counts -= step;
+        if (step != next) break;
+
+        if (*timer->r == 0) {
+            *timer->ctl |= TAIFG;
+        }
+        for (uint8_t i = 0; i < TIMER_CHANNEL_CNT; i++) {
+            if (!(*timer->cctl[i] & CAP) && *timer->ccr[i] == *timer->r) {
+                timer_compare_event(timer, i);
+            }
+        }
+    }
+}
+
+static uint64_t ps_until(uint64_t counts, uint64_t phase, uint32_t hz)
+{
+    return (counts * PS_PER_S - phase + hz - 1) / hz;
+}
+
+static void timers_advance(uint64_t dt_ps)
+{
+    for (uint8_t i = 0; i < TIMER_CNT; i++) {
+        struct host_timer_s *timer = &timers[i];
+        uint32_t hz = timer_hz(timer);
+        if (hz == 0) continue;
+
+        timer->phase += dt_ps * hz;
+        uint64_t counts = timer->phase / PS_PER_S;
+        timer->phase %= PS_PER_S;
+        timer_count(timer, counts);
+    }
+}
+
+/**
+ * @brief Returns whether a capture channel takes its input from ACLK (CCIxB of TA0.0 and TA0.2).
+ */
+static bool is_aclk_capture(uint8_t timer, uint8_t channel)
+{
+    uint16_t cctl = *timers[timer].cctl[channel];
+    return timer == 0 && channel != 1 && (cctl & CAP) && (cctl & CM_3)
+        && (cctl & CCIS_3) == CCIS_1;
+}
+
+static bool any_aclk_capture(void)
+{
+    for (uint8_t ch = 0; ch < TIMER_CHANNEL_CNT; ch++) {
+        if (is_aclk_capture(0, ch)) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Advances ACLK and latches the counter of the ACLK capture channels on each edge.
+ *
+ * Every edge is modelled as the selected one, so CM_2 captures on rising edges too.
+ * @note advance() splits its steps at ACLK edges while a capture is active.
+ */
+static void aclk_advance(uint64_t dt_ps)
+{
+    aclk_phase += dt_ps * aclk_hz();
+    if (aclk_phase < PS_PER_S) return;
+    aclk_phase %= PS_PER_S;
+
+    for (uint8_t ch = 0; ch < TIMER_CHANNEL_CNT; ch++) {
+        if (!is_aclk_capture(0, ch)) continue;
+        *timers[0].ccr[ch] = *timers[0].r;
+        if (*timers[0].cctl[ch] & CCIFG) *timers[0].cctl[ch] |= COV;
+        *timers[0].cctl[ch] |= CCIFG;
+    }
+}
+
+static const uint32_t wdt_intervals[] = { 32768, 8192, 512, 64 };
+
+static uint32_t wdt_hz(void)
+{
+    if (REG(WDTCTL) & WDTHOLD) return 0;
+    return (REG(WDTCTL) & WDTSSEL) ? aclk_hz() : smclk_hz();
+}
+
+static void wdt_advance(uint64_t dt_ps)
+{
+    uint32_t hz = wdt_hz();
+    if (hz == 0) return;
+
+    wdt_phase += dt_ps * hz;
+    wdt_cnt += wdt_phase / PS_PER_S;
+    wdt_phase %= PS_PER_S;
+
+    uint32_t interval = wdt_intervals[REG(WDTCTL) & (WDTIS1 | WDTIS0)];
+    if (wdt_cnt >= interval) {
+        if (!(REG(WDTCTL) & WDTTMSEL)) {
+            fprintf(stderr, "host: watchdog reset at %.3f ms\n", (double)now_ps / PS_PER_MS);
+            host_finish(EXIT_FAILURE);
+        }
+        REG(IFG1) |= WDTIFG;
+        wdt_cnt %= interval;
+    }
+}
+
+// --- Private Function Definitions: UART ---
+
+/**
+ * @brief Returns the frame duration set by the USCI_A0 divider, or 0 while it is held in reset.
+ */
+static uint64_t uart_frame_ps(void)
+{
+    uint8_t ctl1 = REG(UCA0CTL1);
+    if (ctl1 & UCSWRST) return 0;
+
+    uint32_t hz = ((ctl1 & UCSSEL_3) == UCSSEL_1) ? aclk_hz() : (ctl1 & UCSSEL_3) ? smclk_hz() : 0;
+    if (hz == 0) return 0;
+
+    uint16_t br = REG(UCA0BR0) | ((uint16_t)REG(UCA0BR1) << 8);
+    uint8_t mctl = REG(UCA0MCTL);
+    double cycles = (mctl & UCOS16) ? 16.0 * br + (mctl >> 4) : br + ((mctl >> 1) & 7) / 8.0;
+    uint64_t ps = (uint64_t)(UART_FRAME_BITS * cycles * PS_PER_S / hz);
+    return ps > 0 ? ps : 1;
+}
+
+static uint64_t uart_rx_frame_ps(void)
+{
+    return UART_FRAME_BITS * PS_PER_S / uart_baud;
+}
+
+/**
+ * @brief Moves the byte written to UCA0TXBUF into the shift register.
+ */
+static void uart_tx_load(void)
+{
+    uart_tx_shift = (uint8_t)REG(UCA0TXBUF);
+    REG(UCA0TXBUF) = UART_TXBUF_EMPTY;
+    REG(IFG2) |= UCA0TXIFG;
+    REG(UCA0STAT) |= UCBUSY;
+    uart_tx_busy = true;
+    uart_tx_end_ps = now_ps + uart_frame_ps();
+}
+
+static void uart_apply_writes(void)
+{
+    if (REG(UCA0CTL1) & UCSWRST) {
+        // Software reset: aborts the transfers and clears the interrupt enables.
+        REG(IE2) &= ~(UCA0RXIE | UCA0TXIE);
+        REG(IFG2) = (REG(IFG2) & ~UCA0RXIFG) | UCA0TXIFG;
+        REG(UCA0STAT) = 0;
+        REG(UCA0TXBUF) = UART_TXBUF_EMPTY;
+        uart_tx_busy = false;
+        return;
+    }
+    if (REG(UCA0TXBUF) != UART_TXBUF_EMPTY) {
+        REG(IFG2) &= ~UCA0TXIFG;
+        if (!uart_tx_busy) uart_tx_load();
+    }
+}
+
+/**
+ * @brief Returns the time until the next frame ends, in ps, or UINT64_MAX if none.
+ */
+static uint64_t uart_next_event_ps(void)
+{
+    uint64_t ps = UINT64_MAX;
+    if (uart_tx_busy) ps = uart_tx_end_ps - now_ps;
+    if (uart_rx_pos < uart_rx_cnt && uart_rx_end_ps - now_ps < ps) ps = uart_rx_end_ps - now_ps;
+    return ps;
+}
+
+/**
+ * @brief Receives one byte on UCA0RXD, checking the divider against the sender's baud rate.
+ */
+static void uart_receive(uint8_t byte)
+{
+    uint64_t frame = uart_frame_ps();
+    uint64_t expected = uart_rx_frame_ps();
+    if (frame == 0) return; // Held in reset: the byte is lost.
+
+    if (fabs((double)frame - expected) > UART_BAUD_TOLERANCE * expected) {
+        REG(UCA0STAT) |= UCFE | UCRXERR;
+        uart_stats_framing++;
+        return;
+    }
+    if (REG(IFG2) & UCA0RXIFG) {
+        REG(UCA0STAT) |= UCOE | UCRXERR;
+        uart_stats_overruns++;
+    }
+    REG(UCA0RXBUF) = byte;
+    REG(IFG2) |= UCA0RXIFG;
+    uart_stats_received++;
+}
+
+/**
+ * @brief Completes the frames that ended by now.
+ * @note advance() splits its steps at the end of each frame.
+ */
+static void uart_advance(void)
+{
+    if (uart_tx_busy && now_ps >= uart_tx_end_ps) {
+        uart_tx_busy = false;
+        REG(UCA0STAT) &= ~UCBUSY;
+        uart_stats_sent++;
+        if (uart_tx_file != NULL) fputc(uart_tx_shift, uart_tx_file);
+        if (REG(UCA0TXBUF) != UART_TXBUF_EMPTY) uart_tx_load();
+    }
+
+    if (uart_rx_pos < uart_rx_cnt && now_ps >= uart_rx_end_ps) {
+        uart_receive(uart_rx_queue[uart_rx_pos++].byte);
+        if (uart_rx_pos < uart_rx_cnt) {
+            uint64_t start = uart_rx_queue[uart_rx_pos].at_ps;
+            uart_rx_end_ps = ((start > now_ps) ? start : now_ps) + uart_rx_frame_ps();
+        }
+    }
+}
+
+// --- Private Function Definitions: I2C ---
+
+/**
+ * @brief 24C02-style memory: the first byte written sets the pointer, which
+ * auto-increments over the following writes and reads.
+ */
+static void i2c_mem_start(bool is_read)
+{
+    if (!is_read) i2c_mem_has_pointer = false;
+}
+
+static bool i2c_mem_write(uint8_t byte)
+{
+    if (!i2c_mem_has_pointer) {
+        i2c_mem_pointer = byte;
+        i2c_mem_has_pointer = true;
+    } else {
+        i2c_mem[i2c_mem_pointer++] = byte;
+    }
+    return true;
+}
+
+static uint8_t i2c_mem_read(void)
+{
+    return i2c_mem[i2c_mem_pointer++];
+}
+
+/**
+ * @brief AS5600 magnetic encoder turning at a constant HOST_AS5600_RPM with the
+ * magnet detected. The angle refreshes every 150 us and is latched for each
+ * read. Reads that start on a RAW ANGLE or ANGLE high byte repeat the same two
+ * registers, other reads auto-increment. Configuration writes are ignored.
+ */
+static uint16_t as5600_current_angle(void)
+{
+    uint64_t sample_ps = now_ps - now_ps % AS5600_SAMPLE_PS;
+    double turns = (double)sample_ps / PS_PER_S * as5600_rpm / 60.0;
+    return (uint16_t)((turns - floor(turns)) * 4096.0) & 0x0FFF;
+}
+
+static void as5600_start(bool is_read)
+{
+    if (is_read) {
+        as5600_read_start = as5600_pointer;
+        as5600_angle = as5600_current_angle();
+    } else {
+        as5600_has_pointer = false;
+    }
+}
+
+static bool as5600_write(uint8_t byte)
+{
+    if (!as5600_has_pointer) {
+        as5600_pointer = byte;
+        as5600_has_pointer = true;
+    }
+    return true;
+}
+
+static uint8_t as5600_read(void)
+{
+    uint8_t value = 0;
+    switch (as5600_pointer) {
+    case 0x0B:
+        value = AS5600_STATUS_MD;
+        break;
+    case 0x0C:
+    case 0x0E:
+        value = (uint8_t)(as5600_angle >> 8);
+        break;
+    case 0x0D:
+    case 0x0F:
+        value = (uint8_t)as5600_angle;
+        break;
+    default:
+        break; // AGC, MAGNITUDE and the configuration read as 0.
+    }
+
+    bool is_wrapping = as5600_read_start == 0x0C || as5600_read_start == 0x0E
+        || as5600_read_start == 0x1B;
+    if (is_wrapping && as5600_pointer == as5600_read_start + 1) {
+        as5600_pointer = as5600_read_start;
+    } else {
+        as5600_pointer++;
+    }
+    return value;
+}
+
+/**
+ * @brief Returns the time until the next edge of the AS5600 PWM output, in ps, or UINT64_MAX if none.
+ */
+static uint64_t as5600_pwm_next_event_ps(void)
+{
+    if (as5600_pwm_hz <= 0.0) return UINT64_MAX;
+    return (as5600_pwm_edge_ps > now_ps) ? as5600_pwm_edge_ps - now_ps : 0;
+}
+
+/**
+ * @brief Drives the AS5600 PWM output on P2.1: each frame is high for 128 + angle
+ * of its 4351 clocks, with the angle of the frame start.
+ * @note advance() splits its steps at each edge.
+ */
+static void as5600_pwm_advance(void)
+{
+    if (as5600_pwm_next_event_ps() != 0) return;
+
+    uint16_t mask = 1u << AS5600_PWM_PIN;
+    input_driven |= mask;
+    if (input_levels & mask) {
+        input_levels &= ~mask;
+        as5600_pwm_edge_ps = as5600_pwm_frame_end_ps;
+    } else {
+        uint64_t frame_ps = (uint64_t)(PS_PER_S / as5600_pwm_hz);
+        uint64_t high_clocks = AS5600_PWM_HEADER_CLOCKS + as5600_current_angle();
+        input_levels |= mask;
+        as5600_pwm_frame_end_ps = now_ps + frame_ps;
+        as5600_pwm_edge_ps = now_ps + frame_ps * high_clocks / AS5600_PWM_FRAME_CLOCKS;
+    }
+}
+
+static const struct host_i2c_device_s i2c_devices[] = {
+    { I2C_MEM_ADDRESS, i2c_mem_start, i2c_mem_write, i2c_mem_read },
+    { AS5600_ADDRESS, as5600_start, as5600_write, as5600_read },
+};
+
+static bool i2c_is_enabled(void)
+{
+    return (REG(UCB0CTL0) & (UCMODE_3 | UCSYNC)) == (UCMODE_3 | UCSYNC)
+        && !(REG(UCB0CTL1) & UCSWRST);
+}
+
+/**
+ * @brief Returns the USCI_B0 bit clock period, the same for I2C and SPI.
+ */
+static uint64_t ucb0_bit_ps(void)
+{
+    uint16_t br = REG(UCB0BR0) | ((uint16_t)REG(UCB0BR1) << 8);
+    uint32_t hz = smclk_hz();
+    uint64_t ps = (hz != 0) ? (uint64_t)(br ? br : 1) * PS_PER_S / hz : PS_PER_MS;
+    return ps > 0 ? ps : 1;
+}
+
+static void i2c_begin_phase(enum host_i2c_phase_e phase, uint8_t bits)
+{
+    i2c_phase = phase;
+    i2c_phase_end_ps = now_ps + bits * ucb0_bit_ps();
+    REG(UCB0STAT) |= UCBBUSY;
+}
+
+/**
+ * @brief Starts the next bus phase when the master waits for the firmware.
+ */
+static void i2c_step(void)
+{
+    if (i2c_phase != I2C_PHASE_IDLE && i2c_phase != I2C_PHASE_WAIT) return;
+
+    uint8_t ctl1 = REG(UCB0CTL1);
+    if (ctl1 & UCTXSTT) {
+        // (Repeated) START. The transmitter can load its first byte during the address.
+        i2c_is_read = !(ctl1 & UCTR);
+        i2c_is_nacked = false;
+        i2c_device = NULL;
+        i2c_stats_starts++;
+        if (!i2c_is_read) REG(IFG2) |= UCB0TXIFG;
+        i2c_begin_phase(I2C_PHASE_ADDRESS, I2C_ADDRESS_BITS);
+    } else if (i2c_phase == I2C_PHASE_IDLE) {
+        return;
+    } else if (ctl1 & UCTXSTP) {
+        i2c_begin_phase(I2C_PHASE_STOP, 1);
+    } else if (i2c_is_nacked) {
+        return;
+    } else if (!i2c_is_read && REG(UCB0TXBUF) != I2C_TXBUF_EMPTY) {
+        i2c_tx_shift = (uint8_t)REG(UCB0TXBUF);
+        REG(UCB0TXBUF) = I2C_TXBUF_EMPTY;
+        REG(IFG2) |= UCB0TXIFG;
+        i2c_begin_phase(I2C_PHASE_TX_BYTE, I2C_BYTE_BITS);
+    } else if (i2c_is_read && !i2c_is_rx_held) {
+        i2c_begin_phase(I2C_PHASE_RX_BYTE, I2C_BYTE_BITS);
+    }
+}
+
+/**
+ * @brief Sets the NACK flag, which leaves the master waiting for a START or a STOP.
+ */
+static void i2c_nack(void)
+{
+    i2c_is_nacked = true;
+    i2c_stats_nacks++;
+    REG(UCB0STAT) |= UCNACKIFG;
+}
+
+/**
+ * @brief Moves UCB0TXBUF to the SPI shift register: TXIFG is set again and the byte takes 8 bits.
+ */
+static void spi_load_shifter(void)
+{
+    REG(UCB0TXBUF) = I2C_TXBUF_EMPTY;
+    REG(IFG2) |= UCB0TXIFG;
+    REG(UCB0STAT) |= UCBUSY;
+    spi_is_shifting = true;
+    spi_shift_end_ps = now_ps + 8 * ucb0_bit_ps();
+    spi_stats_bytes++;
+}
+
+/**
+ * @brief SPI master mode: the buffer waits while the shift register is busy.
+ */
+static void spi_apply_writes(void)
+{
+    if (REG(UCB0CTL1) & UCSWRST) {
+        REG(UCB0TXBUF) = I2C_TXBUF_EMPTY;
+        REG(IFG2) |= UCB0TXIFG;
+        REG(UCB0STAT) &= ~UCBUSY;
+        spi_is_shifting = false;
+        return;
+    }
+    if (REG(UCB0TXBUF) != I2C_TXBUF_EMPTY) {
+        if (spi_is_shifting) {
+            REG(IFG2) &= ~UCB0TXIFG;
+        } else {
+            spi_load_shifter();
+        }
+    }
+}
+
+/**
+ * @brief Returns the time until the byte being shifted ends, in ps, or UINT64_MAX if none.
+ */
+static uint64_t spi_next_event_ps(void)
+{
+    if (!spi_is_shifting) return UINT64_MAX;
+    return (spi_shift_end_ps > now_ps) ? spi_shift_end_ps - now_ps : 0;
+}
+
+/**
+ * @brief Ends the byte shifted by now, and starts the buffered one if any.
+ */
+static void spi_advance(void)
+{
+    if (spi_next_event_ps() != 0) return;
+
+    spi_is_shifting = false;
+    if (REG(UCB0TXBUF) != I2C_TXBUF_EMPTY) {
+        spi_load_shifter();
+    } else {
+        REG(UCB0STAT) &= ~UCBUSY;
+    }
+}
+
+static void i2c_apply_writes(void)
+{
+    if ((REG(UCB0CTL0) & (UCMODE_3 | UCSYNC)) != (UCMODE_3 | UCSYNC)) {
+        spi_apply_writes();
+        return;
+    }
+    if (REG(UCB0CTL1) & UCSWRST) {
+        // Software reset: releases the bus and clears the interrupt enables and flags.
+        REG(IE2) &= ~(UCB0RXIE | UCB0TXIE);
+        REG(IFG2) &= ~(UCB0RXIFG | UCB0TXIFG);
+        REG(UCB0I2CIE) = 0;
+        REG(UCB0STAT) = 0;
+        REG(UCB0CTL1) &= ~(UCTXSTT | UCTXSTP);
+        REG(UCB0TXBUF) = I2C_TXBUF_EMPTY;
+        i2c_phase = I2C_PHASE_IDLE;
+        i2c_device = NULL;
+        i2c_is_rx_held = false;
+        return;
+    }
+    if (REG(UCB0TXBUF) != I2C_TXBUF_EMPTY) {
+        REG(IFG2) &= ~UCB0TXIFG;
+    }
+    i2c_step();
+}
+
+/**
+ * @brief Returns the time until the current bus phase ends, in ps, or UINT64_MAX if none.
+ */
+static uint64_t i2c_next_event_ps(void)
+{
+    if (i2c_phase == I2C_PHASE_IDLE || i2c_phase == I2C_PHASE_WAIT) return UINT64_MAX;
+    return (i2c_phase_end_ps > now_ps) ? i2c_phase_end_ps - now_ps : 0;
+}
+
+/**
+ * @brief Completes the bus phase that ended by now.
+ * @note advance() splits its steps at the end of each phase.
+ */
+static void i2c_advance(void)
+{
+    if (i2c_next_event_ps() != 0 || !i2c_is_enabled()) return;
+
+    switch (i2c_phase) {
+    case I2C_PHASE_ADDRESS:
+        REG(UCB0CTL1) &= ~UCTXSTT;
+        for (size_t i = 0; i < ARRAY_SIZE(i2c_devices); i++) {
+            if (i2c_devices[i].address == (REG(UCB0I2CSA) & 0x7F)) i2c_device = &i2c_devices[i];
+        }
+        if (i2c_device != NULL) {
+            i2c_device->start(i2c_is_read);
+        } else {
+            i2c_nack();
+        }
+        break;
+    case I2C_PHASE_TX_BYTE:
+        i2c_stats_bytes++;
+        if (!i2c_device->write(i2c_tx_shift)) i2c_nack();
+        break;
+    case I2C_PHASE_RX_BYTE: {
+        // A STOP or START requested during the byte NACKs it.
+        uint8_t byte = i2c_device->read();
+        i2c_stats_bytes++;
+        if (REG(IFG2) & UCB0RXIFG) {
+            i2c_rx_held = byte; // SCL is held until UCB0RXBUF is read.
+            i2c_is_rx_held = true;
+        } else {
+            REG(UCB0RXBUF) = byte;
+            REG(IFG2) |= UCB0RXIFG;
+        }
+        break;
+    }
+    case I2C_PHASE_STOP:
+        REG(UCB0CTL1) &= ~UCTXSTP;
+        REG(UCB0STAT) &= ~UCBBUSY;
+        i2c_phase = I2C_PHASE_IDLE;
+        i2c_device = NULL;
+        i2c_step();
+        return;
+    default:
+        return;
+    }
+    i2c_phase = I2C_PHASE_WAIT;
+    i2c_step();
+}
+
+// --- Private Function Definitions: ADC10 ---
+
+static bool adc_is_enabled(void)
+{
+    return (REG(ADC10CTL0) & (ADC10ON | ENC)) == (ADC10ON | ENC);
+}
+
+/**
+ * @brief Returns the level of the sample-and-hold source: ADC10SC, TA0.1, TA0.0 or TA0.2.
+ */
+static bool adc_shs_level(void)
+{
+    static const int8_t channels[] = { -1, 1, 0, 2 };
+    int8_t channel = channels[(REG(ADC10CTL1) >> 10) & 3];
+    return channel >= 0 && timers[0].out[channel];
+}
+
+static uint64_t adc_conversion_ps(void)
+{
+    static const uint8_t sample_clocks[] = { 4, 8, 16, 64 };
+    uint32_t hz;
+    switch (REG(ADC10CTL1) & ADC10SSEL_3) {
+    case ADC10SSEL_0:
+        hz = ADC_OSC_HZ;
+        break;
+    case ADC10SSEL_3:
+        hz = smclk_hz();
+        break;
+    case ADC10SSEL_2:
+        hz = mclk_hz();
+        break;
+    default:
+        hz = aclk_hz();
+        break;
+    }
+    uint32_t divider = ((REG(ADC10CTL1) >> 5) & 7) + 1;
+    uint32_t clocks = sample_clocks[(REG(ADC10CTL0) >> 11) & 3] + ADC_CONVERSION_CLOCKS;
+    return (hz != 0) ? (uint64_t)clocks * divider * PS_PER_S / hz : PS_PER_MS;
+}
+
+/**
+ * @brief Input voltage of a channel: the AS5600 analog output on A5 (0 to
+ * VCC over a turn), the temperature sensor on A10 and VCC/2 on A11. Other
+ * channels read 0 V.
+ */
+static double adc_channel_volts(uint8_t channel)
+{
+    switch (channel) {
+    case 5:
+        return (REG(ADC10AE0) & BIT5) ? as5600_current_angle() * ADC_VCC / 4096.0 : 0.0;
+    case 10:
+        return 0.986 + 0.00355 * ADC_TEMP_C;
+    case 11:
+        return ADC_VCC / 2;
+    default:
+        return 0.0;
+    }
+}
+
+static uint16_t adc_convert(uint8_t channel)
+{
+    double vref = !(REG(ADC10CTL0) & SREF_1) ? ADC_VCC
+        : (REG(ADC10CTL0) & REF2_5V)          ? 2.5
+                                               : 1.5;
+    double code = adc_channel_volts(channel) / vref * ADC_FULL_SCALE + 0.5;
+    return (code < ADC_FULL_SCALE) ? (uint16_t)code : ADC_FULL_SCALE;
+}
+
+static void adc_start_conversion(void)
+{
+    if (adc_is_converting) {
+        adc_stats_missed++;
+        return;
+    }
+    adc_is_converting = true;
+    adc_conversion_end_ps = now_ps + adc_conversion_ps();
+    REG(ADC10CTL1) |= ADC10BUSY;
+}
+
+/**
+ * @brief Stores a result through the DTC, in one- or two-block mode.
+ *
+ * Without the DTC (ADC10DTC1 = 0), ADC10IFG is set by every conversion.
+ */
+static void adc_store(uint16_t value)
+{
+    REG(ADC10MEM) = value;
+    uint8_t block_len = REG(ADC10DTC1);
+    bool is_two_block = REG(ADC10DTC0) & ADC10TB;
+    uint16_t total = is_two_block ? 2 * block_len : block_len;
+    if (block_len == 0) {
+        REG(ADC10CTL0) |= ADC10IFG;
+        return;
+    }
+    if (adc_dtc_pos >= total) return; // A single pass ended
+
+    ((uint16_t *)REG(ADC10SA))[adc_dtc_pos++] = value;
+    if (is_two_block && adc_dtc_pos == block_len) {
+        REG(ADC10DTC0) |= ADC10B1;
+    } else if (adc_dtc_pos == total) {
+        REG(ADC10DTC0) &= ~ADC10B1;
+        if (REG(ADC10DTC0) & ADC10CT) adc_dtc_pos = 0;
+    } else {
+        return;
+    }
+    adc_stats_blocks++;
+    REG(ADC10CTL0) |= ADC10IFG;
+}
+
+static void adc_apply_writes(void)
+{
+    // The DTC restarts from the first block when ADC10SA is written.
+    if (REG(ADC10SA) != adc_dtc_start || REG(ADC10DTC1) == 0) {
+        adc_dtc_start = REG(ADC10SA);
+        adc_dtc_pos = 0;
+        REG(ADC10DTC0) &= ~ADC10B1;
+    }
+
+    bool is_enabled = adc_is_enabled();
+    if (is_enabled && !adc_is_enabled_prev) {
+        adc_channel = REG(ADC10CTL1) >> 12;
+    }
+    if (!is_enabled && (REG(ADC10CTL1) & CONSEQ_3) == CONSEQ_0) {
+        // Any mode stops at once with ENC and CONSEQ cleared.
+        adc_is_converting = false;
+        REG(ADC10CTL1) &= ~ADC10BUSY;
+    }
+    adc_is_enabled_prev = is_enabled;
+
+    if (REG(ADC10CTL0) & ADC10SC) {
+        REG(ADC10CTL0) &= ~ADC10SC;
+        if (is_enabled && (REG(ADC10CTL1) & SHS_3) == SHS_0) adc_start_conversion();
+    }
+    adc_trigger_level = adc_shs_level();
+}
+
+/**
+ * @brief Returns the time until the conversion in progress ends, in ps, or UINT64_MAX if none.
+ */
+static uint64_t adc_next_event_ps(void)
+{
+    if (!adc_is_converting) return UINT64_MAX;
+    return (adc_conversion_end_ps > now_ps) ? adc_conversion_end_ps - now_ps : 0;
+}
+
+/**
+ * @brief Completes a conversion that ended by now, then starts one on a rising
+ * edge of the timer trigger.
+ *
+ * Sequence modes step down from INCH to A0 and start over, so CONSEQ_1 is
+ * modelled as CONSEQ_3 and CONSEQ_0 as CONSEQ_2.
+ * @note advance() splits its steps at the end of each conversion.
+ */
+static void adc_advance(void)
+{
+    if (adc_is_converting && adc_next_event_ps() == 0) {
+        adc_is_converting = false;
+        REG(ADC10CTL1) &= ~ADC10BUSY;
+        adc_stats_conversions++;
+        adc_store(adc_convert(adc_channel));
+        uint8_t top = REG(ADC10CTL1) >> 12;
+        bool is_sequence = REG(ADC10CTL1) & CONSEQ_1;
+        adc_channel = (is_sequence && adc_channel > 0) ? adc_channel - 1 : top;
+    }
+
+    bool level = adc_shs_level();
+    if (level && !adc_trigger_level && adc_is_enabled() && (REG(ADC10CTL1) & SHS_3) != SHS_0) {
+        adc_start_conversion();
+    }
+    adc_trigger_level = level;
+}
+
+// --- Private Function Definitions: Core ---
+
+/**
+ * @brief Applies the side effects of register writes made since the last sync.
+ */
+static void apply_writes(void)
+{
+    uint16_t wdtctl = REG(WDTCTL);
+    if ((wdtctl & 0xFF00) != WDTCTL_READ_KEY) {
+        if ((wdtctl & 0xFF00) != WDTPW) {
+            fprintf(stderr, "host: watchdog password violation (WDTCTL = 0x%04X)\n", wdtctl);
+            host_finish(EXIT_FAILURE);
+        }
+        if (wdtctl & WDTCNTCL) {
+            wdt_cnt = 0;
+            wdt_phase = 0;
+        }
+        REG(WDTCTL) = WDTCTL_READ_KEY | (wdtctl & 0xFF & ~WDTCNTCL);
+    }
+
+    for (uint8_t i = 0; i < TIMER_CNT; i++) {
+        struct host_timer_s *timer = &timers[i];
+        if (*timer->ctl & TACLR) {
+            *timer->ctl &= ~TACLR;
+            *timer->r = 0;
+            timer->phase = 0;
+        }
+        for (uint8_t ch = 0; ch < TIMER_CHANNEL_CNT; ch++) {
+            if ((*timer->cctl[ch] & OUTMOD_7) == OUTMOD_0) {
+                timer->out[ch] = *timer->cctl[ch] & OUT;
+            }
+        }
+    }
+
+    i2c_apply_writes();
+    uart_apply_writes();
+    adc_apply_writes();
+}
+
+static void advance(uint64_t dt_ps)
+{
+    // Active, then LPM0 to LPM3 selected by SCG1:SCG0, then LPM4.
+    uint8_t mode = !(sr & CPUOFF) ? 0 : (sr & OSCOFF) ? 5 : 1 + ((sr >> 6) & 3);
+
+    while (dt_ps > 0) {
+        uint64_t step = (dt_ps < MAX_STEP_PS) ? dt_ps : MAX_STEP_PS;
+        if (any_aclk_capture()) {
+            uint64_t to_edge = ps_until(1, aclk_phase, aclk_hz());
+            if (to_edge < step) step = to_edge;
+        }
+        uint64_t to_frame_end = uart_next_event_ps();
+        if (to_frame_end < step) step = to_frame_end;
+        uint64_t to_phase_end = i2c_next_event_ps();
+        if (to_phase_end < step) step = to_phase_end;
+        uint64_t to_shift_end = spi_next_event_ps();
+        if (to_shift_end < step) step = to_shift_end;
+        uint64_t to_conversion_end = adc_next_event_ps();
+        if (to_conversion_end < step) step = to_conversion_end;
+        uint64_t to_pwm_edge = as5600_pwm_next_event_ps();
+        if (to_pwm_edge < step) step = to_pwm_edge;
+        mode_ps[mode] += step;
+        timers_advance(step);
+        wdt_advance(step);
+        aclk_advance(step);
+        now_ps += step;
+        dt_ps -= step;
+        uart_advance();
+        i2c_advance();
+        spi_advance();
+        adc_advance();
+        as5600_pwm_advance();
+        apply_due_inputs();
+        update_pins();
+
+        if (now_ps >= end_ps) {
+            host_finish(EXIT_SUCCESS);
+        }
+    }
+}
+
+/**
+ * @brief Returns the highest priority pending and enabled interrupt, or -1.
+ */
+static int8_t pending_vector(void)
+{
+    const struct host_timer_s *t0 = &timers[0];
+    const struct host_timer_s *t1 = &timers[1];
+#define CC_PENDING(timer, ch) ((*(timer)->cctl[ch] & (CCIE | CCIFG)) == (CCIE | CCIFG))
+#define OV_PENDING(timer) ((*(timer)->ctl & (TAIE | TAIFG)) == (TAIE | TAIFG))
+
+    if (CC_PENDING(t1, 0)) return TIMER1_A0_VECTOR;
+    if (CC_PENDING(t1, 1) || CC_PENDING(t1, 2) || OV_PENDING(t1)) return TIMER1_A1_VECTOR;
+    if (REG(IE1) & REG(IFG1) & WDTIE) return WDT_VECTOR;
+    if (CC_PENDING(t0, 0)) return TIMER0_A0_VECTOR;
+    if (CC_PENDING(t0, 1) || CC_PENDING(t0, 2) || OV_PENDING(t0)) return TIMER0_A1_VECTOR;
+    // In I2C mode, USCI_B0 raises its data flags on the TX vector and its state flags on RX.
+    bool is_i2c = (REG(UCB0CTL0) & (UCMODE_3 | UCSYNC)) == (UCMODE_3 | UCSYNC);
+    uint8_t rx_flags = is_i2c ? UCA0RXIFG : (UCA0RXIFG | UCB0RXIFG);
+    uint8_t tx_flags = is_i2c ? (UCA0TXIFG | UCB0TXIFG | UCB0RXIFG) : (UCA0TXIFG | UCB0TXIFG);
+    if (REG(IE2) & REG(IFG2) & rx_flags) return USCIAB0RX_VECTOR;
+    if (is_i2c && (REG(UCB0I2CIE) & REG(UCB0STAT) & (UCNACKIE | UCALIE))) return USCIAB0RX_VECTOR;
+    if (REG(IE2) & REG(IFG2) & tx_flags) return USCIAB0TX_VECTOR;
+    if ((REG(ADC10CTL0) & (ADC10IE | ADC10IFG)) == (ADC10IE | ADC10IFG)) return ADC10_VECTOR;
+    if (REG(P2IE) & REG(P2IFG)) return PORT2_VECTOR;
+    if (REG(P1IE) & REG(P1IFG)) return PORT1_VECTOR;
+    return -1;
+
+#undef CC_PENDING
+#undef OV_PENDING
+}
+
+static void deliver_interrupts(void)
+{
+    int8_t vector;
+
+    // A register written just before, e.g. UCA0TXBUF, may have cleared a flag.
+    apply_writes();
+    while ((sr & GIE) && (vector = pending_vector()) >= 0) {
+        host_isr_t isr = isr_table[vector];
+        if (isr == NULL) {
+            fprintf(stderr, "host: no ISR for pending %s interrupt\n", vector_names[vector]);
+            host_finish(EXIT_FAILURE);
+        }
+        if (isr_depth == ISR_NESTING_MAX) {
+            fprintf(stderr, "host: ISR nesting too deep\n");
+            host_finish(EXIT_FAILURE);
+        }
+
+        // Single-source flags are cleared by the interrupt acceptance.
+        if (vector == TIMER0_A0_VECTOR) *timers[0].cctl[0] &= ~CCIFG;
+        if (vector == TIMER1_A0_VECTOR) *timers[1].cctl[0] &= ~CCIFG;
+        if (vector == WDT_VECTOR) REG(IFG1) &= ~WDTIFG;
+        if (vector == ADC10_VECTOR) REG(ADC10CTL0) &= ~ADC10IFG;
+
+        saved_sr[isr_depth++] = sr;
+        sr &= SCG0;
+        advance(cycles_to_ps(ISR_ENTRY_CYCLES));
+        isr_counts[vector]++;
+        isr();
+        apply_writes();
+        advance(cycles_to_ps(ISR_RETURN_CYCLES));
+        sr = saved_sr[--isr_depth];
+    }
+}
+
+/**
+ * @brief Jumps to the next peripheral event while the CPU is off.
+ */
+static void warp(void)
+{
+    uint64_t step = end_ps - now_ps;
+
+    for (uint8_t i = 0; i < TIMER_CNT; i++) {
+        uint32_t hz = timer_hz(&timers[i]);
+        if (hz != 0) {
+            uint64_t ps = ps_until(timer_next_event_counts(&timers[i]), timers[i].phase, hz);
+            if (ps < step) step = ps;
+        }
+    }
+
+    uint32_t hz = wdt_hz();
+    if (hz != 0) {
+        uint32_t interval = wdt_intervals[REG(WDTCTL) & (WDTIS1 | WDTIS0)];
+        uint64_t ps = ps_until(interval - wdt_cnt, wdt_phase, hz);
+        if (ps < step) step = ps;
+    }
+
+    if (input_schedule_cnt > 0 && input_schedule[0].at_ps - now_ps < step) {
+        step = input_schedule[0].at_ps - now_ps;
+    }
+
+    uint64_t to_frame_end = uart_next_event_ps();
+    if (to_frame_end < step) step = to_frame_end;
+    uint64_t to_phase_end = i2c_next_event_ps();
+    if (to_phase_end < step) step = to_phase_end;
+    uint64_t to_shift_end = spi_next_event_ps();
+    if (to_shift_end < step) step = to_shift_end;
+    uint64_t to_conversion_end = adc_next_event_ps();
+    if (to_conversion_end < step) step = to_conversion_end;
+    uint64_t to_pwm_edge = as5600_pwm_next_event_ps();
+    if (to_pwm_edge < step) step = to_pwm_edge;
+
+    advance(step > 0 ? step : 1);
+}
+
+static void cpu_sleep(void)
+{
+    if (isr_depth > 0) {
+        fprintf(stderr, "host: entering a low-power mode from an ISR is not modelled\n");
+        host_finish(EXIT_FAILURE);
+    }
+    while (sr & CPUOFF) {
+        deliver_interrupts();
+        if (sr & CPUOFF) warp();
+    }
+}
+
+static void parse_inputs(const char *spec)
+{
+    char *copy = strdup(spec);
+    char *save = NULL;
+
+    for (char *item = strtok_r(copy, ",", &save); item != NULL; item = strtok_r(NULL, ",", &save)) {
+        unsigned port, bit;
+        char level;
+        double at_ms;
+
+        if (sscanf(item, " P%u.%u=%c@%lf", &port, &bit, &level, &at_ms) != 4
+            || (level != '0' && level != '1' && level != 'z')
+            || !host_schedule_input(port, bit,
+                level == '0'       ? HOST_INPUT_LOW
+                    : level == '1' ? HOST_INPUT_HIGH
+                                   : HOST_INPUT_RELEASED,
+                (uint64_t)(at_ms * 1e6))) {
+            fprintf(stderr, "host: ignoring invalid HOST_INPUT item '%s'\n", item);
+        }
+    }
+    free(copy);
+}
+
+/**
+ * @brief Queues the bytes of "at_ms:text" items separated by ';'. The text may use \n, \r and \\.
+ */
+static void parse_uart_rx(const char *spec)
+{
+    size_t capacity = strlen(spec);
+    uart_rx_queue = malloc(capacity * sizeof(*uart_rx_queue) + 1);
+    if (uart_rx_queue == NULL) {
+        perror("host: HOST_UART_RX");
+        exit(EXIT_FAILURE);
+    }
+
+    const char *p = spec;
+    while (*p != '\0') {
+        char *text;
+        double at_ms = strtod(p, &text);
+        if (text == p || *text != ':') {
+            fprintf(stderr, "host: ignoring invalid HOST_UART_RX item at '%s'\n", p);
+            break;
+        }
+        uint64_t at_ps = (uint64_t)(at_ms * PS_PER_MS);
+        for (p = text + 1; *p != '\0' && *p != ';'; p++) {
+            char c = *p;
+            if (c == '\\' && p[1] != '\0') {
+                p++;
+                c = (*p == 'n') ? '\n' : (*p == 'r') ? '\r' : *p;
+            }
+            uart_rx_queue[uart_rx_cnt++] = (struct host_uart_rx_s) { at_ps, (uint8_t)c };
+        }
+        if (*p == ';') p++;
+    }
+    if (uart_rx_cnt > 0) {
+        uart_rx_end_ps = uart_rx_queue[0].at_ps + uart_rx_frame_ps();
+    }
+}
+
+/// Early boot hook of the firmware (drivers/boot.c), run by crt0 on the target.
+extern void boot_early_init(void) __attribute__((weak));
+
+/**
+ * @brief Puts the model in its power-on state and reads the run configuration.
+ */
+__attribute__((constructor)) static void host_reset(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+
+    REG(WDTCTL) = WDTCTL_READ_KEY; // Watchdog running from SMCLK, as after a PUC.
+    REG(IFG1) = PORIFG;
+    REG(BCSCTL1) = XT2OFF | 7; // RSEL 7
+    REG(DCOCTL) = 3 << 5; // DCO tap 3, about 1.2 MHz
+    REG(BCSCTL3) = XCAP_1;
+    REG(P2SEL) = BIT6 | BIT7; // XIN/XOUT
+    REG(UCA0CTL1) = UCSWRST;
+    REG(UCB0CTL1) = UCSWRST;
+    REG(UCB0TXBUF) = I2C_TXBUF_EMPTY;
+    calibrate_dco();
+    apply_writes();
+    update_pins();
+
+    const char *run_ms = getenv("HOST_RUN_MS");
+    if (run_ms != NULL) {
+        host_set_run_time((uint64_t)(strtod(run_ms, NULL) * 1e6));
+    }
+    const char *inputs = getenv("HOST_INPUT");
+    if (inputs != NULL) {
+        parse_inputs(inputs);
+    }
+    edge_file = getenv("HOST_EDGES");
+
+    const char *uart_baud_env = getenv("HOST_UART_BAUD");
+    if (uart_baud_env != NULL && strtoul(uart_baud_env, NULL, 10) > 0) {
+        uart_baud = strtoul(uart_baud_env, NULL, 10);
+    }
+    const char *uart_rx = getenv("HOST_UART_RX");
+    if (uart_rx != NULL) {
+        parse_uart_rx(uart_rx);
+    }
+    const char *uart_tx = getenv("HOST_UART_TX");
+    if (uart_tx != NULL) {
+        uart_tx_file = fopen(uart_tx, "wb");
+        if (uart_tx_file == NULL) perror("host: HOST_UART_TX");
+    }
+    const char *as5600_rpm_env = getenv("HOST_AS5600_RPM");
+    if (as5600_rpm_env != NULL) {
+        as5600_rpm = strtod(as5600_rpm_env, NULL);
+    }
+    const char *as5600_pwm_env = getenv("HOST_AS5600_PWM_HZ");
+    if (as5600_pwm_env != NULL) {
+        as5600_pwm_hz = strtod(as5600_pwm_env, NULL);
+    }
+
+    if (boot_early_init != NULL) {
+        boot_early_init();
+    }
+}
+
+static void print_ms_stats(const char *label, uint32_t cnt, uint64_t min, uint64_t sum, uint64_t max)
+{
+    if (cnt == 0) {
+        printf("  %s %27s", label, "-");
+        return;
+    }
+    printf("  %s %8.3f/%8.3f/%8.3f", label, min / 1e6, sum / 1e6 / cnt, max / 1e6);
+}
+
+static void write_edge_file(void)
+{
+    FILE *file = fopen(edge_file, "w");
+    if (file == NULL) {
+        perror("host: HOST_EDGES");
+        return;
+    }
+    fprintf(file, "time_ns,pin,level\n");
+    for (size_t i = 0; i < edge_cnt; i++) {
+        fprintf(file, "%" PRIu64 ",P%u.%u,%u\n", edge_log[i].time_ns, edge_log[i].pin / 8 + 1,
+            edge_log[i].pin % 8, edge_log[i].level);
+    }
+    fclose(file);
+}
+
+// --- Public Function Definitions ---
+
+void host_sync(void)
+{
+    apply_writes();
+    update_pins();
+    advance(cycles_to_ps(HOST_CYCLES_PER_ACCESS));
+    deliver_interrupts();
+}
+
+uint16_t host_read_taiv(uint8_t timer)
+{
+    host_sync();
+
+    struct host_timer_s *t = &timers[timer];
+    for (uint8_t ch = 1; ch < TIMER_CHANNEL_CNT; ch++) {
+        if ((*t->cctl[ch] & (CCIE | CCIFG)) == (CCIE | CCIFG)) {
+            *t->cctl[ch] &= ~CCIFG;
+            return ch * 2;
+        }
+    }
+    if ((*t->ctl & (TAIE | TAIFG)) == (TAIE | TAIFG)) {
+        *t->ctl &= ~TAIFG;
+        return TA0IV_TAIFG;
+    }
+    return TA0IV_NONE;
+}
+
+uint8_t host_read_uca0rxbuf(void)
+{
+    host_sync();
+
+    REG(IFG2) &= ~UCA0RXIFG;
+    REG(UCA0STAT) &= ~(UCOE | UCFE | UCRXERR);
+    return REG(UCA0RXBUF);
+}
+
+uint8_t host_read_ucb0rxbuf(void)
+{
+    host_sync();
+
+    uint8_t byte = REG(UCB0RXBUF);
+    REG(IFG2) &= ~UCB0RXIFG;
+    if (i2c_is_rx_held) {
+        i2c_is_rx_held = false;
+        REG(UCB0RXBUF) = i2c_rx_held;
+        REG(IFG2) |= UCB0RXIFG;
+        i2c_step();
+    }
+    return byte;
+}
+
+void __disable_interrupt(void)
+{
+    sr &= ~GIE;
+}
+
+void __enable_interrupt(void)
+{
+    sr |= GIE;
+    deliver_interrupts();
+}
+
+void __no_operation(void)
+{
+    advance(cycles_to_ps(1));
+}
+
+uint16_t __get_SR_register(void)
+{
+    return sr;
+}
+
+void __bis_SR_register(uint16_t bits)
+{
+    sr |= bits;
+    if (sr & CPUOFF) {
+        cpu_sleep();
+    } else {
+        deliver_interrupts();
+    }
+}
+
+void __bic_SR_register(uint16_t bits)
+{
+    sr &= ~bits;
+}
+
+void __bis_SR_register_on_exit(uint16_t bits)
+{
+    if (isr_depth > 0) saved_sr[isr_depth - 1] |= bits;
+}
+
+void __bic_SR_register_on_exit(uint16_t bits)
+{
+    if (isr_depth > 0) saved_sr[isr_depth - 1] &= ~bits;
+}
+
+void __delay_cycles(uint32_t cycles)
+{
+    advance(cycles_to_ps(cycles));
+    deliver_interrupts();
+}
+
+uint64_t host_time_ns(void)
+{
+    return now_ps / PS_PER_NS;
+}
+
+void host_set_run_time(uint64_t duration_ns)
+{
+    end_ps = duration_ns * PS_PER_NS;
+}
+
+bool host_schedule_input(uint8_t port, uint8_t bit, host_input_e level, uint64_t at_ns)
+{
+    if (port < 1 || port > HOST_PORT_CNT || bit > 7 || input_schedule_cnt == INPUT_SCHEDULE_MAX) {
+        return false;
+    }
+
+    // Keep the schedule sorted, equal times in insertion order.
+    uint64_t at_ps = at_ns * PS_PER_NS;
+    uint8_t i = input_schedule_cnt;
+    while (i > 0 && input_schedule[i - 1].at_ps > at_ps) {
+        input_schedule[i] = input_schedule[i - 1];
+        i--;
+    }
+    input_schedule[i] = (struct host_input_s) { at_ps, (uint8_t)((port - 1) * 8 + bit), level };
+    input_schedule_cnt++;
+    return true;
+}
+
+const host_edge_t *host_edges(size_t *count)
+{
+    *count = edge_cnt;
+    return edge_log;
+}
+
+const host_pin_stats_t *host_pin_stats(uint8_t pin)
+{
+    return (pin < HOST_PIN_CNT) ? &pin_stats[pin] : NULL;
+}
+
+uint32_t host_isr_count(uint8_t vector)
+{
+    return (vector < HOST_VECTOR_CNT) ? isr_counts[vector] : 0;
+}
+
+void host_finish(int status)
+{
+    static const char *const mode_names[] = { "active", "LPM0", "LPM1", "LPM2", "LPM3", "LPM4" };
+    struct timespec wall_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    double wall_ms = (wall_end.tv_sec - wall_start.tv_sec) * 1e3
+        + (wall_end.tv_nsec - wall_start.tv_nsec) / 1e6;
+
+    printf("host: %.3f ms simulated in %.3f ms\n", (double)now_ps / PS_PER_MS, wall_ms);
+
+    printf("residency:");
+    for (uint8_t i = 0; i < ARRAY_SIZE(mode_names); i++) {
+        if (mode_ps[i] != 0) {
+            printf(" %s %.3f%%", mode_names[i], 100.0 * mode_ps[i] / (now_ps ? now_ps : 1));
+        }
+    }
+    printf("\ninterrupts:");
+    for (uint8_t i = 0; i < HOST_VECTOR_CNT; i++) {
+        if (isr_counts[i] != 0) printf(" %s %" PRIu32, vector_names[i], isr_counts[i]);
+    }
+    printf("\n");
+
+    for (uint8_t pin = 0; pin < HOST_PIN_CNT; pin++) {
+        const host_pin_stats_t *stats = &pin_stats[pin];
+        if (stats->rising + stats->falling == 0) continue;
+
+        printf("P%u.%u: %6" PRIu32 " rising %6" PRIu32 " falling", pin / 8 + 1, pin % 8,
+            stats->rising, stats->falling);
+        print_ms_stats("period ms", stats->rising ? stats->rising - 1 : 0, stats->period_min_ns,
+            stats->period_sum_ns, stats->period_max_ns);
+        print_ms_stats("high ms", stats->high_cnt, stats->high_min_ns, stats->high_sum_ns,
+            stats->high_max_ns);
+        printf("\n");
+    }
+
+    if (spi_stats_bytes != 0) {
+        printf("spi: %" PRIu32 " bytes\n", spi_stats_bytes);
+    }
+    if (i2c_stats_starts != 0) {
+        printf("i2c: %" PRIu32 " starts, %" PRIu32 " bytes, %" PRIu32 " nacks\n", i2c_stats_starts,
+            i2c_stats_bytes, i2c_stats_nacks);
+    }
+    if (adc_stats_conversions != 0) {
+        printf("adc: %" PRIu32 " conversions, %" PRIu32 " blocks, %" PRIu32 " missed triggers\n",
+            adc_stats_conversions, adc_stats_blocks, adc_stats_missed);
+    }
+    if (uart_stats_sent + uart_stats_received + uart_stats_overruns + uart_stats_framing != 0) {
+        printf("uart: %" PRIu32 " sent, %" PRIu32 " received, %" PRIu32 " overruns, %" PRIu32
+               " framing errors\n",
+            uart_stats_sent, uart_stats_received, uart_stats_overruns, uart_stats_framing);
+    }
+
+    if (edge_file != NULL) {
+        write_edge_file();
+    }
+    if (uart_tx_file != NULL) {
+        fclose(uart_tx_file);
+    }
+    fflush(stdout);
+    exit(status);
+}
@@ -0,0 +1,131 @@
+/**
+ * @file host.h
+ * @brief Control and inspection interface of the host emulation model.
+ *
+ * The firmware runs unmodified on the host against the stand-in msp430.h.
+ * Simulated time advances by a few MCLK cycles on each register access and
+ * jumps straight to the next peripheral event while the CPU sleeps, so hours
+ * of firmware time run in milliseconds.
+ *
+ * The run is configured from the environment before main() starts:
+ * - HOST_RUN_MS: simulated duration in milliseconds (default 10000).
+ * - HOST_INPUT: scheduled input levels, e.g. "P1.3=0@1500,P1.3=1@1620" drives
+ *   P1.3 low at 1500 ms and high at 1620 ms. "P1.3=z@2000" releases the pin.
+ * - HOST_EDGES: file receiving every recorded pin edge as CSV.
+ * - HOST_UART_RX: bytes sent to the UART, e.g. "1500:hello\r;2000:x" sends
+ *   "hello\r" from 1500 ms and "x" at 2000 ms, back to back at HOST_UART_BAUD.
+ * - HOST_UART_BAUD: baud rate of the bytes sent to the UART (default 115200).
+ *   A divider more than 3% off loses the bytes as framing errors.
+ * - HOST_UART_TX: file receiving the bytes sent by the UART.
+ * - HOST_AS5600_RPM: speed of the AS5600 magnet, negative to turn backwards (default 600).
+ * - HOST_AS5600_PWM_HZ: frequency of the AS5600 PWM output driven on P2.1, e.g.
+ *   920 (default 0: not connected).
+ *
+ * With USCI_B0 in I2C mode, the bus is timed from its divider and reaches a
+ * 24C02-style memory at address 0x50 and an AS5600 encoder at 0x36. The
+ * ADC10 converts on its trigger source, stores through the DTC and reads the
+ * AS5600 analog output on A5, the temperature sensor and VCC/2 (VCC = 3.6 V).
+ * Timer_A channels in capture mode latch their counter on the edges of their
+ * CCIxA/CCIxB pins.
+ *
+ * At the end of the run, a report of the interrupt counts, low-power mode
+ * residency and per-pin edge timing is printed on stdout.
+ */
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Public Constants ---
+
+#define HOST_PORT_CNT 2
+#define HOST_PIN_CNT (HOST_PORT_CNT * 8) ///< Pins are numbered (port - 1) * 8 + pin.
+#define HOST_VECTOR_CNT 16
+#define HOST_RUN_MS_DEFAULT 10000
+#define HOST_CYCLES_PER_ACCESS 4 ///< MCLK cycles charged to each register access.
+
+// --- Public Type Definitions ---
+
+/**
+ * @brief Level applied to an input pin from outside the chip.
+ */
+typedef enum {
+    HOST_INPUT_LOW,
+    HOST_INPUT_HIGH,
+    HOST_INPUT_RELEASED, ///< Not driven: the pin follows its pull resistor, if any.
+} host_input_e;
+
+/**
+ * @brief A change of level on a pin, as seen on the package.
+ */
+typedef struct
+{
+    uint64_t time_ns; ///< Simulated time of the edge.
+    uint8_t pin;      ///< Pin number, (port - 1) * 8 + bit.
+    bool level;       ///< Level after the edge.
+} host_edge_t;
+
+/**
+ * @brief Timing statistics of one pin, from rising edge to rising edge.
+ */
+typedef struct
+{
+    uint32_t rising;      ///< Number of rising edges.
+    uint32_t falling;     ///< Number of falling edges.
+    uint64_t period_min_ns;
+    uint64_t period_max_ns;
+    uint64_t period_sum_ns; ///< Sum over rising - 1 periods.
+    uint64_t high_min_ns;
+    uint64_t high_max_ns;
+    uint64_t high_sum_ns; ///< Sum over the completed high phases.
+    uint32_t high_cnt;
+} host_pin_stats_t;
+
+// --- Public Function Prototypes ---
+
+/**
+ * @brief Returns the simulated time since reset.
+ */
+uint64_t host_time_ns(void);
+
+/**
+ * @brief Ends the run after the given simulated time instead of HOST_RUN_MS.
+ */
+void host_set_run_time(uint64_t duration_ns);
+
+/**
+ * @brief Schedules an external level change on a pin.
+ * @param port 1 or 2.
+ * @param bit Pin within the port, 0 to 7.
+ * @param level Level to apply.
+ * @param at_ns Simulated time of the change. Past times apply immediately.
+ * @return false if the pin is invalid or the schedule is full.
+ */
+bool host_schedule_input(uint8_t port, uint8_t bit, host_input_e level, uint64_t at_ns);
+
+/**
+ * @brief Returns the recorded edges, oldest first.
+ * @param count Receives the number of edges. The log stops growing once full,
+ *              the statistics keep being updated.
+ */
+const host_edge_t *host_edges(size_t *count);
+
+/**
+ * @brief Returns the timing statistics of a pin, or NULL for an invalid pin.
+ */
+const host_pin_stats_t *host_pin_stats(uint8_t pin);
+
+/**
+ * @brief Returns how many times the ISR of a vector has run.
+ */
+uint32_t host_isr_count(uint8_t vector);
+
+/**
+ * @brief Prints the report and exits, as done automatically at the end of the run.
+ * @param status Process exit status.
+ */
+void host_finish(int status) __attribute__((noreturn));
+
+#endif // HOST_H
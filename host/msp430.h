@@ -0,0 +1,474 @@
+/**
+ * @file msp430.h
+ * @brief Stand-in for the MSP430G2553 device header, used by the host emulation build.
+ *
+ * Every peripheral register is backed by a field of host_sfr. Each access goes
+ * through host_sync(), which lets the peripheral model in host.c catch up:
+ * simulated time advances by the cost of the access, timers count, pins are
+ * sampled and pending interrupts are delivered to the firmware ISRs.
+ *
+ * Only the registers and bit names used by the drivers are provided. The bit
+ * values match the real device header.
+ */
+#ifndef HOST_MSP430_H
+#define HOST_MSP430_H
+
+#include <stdint.h>
+
+// --- Register Storage ---
+
+/**
+ * @brief X-macro listing the emulated registers: X(type, name).
+ */
+#define HOST_SFRS(X)                                                                               \
+    X(uint8_t, IE1)                                                                                \
+    X(uint8_t, IFG1)                                                                               \
+    X(uint8_t, IE2)                                                                                \
+    X(uint8_t, IFG2)                                                                               \
+    X(uint8_t, P1IN)                                                                               \
+    X(uint8_t, P1OUT)                                                                              \
+    X(uint8_t, P1DIR)                                                                              \
+    X(uint8_t, P1IFG)                                                                              \
+    X(uint8_t, P1IES)                                                                              \
+    X(uint8_t, P1IE)                                                                               \
+    X(uint8_t, P1SEL)                                                                              \
+    X(uint8_t, P1SEL2)                                                                             \
+    X(uint8_t, P1REN)                                                                              \
+    X(uint8_t, P2IN)                                                                               \
+    X(uint8_t, P2OUT)                                                                              \
+    X(uint8_t, P2DIR)                                                                              \
+    X(uint8_t, P2IFG)                                                                              \
+    X(uint8_t, P2IES)                                                                              \
+    X(uint8_t, P2IE)                                                                               \
+    X(uint8_t, P2SEL)                                                                              \
+    X(uint8_t, P2SEL2)                                                                             \
+    X(uint8_t, P2REN)                                                                              \
+    X(uint16_t, WDTCTL)                                                                            \
+    X(uint8_t, DCOCTL)                                                                             \
+    X(uint8_t, BCSCTL1)                                                                            \
+    X(uint8_t, BCSCTL2)                                                                            \
+    X(uint8_t, BCSCTL3)                                                                            \
+    X(uint8_t, CALDCO_1MHZ)                                                                        \
+    X(uint8_t, CALBC1_1MHZ)                                                                        \
+    X(uint8_t, CALDCO_8MHZ)                                                                        \
+    X(uint8_t, CALBC1_8MHZ)                                                                        \
+    X(uint8_t, CALDCO_12MHZ)                                                                       \
+    X(uint8_t, CALBC1_12MHZ)                                                                       \
+    X(uint8_t, CALDCO_16MHZ)                                                                       \
+    X(uint8_t, CALBC1_16MHZ)                                                                       \
+    X(uint16_t, TA0CTL)                                                                            \
+    X(uint16_t, TA0R)                                                                              \
+    X(uint16_t, TA0CCTL0)                                                                          \
+    X(uint16_t, TA0CCTL1)                                                                          \
+    X(uint16_t, TA0CCTL2)                                                                          \
+    X(uint16_t, TA0CCR0)                                                                           \
+    X(uint16_t, TA0CCR1)                                                                           \
+    X(uint16_t, TA0CCR2)                                                                           \
+    X(uint16_t, TA1CTL)                                                                            \
+    X(uint16_t, TA1R)                                                                              \
+    X(uint16_t, TA1CCTL0)                                                                          \
+    X(uint16_t, TA1CCTL1)                                                                          \
+    X(uint16_t, TA1CCTL2)                                                                          \
+    X(uint16_t, TA1CCR0)                                                                           \
+    X(uint16_t, TA1CCR1)                                                                           \
+    X(uint16_t, TA1CCR2)                                                                           \
+    X(uint8_t, UCA0CTL0)                                                                           \
+    X(uint8_t, UCA0CTL1)                                                                           \
+    X(uint8_t, UCA0BR0)                                                                            \
+    X(uint8_t, UCA0BR1)                                                                            \
+    X(uint8_t, UCA0MCTL)                                                                           \
+    X(uint8_t, UCA0STAT)                                                                           \
+    X(uint8_t, UCA0RXBUF)                                                                          \
+    X(uint16_t, UCA0TXBUF)                                                                         \
+    X(uint8_t, UCB0CTL0)                                                                           \
+    X(uint8_t, UCB0CTL1)                                                                           \
+    X(uint8_t, UCB0BR0)                                                                            \
+    X(uint8_t, UCB0BR1)                                                                            \
+    X(uint8_t, UCB0STAT)                                                                           \
+    X(uint8_t, UCB0RXBUF)                                                                          \
+    X(uint16_t, UCB0TXBUF)                                                                         \
+    X(uint8_t, UCB0I2CIE)                                                                          \
+    X(uint16_t, UCB0I2COA)                                                                         \
+    X(uint16_t, UCB0I2CSA)                                                                         \
+    X(uint16_t, ADC10CTL0)                                                                         \
+    X(uint16_t, ADC10CTL1)                                                                         \
+    X(uint16_t, ADC10MEM)                                                                          \
+    X(uint8_t, ADC10AE0)                                                                           \
+    X(uint8_t, ADC10DTC0)                                                                          \
+    X(uint8_t, ADC10DTC1)                                                                          \
+    X(uintptr_t, ADC10SA)
+
+#define HOST_SFR_FIELD(type, name) volatile type sfr_##name;
+
+/**
+ * @brief Backing store of every emulated register, owned by the peripheral model.
+ */
+typedef struct
+{
+    HOST_SFRS(HOST_SFR_FIELD)
+} host_sfr_t;
+
+extern host_sfr_t host_sfr;
+
+/**
+ * @brief Lets the peripheral model catch up before a register access.
+ */
+void host_sync(void);
+
+/**
+ * @brief Reads a Timer_A interrupt vector register, clearing the flag it reports.
+ * @param timer 0 for Timer0_A, 1 for Timer1_A.
+ */
+uint16_t host_read_taiv(uint8_t timer);
+
+/**
+ * @brief Reads UCA0RXBUF, clearing UCA0RXIFG and the receive error flags.
+ */
+uint8_t host_read_uca0rxbuf(void);
+
+/**
+ * @brief Reads UCB0RXBUF, clearing UCB0RXIFG.
+ */
+uint8_t host_read_ucb0rxbuf(void);
+
+#define HOST_SFR(name) (*(host_sync(), &host_sfr.sfr_##name))
+
+// --- Special Function Registers ---
+
+#define IE1 HOST_SFR(IE1)
+#define IFG1 HOST_SFR(IFG1)
+#define IE2 HOST_SFR(IE2)
+#define IFG2 HOST_SFR(IFG2)
+
+#define WDTIE 0x01
+#define WDTIFG 0x01
+#define OFIFG 0x02
+#define PORIFG 0x04
+#define RSTIFG 0x08
+#define UCA0RXIE 0x01
+#define UCA0TXIE 0x02
+#define UCB0RXIE 0x04
+#define UCB0TXIE 0x08
+#define UCA0RXIFG 0x01
+#define UCA0TXIFG 0x02
+#define UCB0RXIFG 0x04
+#define UCB0TXIFG 0x08
+
+// --- Digital I/O ---
+
+#define P1IN HOST_SFR(P1IN)
+#define P1OUT HOST_SFR(P1OUT)
+#define P1DIR HOST_SFR(P1DIR)
+#define P1IFG HOST_SFR(P1IFG)
+#define P1IES HOST_SFR(P1IES)
+#define P1IE HOST_SFR(P1IE)
+#define P1SEL HOST_SFR(P1SEL)
+#define P1SEL2 HOST_SFR(P1SEL2)
+#define P1REN HOST_SFR(P1REN)
+#define P2IN HOST_SFR(P2IN)
+#define P2OUT HOST_SFR(P2OUT)
+#define P2DIR HOST_SFR(P2DIR)
+#define P2IFG HOST_SFR(P2IFG)
+#define P2IES HOST_SFR(P2IES)
+#define P2IE HOST_SFR(P2IE)
+#define P2SEL HOST_SFR(P2SEL)
+#define P2SEL2 HOST_SFR(P2SEL2)
+#define P2REN HOST_SFR(P2REN)
+
+#define BIT0 0x0001
+#define BIT1 0x0002
+#define BIT2 0x0004
+#define BIT3 0x0008
+#define BIT4 0x0010
+#define BIT5 0x0020
+#define BIT6 0x0040
+#define BIT7 0x0080
+
+// --- Watchdog Timer+ ---
+
+#define WDTCTL HOST_SFR(WDTCTL)
+
+#define WDTIS0 0x0001
+#define WDTIS1 0x0002
+#define WDTSSEL 0x0004
+#define WDTCNTCL 0x0008
+#define WDTTMSEL 0x0010
+#define WDTNMI 0x0020
+#define WDTNMIES 0x0040
+#define WDTHOLD 0x0080
+#define WDTPW 0x5A00
+
+// --- Basic Clock Module+ ---
+
+#define DCOCTL HOST_SFR(DCOCTL)
+#define BCSCTL1 HOST_SFR(BCSCTL1)
+#define BCSCTL2 HOST_SFR(BCSCTL2)
+#define BCSCTL3 HOST_SFR(BCSCTL3)
+#define CALDCO_1MHZ HOST_SFR(CALDCO_1MHZ)
+#define CALBC1_1MHZ HOST_SFR(CALBC1_1MHZ)
+#define CALDCO_8MHZ HOST_SFR(CALDCO_8MHZ)
+#define CALBC1_8MHZ HOST_SFR(CALBC1_8MHZ)
+#define CALDCO_12MHZ HOST_SFR(CALDCO_12MHZ)
+#define CALBC1_12MHZ HOST_SFR(CALBC1_12MHZ)
+#define CALDCO_16MHZ HOST_SFR(CALDCO_16MHZ)
+#define CALBC1_16MHZ HOST_SFR(CALBC1_16MHZ)
+
+#define MOD0 0x01
+#define DCO0 0x20
+#define RSEL0 0x01
+#define RSEL1 0x02
+#define RSEL2 0x04
+#define RSEL3 0x08
+#define DIVA_0 0x00
+#define DIVA_1 0x10
+#define DIVA_2 0x20
+#define DIVA_3 0x30
+#define XT2OFF 0x80
+#define SELM_0 0x00
+#define SELM_2 0x80
+#define SELM_3 0xC0
+#define DIVM_0 0x00
+#define DIVM_1 0x10
+#define DIVM_2 0x20
+#define DIVM_3 0x30
+#define SELS 0x08
+#define DIVS_0 0x00
+#define DIVS_1 0x02
+#define DIVS_2 0x04
+#define DIVS_3 0x06
+#define LFXT1OF 0x01
+#define XCAP_0 0x00
+#define XCAP_1 0x04
+#define XCAP_2 0x08
+#define XCAP_3 0x0C
+#define LFXT1S_0 0x00
+#define LFXT1S_2 0x20
+
+// --- Timer_A ---
+
+#define TA0CTL HOST_SFR(TA0CTL)
+#define TA0R HOST_SFR(TA0R)
+#define TA0CCTL0 HOST_SFR(TA0CCTL0)
+#define TA0CCTL1 HOST_SFR(TA0CCTL1)
+#define TA0CCTL2 HOST_SFR(TA0CCTL2)
+#define TA0CCR0 HOST_SFR(TA0CCR0)
+#define TA0CCR1 HOST_SFR(TA0CCR1)
+#define TA0CCR2 HOST_SFR(TA0CCR2)
+#define TA0IV host_read_taiv(0)
+#define TA1CTL HOST_SFR(TA1CTL)
+#define TA1R HOST_SFR(TA1R)
+#define TA1CCTL0 HOST_SFR(TA1CCTL0)
+#define TA1CCTL1 HOST_SFR(TA1CCTL1)
+#define TA1CCTL2 HOST_SFR(TA1CCTL2)
+#define TA1CCR0 HOST_SFR(TA1CCR0)
+#define TA1CCR1 HOST_SFR(TA1CCR1)
+#define TA1CCR2 HOST_SFR(TA1CCR2)
+#define TA1IV host_read_taiv(1)
+
+#define TASSEL_0 0x0000
+#define TASSEL_1 0x0100
+#define TASSEL_2 0x0200
+#define TASSEL_3 0x0300
+#define ID_0 0x0000
+#define ID_1 0x0040
+#define ID_2 0x0080
+#define ID_3 0x00C0
+#define MC_0 0x0000
+#define MC_1 0x0010
+#define MC_2 0x0020
+#define MC_3 0x0030
+#define TACLR 0x0004
+#define TAIE 0x0002
+#define TAIFG 0x0001
+
+#define CM_0 0x0000
+#define CM_1 0x4000
+#define CM_2 0x8000
+#define CM_3 0xC000
+#define CCIS_0 0x0000
+#define CCIS_1 0x1000
+#define CCIS_2 0x2000
+#define CCIS_3 0x3000
+#define SCS 0x0800
+#define SCCI 0x0400
+#define CAP 0x0100
+#define OUTMOD_0 0x0000
+#define OUTMOD_1 0x0020
+#define OUTMOD_2 0x0040
+#define OUTMOD_3 0x0060
+#define OUTMOD_4 0x0080
+#define OUTMOD_5 0x00A0
+#define OUTMOD_6 0x00C0
+#define OUTMOD_7 0x00E0
+#define CCIE 0x0010
+#define CCI 0x0008
+#define OUT 0x0004
+#define COV 0x0002
+#define CCIFG 0x0001
+
+#define TA0IV_NONE 0x0000
+#define TA0IV_TACCR1 0x0002
+#define TA0IV_TACCR2 0x0004
+#define TA0IV_TAIFG 0x000A
+#define TA1IV_NONE 0x0000
+#define TA1IV_TACCR1 0x0002
+#define TA1IV_TACCR2 0x0004
+#define TA1IV_TAIFG 0x000A
+
+// --- USCI ---
+
+#define UCA0CTL0 HOST_SFR(UCA0CTL0)
+#define UCA0CTL1 HOST_SFR(UCA0CTL1)
+#define UCA0BR0 HOST_SFR(UCA0BR0)
+#define UCA0BR1 HOST_SFR(UCA0BR1)
+#define UCA0MCTL HOST_SFR(UCA0MCTL)
+#define UCA0STAT HOST_SFR(UCA0STAT)
+#define UCA0RXBUF host_read_uca0rxbuf()
+// Backed by a 16-bit field: the model marks the buffer empty with a value no byte write produces.
+#define UCA0TXBUF HOST_SFR(UCA0TXBUF)
+#define UCB0CTL0 HOST_SFR(UCB0CTL0)
+#define UCB0CTL1 HOST_SFR(UCB0CTL1)
+#define UCB0BR0 HOST_SFR(UCB0BR0)
+#define UCB0BR1 HOST_SFR(UCB0BR1)
+#define UCB0STAT HOST_SFR(UCB0STAT)
+#define UCB0RXBUF host_read_ucb0rxbuf()
+// Backed by a 16-bit field, as UCA0TXBUF.
+#define UCB0TXBUF HOST_SFR(UCB0TXBUF)
+#define UCB0I2CIE HOST_SFR(UCB0I2CIE)
+#define UCB0I2COA HOST_SFR(UCB0I2COA)
+#define UCB0I2CSA HOST_SFR(UCB0I2CSA)
+
+#define UCCKPH 0x80
+#define UCCKPL 0x40
+#define UCMSB 0x20
+#define UC7BIT 0x10
+#define UCMST 0x08
+#define UCMODE_0 0x00
+#define UCMODE_3 0x06
+#define UCSYNC 0x01
+#define UCSSEL_1 0x40
+#define UCSSEL_2 0x80
+#define UCSSEL_3 0xC0
+#define UCSWRST 0x01
+#define UCTR 0x10
+#define UCTXNACK 0x08
+#define UCTXSTP 0x04
+#define UCTXSTT 0x02
+#define UCOS16 0x01
+#define UCBRS_1 0x02
+#define UCBRF_1 0x10
+#define UCBUSY 0x01
+#define UCRXERR 0x04
+#define UCOE 0x20
+#define UCFE 0x40
+#define UCALIFG 0x01
+#define UCNACKIFG 0x08
+#define UCBBUSY 0x10
+#define UCALIE 0x01
+#define UCNACKIE 0x08
+
+// --- ADC10 ---
+
+#define ADC10CTL0 HOST_SFR(ADC10CTL0)
+#define ADC10CTL1 HOST_SFR(ADC10CTL1)
+#define ADC10MEM HOST_SFR(ADC10MEM)
+#define ADC10AE0 HOST_SFR(ADC10AE0)
+#define ADC10DTC0 HOST_SFR(ADC10DTC0)
+#define ADC10DTC1 HOST_SFR(ADC10DTC1)
+// Backed by a native pointer: the device register holds a 16-bit address.
+#define ADC10SA HOST_SFR(ADC10SA)
+
+#define ADC10SC 0x0001
+#define ENC 0x0002
+#define ADC10IFG 0x0004
+#define ADC10IE 0x0008
+#define ADC10ON 0x0010
+#define REFON 0x0020
+#define REF2_5V 0x0040
+#define MSC 0x0080
+#define ADC10SHT_0 0x0000
+#define ADC10SHT_1 0x0800
+#define ADC10SHT_2 0x1000
+#define ADC10SHT_3 0x1800
+#define SREF_0 0x0000
+#define SREF_1 0x2000
+
+#define ADC10BUSY 0x0001
+#define CONSEQ_0 0x0000
+#define CONSEQ_1 0x0002
+#define CONSEQ_2 0x0004
+#define CONSEQ_3 0x0006
+#define ADC10SSEL_0 0x0000
+#define ADC10SSEL_1 0x0008
+#define ADC10SSEL_2 0x0010
+#define ADC10SSEL_3 0x0018
+#define ADC10DIV_0 0x0000
+#define ADC10DIV_3 0x0060
+#define ISSH 0x0100
+#define ADC10DF 0x0200
+#define SHS_0 0x0000
+#define SHS_1 0x0400
+#define SHS_2 0x0800
+#define SHS_3 0x0C00
+#define INCH_0 0x0000
+#define INCH_1 0x1000
+#define INCH_10 0xA000
+#define INCH_11 0xB000
+
+#define ADC10FETCH 0x01
+#define ADC10B1 0x02
+#define ADC10CT 0x04
+#define ADC10TB 0x08
+
+// --- Status Register and Intrinsics ---
+
+#define GIE 0x0008
+#define CPUOFF 0x0010
+#define OSCOFF 0x0020
+#define SCG0 0x0040
+#define SCG1 0x0080
+
+#define LPM0_bits (CPUOFF)
+#define LPM1_bits (SCG0 | CPUOFF)
+#define LPM2_bits (SCG1 | CPUOFF)
+#define LPM3_bits (SCG1 | SCG0 | CPUOFF)
+#define LPM4_bits (SCG1 | SCG0 | OSCOFF | CPUOFF)
+
+void __disable_interrupt(void);
+void __enable_interrupt(void);
+void __no_operation(void);
+uint16_t __get_SR_register(void);
+void __bis_SR_register(uint16_t bits);
+void __bic_SR_register(uint16_t bits);
+void __bis_SR_register_on_exit(uint16_t bits);
+void __bic_SR_register_on_exit(uint16_t bits);
+void __delay_cycles(uint32_t cycles);
+
+// --- Interrupt Vectors ---
+
+#define PORT1_VECTOR 3
+#define PORT2_VECTOR 4
+#define ADC10_VECTOR 6
+#define USCIAB0TX_VECTOR 7
+#define USCIAB0RX_VECTOR 8
+#define TIMER0_A1_VECTOR 9
+#define TIMER0_A0_VECTOR 10
+#define WDT_VECTOR 11
+#define COMPARATORA_VECTOR 12
+#define TIMER1_A1_VECTOR 13
+#define TIMER1_A0_VECTOR 14
+#define NMI_VECTOR 15
+
+#define HOST_STRINGIFY(x) #x
+#define HOST_XSTRINGIFY(x) HOST_STRINGIFY(x)
+
+/**
+ * @brief Places an ISR in a per-vector section, where the model finds it.
+ *
+ * The linker provides __start_host_isr_<vector> for each such section, so
+ * the model links against the ISRs without knowing their names.
+ */
+#define HOST_INTERRUPT_VECTOR(vector)                                                              \
+    __attribute__((used, section("host_isr_" HOST_XSTRINGIFY(vector))))
+
+#endif // HOST_MSP430_H
@@ -1,32 +1,169 @@
 #include <msp430.h>
+#include "common/stack.h"
+#include "drivers/adc.h"
+#include "drivers/as5600.h"
+#include "drivers/boot.h"
+#include "drivers/capture.h"
+#include "drivers/clock.h"
+#include "drivers/fll.h"
 #include "drivers/gpio.h"
+#include "drivers/i2c.h"
+#include "drivers/isr_profile.h"
 #include "drivers/led.h"
+#include "drivers/led_panel.h"
 #include "drivers/mcu_init.h"
-#include "drivers/millis.h"
+#include "drivers/power.h"
+#include "drivers/runloop.h"
+#include "drivers/timebase.h"
+#include "drivers/trace.h"
+#include "drivers/uart.h"
 #include <stddef.h>
 
-int main(void)
+#define BLINK_DURATION_MS 10000
+#define UART_BAUD 115200
+#define ADC_PASSES_PER_BLOCK 2
+#define AS5600_PWM_CHANNEL 1 // TA1.1, CCI1A on P2.1
+
+#if BOARD_ADC_ENABLED
+// The AS5600 output, the temperature sensor and VCC/2, with A11 to A0 in each pass
+static uint16_t adc_buffer[2 * ADC_PASSES_PER_BLOCK * ADC_CHANNEL_CNT];
+static const adc_stream_t adc_stream = {
+    .buffer = adc_buffer,
+    .block_len = ADC_PASSES_PER_BLOCK * ADC_CHANNEL_CNT,
+    .top_channel = ADC_CHANNEL_VMID,
+    .analog_pins = BIT5,
+    .ref = ADC_REF_VCC,
+    .interval_ticks = (uint16_t)TIMEBASE_MS_TO_TICKS(1),
+    .done = NULL, // Only the latest block is reported
+};
+#endif
+
+static const char app_banner[] = "blink: press S2 to restart\r\n";
+
+/**
+ * @brief Stops both LEDs once the blinking demo is over and slows down while idle.
+ * Runs from the run loop.
+ */
+static void app_handle_timeout(void)
 {
-    mcu_init();
-    gpio_init();
-    led_init();
-    millis_init();
+    led_stop_blinking(led_get_handle(IO_LED_RED));
+#if BOARD_HAS_LED_GREEN
+    led_stop_blinking(led_get_handle(IO_LED_GREEN));
+#endif
+    isr_profile_report();
+#if BOARD_HAS_AS5600
+    as5600_report();
+#endif
+#if BOARD_ADC_ENABLED
+    adc_report();
+#endif
+#if BOARD_CAPTURE_ENABLED
+    capture_report();
+#endif
+#if LED_PANEL_CHANNELS > 0
+    led_panel_report(); // The panel goes dark at 1 MHz and lights again with the next run
+#endif
+    uart_flush();
+    (void)clock_set_profile(CLOCK_PROFILE_1MHZ);
+}
+
+/**
+ * @brief Timebase alarm callback, runs in interrupt context.
+ */
+static void app_timeout_alarm(void)
+{
+    runloop_post(RUNLOOP_EVENT_APP);
+}
 
+/**
+ * @brief Starts both LEDs blinking and schedules the stop 10 seconds later.
+ */
+static void app_start_blinking(void)
+{
+    uart_flush();
+    (void)clock_set_profile(CLOCK_PROFILE_16MHZ);
+    isr_profile_reset(); // Report on this run at 16 MHz only
+#if BOARD_HAS_AS5600
+    as5600_reset_stats();
+#endif
+#if LED_PANEL_CHANNELS > 0
+    // A brightness ramp over the panel, every bit-plane in use
+    for (uint8_t i = 0; i < LED_PANEL_CHANNELS; i++) {
+        uint8_t brightness = (uint8_t)((i + 1) * (256 / LED_PANEL_CHANNELS) - 1);
+        led_set_brightness(led_get_panel_handle(i), brightness);
+    }
+    led_panel_reset_stats();
+#endif
+    (void)uart_write_const(app_banner, sizeof(app_banner) - 1);
     led_start_blinking(led_get_handle(IO_LED_RED), 200, 800);
+#if BOARD_HAS_LED_GREEN
     led_start_blinking(led_get_handle(IO_LED_GREEN), 500, 500);
+#endif
+
+    timebase_alarm_set(TIMEBASE_ALARM_APP, timebase_ticks() + TIMEBASE_MS_TO_TICKS(BLINK_DURATION_MS),
+        app_timeout_alarm);
+}
 
-    uint32_t current_time = millis();
+/**
+ * @brief Restarts the blinking demo when S2 is pressed. Runs from the run loop.
+ */
+static void app_handle_input(void)
+{
+    gpio_edges_t edges = gpio_debounce_take_edges();
 
-    while (1) 
-    { 
-        led_handle_blinking();
+    // S2 is active low: a press is a falling edge.
+    if (edges.falling & GPIO_MASK(IO_BUTTON)) {
+        app_start_blinking();
+    }
+}
 
-        // Check if 10 seconds has passed
-        if (millis() - current_time >= 10000) {
-            // Toggle LED states
-            led_stop_blinking(led_get_handle(IO_LED_RED));
-            led_stop_blinking(led_get_handle(IO_LED_GREEN));
-        }
+/**
+ * @brief Echoes the bytes received on the UART. Runs from the run loop.
+ */
+static void app_handle_uart(void)
+{
+    uint8_t buf[8];
+    uint16_t len;
+
+    while ((len = uart_read(buf, sizeof(buf))) > 0) {
+        (void)uart_write(buf, len);
     }
 }
 
+int main(void)
+{
+    boot_init();
+    stack_paint();
+    mcu_init();
+    gpio_init();
+    timebase_init();
+    power_init();
+    fll_init();
+    led_init();
+    uart_init(UART_BAUD);
+    trace_init();
+#if BOARD_I2C_ENABLED
+    i2c_init();
+#endif
+#if BOARD_HAS_AS5600
+    as5600_init();
+#endif
+#if BOARD_ADC_ENABLED
+    adc_init();
+    (void)adc_start(&adc_stream);
+#endif
+    gpio_debounce_init(GPIO_MASK(IO_BUTTON));
+
+    // Blink for 10 seconds, and again each time S2 is pressed
+    runloop_register(RUNLOOP_EVENT_APP, app_handle_timeout);
+    runloop_register(RUNLOOP_EVENT_INPUT, app_handle_input);
+    runloop_register(RUNLOOP_EVENT_UART_RX, app_handle_uart);
+    app_start_blinking();
+    boot_report(); // Both boot marks are reached by now
+#if BOARD_CAPTURE_ENABLED
+    capture_init(); // Timer1_A is free once the boot is counted
+    (void)capture_start(AS5600_PWM_CHANNEL, CAPTURE_INPUT_A, CAPTURE_EDGE_BOTH);
+#endif
+
+    runloop_run();
+}
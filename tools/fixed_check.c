@@ -0,0 +1,152 @@
+/**
+ * @file fixed_check.c
+ * @brief Checks the fixed-point kernels of common/fixed.h against the C operators and libm.
+ *
+ * Usage: fixed_check
+ *
+ * Runs on the build machine, through make fixed-check:
+ * - The divisions and multiplications by a constant, over every input below
+ *   2^24 and a sample of the rest of the 32-bit range.
+ * - The sine and cosine over every 12-bit angle, within 1 LSB of the exact
+ *   value rounded to Q15 and saturated to Q15_ONE.
+ * - atan2 over a grid of vectors and the axes and diagonals, within 1 count.
+ * - q16_mul against a 64-bit product, on a sample of factors.
+ *
+ * Prints the worst error of each kernel, and exits with 1 if one is out of bounds.
+ */
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../common/fixed.h"
+
+// --- Private Module Constants ---
+
+#define EXHAUSTIVE_LIMIT (1UL << 24) ///< Every input below is checked.
+#define SAMPLE_STEP 9973UL ///< Step between the inputs checked above, a prime.
+#define ATAN2_GRID_STEP 97 ///< Step of the atan2 grid over each axis.
+#define ANGLE_TO_RAD (2.0 * M_PI / FIXED_ANGLE_TURN)
+
+// --- Private Module Variables ---
+
+static bool is_failed = false;
+
+// --- Private Function Definitions ---
+
+/**
+ * @brief Prints the outcome of a check and records a failure.
+ */
+static void report(const char *kernel, double worst, double bound)
+{
+    bool is_ok = worst <= bound;
+    printf("%-16s worst error %.3f, bound %.3f: %s\n", kernel, worst, bound,
+        is_ok ? "ok" : "FAILED");
+    if (!is_ok) is_failed = true;
+}
+
+/**
+ * @brief Returns the next input to check: every one below EXHAUSTIVE_LIMIT, then a sample.
+ * @return false once the 32-bit range is covered.
+ */
+static bool next_input(uint64_t *x)
+{
+    *x += (*x < EXHAUSTIVE_LIMIT) ? 1 : SAMPLE_STEP;
+    return *x <= UINT32_MAX;
+}
+
+static void check_divmod10(void)
+{
+    double worst = 0;
+    uint64_t x = 0;
+    do {
+        uint8_t rem;
+        uint32_t q = fixed_divmod10_u32((uint32_t)x, &rem);
+        if (q != x / 10 || rem != x % 10) worst = 1;
+        if (fixed_mul10_u32((uint32_t)(x / 10)) != (uint32_t)(x / 10 * 10)) worst = 1;
+    } while (next_input(&x));
+    // The end of the range, which the sample step may skip.
+    uint8_t rem;
+    uint32_t q = fixed_divmod10_u32(UINT32_MAX, &rem);
+    if (q != UINT32_MAX / 10 || rem != UINT32_MAX % 10) worst = 1;
+    report("divmod10", worst, 0);
+}
+
+static void check_divmod2000(void)
+{
+    double worst = 0;
+    for (uint32_t x = 0; x < EXHAUSTIVE_LIMIT; x++) {
+        uint16_t rem;
+        uint32_t q = fixed_divmod2000_u24(x, &rem);
+        if (q != x / 2000 || rem != x % 2000) worst = 1;
+        if (fixed_mul2000_u32(x) != x * 2000) worst = 1;
+    }
+    report("divmod2000/mul", worst, 0);
+}
+
+static void check_sin_cos(void)
+{
+    double worst = 0;
+    for (uint32_t angle = 0; angle < 2 * FIXED_ANGLE_TURN; angle++) {
+        double sin_exact = fmin(round(sin(angle * ANGLE_TO_RAD) * 32768), Q15_ONE);
+        double cos_exact = fmin(round(cos(angle * ANGLE_TO_RAD) * 32768), Q15_ONE);
+        worst = fmax(worst, fabs(fixed_sin((uint16_t)angle) - sin_exact));
+        worst = fmax(worst, fabs(fixed_cos((uint16_t)angle) - cos_exact));
+    }
+    report("sin/cos", worst, 1);
+}
+
+/**
+ * @brief Error of fixed_atan2() for one vector, in angle counts, accounting for the wrap.
+ */
+static double atan2_error(int32_t y, int32_t x)
+{
+    double exact = atan2(y, x) / ANGLE_TO_RAD;
+    exact = fmod(exact + FIXED_ANGLE_TURN, FIXED_ANGLE_TURN);
+    double error = fabs(fixed_atan2((int16_t)y, (int16_t)x) - exact);
+    return fmin(error, FIXED_ANGLE_TURN - error);
+}
+
+static void check_atan2(void)
+{
+    double worst = 0;
+    for (int32_t y = INT16_MIN; y <= INT16_MAX; y += ATAN2_GRID_STEP) {
+        for (int32_t x = INT16_MIN; x <= INT16_MAX; x += ATAN2_GRID_STEP) {
+            if (x != 0 || y != 0) worst = fmax(worst, atan2_error(y, x));
+        }
+    }
+    for (int32_t v = INT16_MIN; v <= INT16_MAX; v++) {
+        if (v == 0) continue;
+        worst = fmax(worst, atan2_error(v, 0));
+        worst = fmax(worst, atan2_error(0, v));
+        worst = fmax(worst, atan2_error(v, v));
+        if (v != INT16_MIN) worst = fmax(worst, atan2_error(v, -v));
+    }
+    if (fixed_atan2(0, 0) != 0) worst = FIXED_ANGLE_TURN;
+    report("atan2", worst, 1);
+}
+
+static void check_q16_mul(void)
+{
+    double worst = 0;
+    srand(1);
+    for (uint32_t i = 0; i < 10000000UL; i++) {
+        // Factors of random magnitude, so that both small and large ones come up.
+        q16_t a = (q16_t)((uint32_t)rand() << 1 ^ (uint32_t)rand()) >> (rand() % 31);
+        q16_t b = (q16_t)((uint32_t)rand() << 1 ^ (uint32_t)rand()) >> (rand() % 31);
+        int64_t exact = (int64_t)a * b / 65536; // Rounded toward zero, like q16_mul()
+        if (exact > INT32_MAX || exact < -INT32_MAX) continue;
+        worst = fmax(worst, fabs((double)(q16_mul(a, b) - exact)));
+    }
+    report("q16_mul", worst, 0);
+}
+
+int main(void)
+{
+    check_divmod10();
+    check_divmod2000();
+    check_sin_cos();
+    check_atan2();
+    check_q16_mul();
+    return is_failed ? 1 : 0;
+}
@@ -0,0 +1,41 @@
+#!/bin/sh
+# Prints the static RAM (.data, .bss and .noinit) taken by each object file of
+# a linked image, and fails when the image takes more than a budget. The rest
+# of the RAM is left to the stack; see common/stack.h for its high-water mark.
+#
+# Usage: ram_report.sh <size tool> <budget bytes> <image.elf> <objects...>
+set -e
+
+size_tool=$1
+budget=$2
+image=$3
+shift 3
+
+# Sums the RAM sections of one file, from the System V format of size(1).
+ram_bytes() {
+    "$size_tool" -A "$1" | awk '
+    $1 ~ /^\.(data|bss|noinit)(\.|$)/ && $1 !~ /^\.data\.rel\.ro/ {
+        if ($1 ~ /^\.bss|^\.noinit/) bss += $2; else data += $2
+    }
+    END { printf "%d %d\n", data, bss }'
+}
+
+printf 'ram: %-28s %6s %6s %6s\n' module data bss total
+objects_total=0
+for object in "$@"; do
+    set -- $(ram_bytes "$object")
+    if [ $(($1 + $2)) -gt 0 ]; then
+        printf 'ram: %-28s %6d %6d %6d\n' "${object#*/obj/}" "$1" "$2" $(($1 + $2))
+    fi
+    objects_total=$((objects_total + $1 + $2))
+done
+
+set -- $(ram_bytes "$image")
+total=$(($1 + $2))
+printf 'ram: %-28s %6s %6s %6d\n' "(libraries, alignment)" "" "" $((total - objects_total))
+printf 'ram: %-28s %6d %6d %6d of %d budgeted\n' total "$1" "$2" "$total" "$budget"
+
+if [ "$total" -gt "$budget" ]; then
+    echo "ram: static RAM exceeds RAM_BUDGET by $((total - budget)) bytes" >&2
+    exit 1
+fi
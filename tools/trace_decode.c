@@ -0,0 +1,276 @@
+/**
+ * @file trace_decode.c
+ * @brief Converts the trace stream of a TRACE=1 build into Chrome trace JSON.
+ *
+ * Usage: trace_decode [capture] > trace.json
+ *
+ * Reads the raw UART bytes from a capture file (e.g. a serial port dump, or
+ * HOST_UART_TX of the host build), or stdin. Other text sent over the UART is
+ * skipped. The output opens in chrome://tracing or https://ui.perfetto.dev,
+ * with interrupts, run loop tasks and sleep on separate tracks.
+ */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../drivers/trace_events.h"
+
+// --- Private Module Constants ---
+
+#define RECORD_BYTES 4
+#define HEADER_BYTES 1
+#define FRAME_MAX 256
+#define COUNT_WRAP 65536.0
+#define COBS_CODE_MAX 0xFF
+
+enum {
+    TRACK_ISR = 1,
+    TRACK_TASK,
+    TRACK_CPU,
+};
+
+#define EVENT_LABEL(event, label) label,
+static const char *const event_labels[TRACE_EVENT_CNT] = { TRACE_EVENTS(EVENT_LABEL) };
+#undef EVENT_LABEL
+
+/**
+ * @brief MSP430G2553 interrupt vector names, by vector number.
+ */
+static const char *const vector_names[16] = {
+    [3] = "PORT1",
+    [4] = "PORT2",
+    [6] = "ADC10",
+    [7] = "USCIAB0TX",
+    [8] = "USCIAB0RX",
+    [9] = "TIMER0_A1",
+    [10] = "TIMER0_A0",
+    [11] = "WDT",
+    [12] = "COMPARATORA",
+    [13] = "TIMER1_A1",
+    [14] = "TIMER1_A0",
+    [15] = "NMI",
+};
+
+/**
+ * @brief Run loop task names, in runloop_event_e order.
+ */
+static const char *const task_names[] = { "led", "input", "uart rx", "app" };
+
+/**
+ * @brief Clock profile names and Timer0_A count periods, in clock_profile_e order.
+ */
+static const char *const profile_names[] = { "1 MHz", "8 MHz", "16 MHz" };
+static const double profile_count_us[] = { 1.0, 0.5, 0.5 };
+
+// --- Private Module Variables ---
+
+static bool is_started = false;
+static double base_us = 0; ///< Time of count 0 in the current counter period.
+static double count_us = 0.5;
+static uint16_t last_count = 0;
+static bool is_wrap_counted = false; ///< A backwards count already accounted for the next wrap.
+static bool is_sleeping = false;
+static bool is_first_event = true;
+static uint32_t packet_cnt = 0;
+static uint32_t record_cnt = 0;
+static uint32_t dropped_cnt = 0;
+
+// --- Private Function Definitions ---
+
+static const char *name_of(const char *const *names, size_t cnt, uint8_t idx, char *buf)
+{
+    if (idx < cnt && names[idx] != NULL) return names[idx];
+    sprintf(buf, "%u", idx);
+    return buf;
+}
+
+static void emit(const char *name, char phase, int track, double ts)
+{
+    printf("%s\n  {\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": 1, \"tid\": %d%s}",
+        is_first_event ? "" : ",", name, phase, ts, track, (phase == 'i') ? ", \"s\": \"t\"" : "");
+    is_first_event = false;
+}
+
+static void emit_track_name(int track, const char *name)
+{
+    printf("%s\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, "
+           "\"args\": {\"name\": \"%s\"}}",
+        is_first_event ? "" : ",", track, name);
+    is_first_event = false;
+}
+
+/**
+ * @brief Extends a 16-bit count to an absolute time, following wraps and clock changes.
+ */
+static double record_time(uint16_t count, uint8_t event)
+{
+    // Records are in time order, so a count going backwards has wrapped. The
+    // wrap record itself may come a little later, from the overflow ISR.
+    if (count < last_count) {
+        base_us += COUNT_WRAP * count_us;
+        is_wrap_counted = true;
+    }
+    if (event == TRACE_EVENT_TIMER_WRAP) {
+        if (!is_wrap_counted) base_us += COUNT_WRAP * count_us;
+        is_wrap_counted = false;
+    }
+    last_count = count;
+    return base_us + count * count_us;
+}
+
+static void process_record(uint16_t count, uint8_t event, uint8_t arg)
+{
+    char buf[32];
+    char label[48];
+
+    if (event == TRACE_EVENT_START) {
+        uint8_t profile = (arg < 3) ? arg : 0;
+        count_us = profile_count_us[profile];
+        base_us = -count * count_us;
+        last_count = count;
+        is_wrap_counted = false;
+        is_started = true;
+        emit("start", 'i', TRACK_CPU, 0);
+        return;
+    }
+    if (!is_started) return;
+
+    double ts = record_time(count, event);
+    if (is_sleeping) {
+        emit("sleep", 'E', TRACK_CPU, ts);
+        is_sleeping = false;
+    }
+
+    switch (event) {
+    case TRACE_EVENT_CLOCK:
+        // The counter restarts from 0 at the new rate right after this record.
+        snprintf(label, sizeof(label), "clock %s",
+            name_of(profile_names, 3, arg, buf));
+        emit(label, 'i', TRACK_CPU, ts);
+        base_us = ts;
+        last_count = 0;
+        is_wrap_counted = false;
+        if (arg < 3) count_us = profile_count_us[arg];
+        break;
+    case TRACE_EVENT_ISR_BEGIN:
+    case TRACE_EVENT_ISR_END:
+        emit(name_of(vector_names, 16, arg, buf), (event == TRACE_EVENT_ISR_BEGIN) ? 'B' : 'E',
+            TRACK_ISR, ts);
+        break;
+    case TRACE_EVENT_TASK_BEGIN:
+    case TRACE_EVENT_TASK_END:
+        emit(name_of(task_names, sizeof(task_names) / sizeof(task_names[0]), arg, buf),
+            (event == TRACE_EVENT_TASK_BEGIN) ? 'B' : 'E', TRACK_TASK, ts);
+        break;
+    case TRACE_EVENT_SLEEP:
+        emit("sleep", 'B', TRACK_CPU, ts);
+        is_sleeping = true;
+        break;
+    case TRACE_EVENT_LED_TOGGLE:
+        snprintf(label, sizeof(label), "led %u %s", arg & 0x7Fu, (arg & 0x80u) ? "on" : "off");
+        emit(label, 'i', TRACK_TASK, ts);
+        break;
+    case TRACE_EVENT_USER:
+        snprintf(label, sizeof(label), "user %u", arg);
+        emit(label, 'i', TRACK_TASK, ts);
+        break;
+    default:
+        emit(event_labels[event], 'i', TRACK_CPU, ts);
+        break;
+    }
+}
+
+/**
+ * @brief Decodes a COBS frame without its delimiters.
+ * @return The decoded length, or -1 if the frame is not valid COBS.
+ */
+static int cobs_decode(const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t i = 0;
+    int n = 0;
+
+    while (i < len) {
+        uint8_t code = in[i++];
+        if (code == 0) return -1;
+        for (uint8_t k = 1; k < code; k++) {
+            if (i >= len) return -1;
+            out[n++] = in[i++];
+        }
+        if (code < COBS_CODE_MAX && i < len) out[n++] = 0;
+    }
+    return n;
+}
+
+/**
+ * @brief Processes a frame if it decodes to a valid packet; other text is skipped.
+ */
+static void process_frame(const uint8_t *frame, size_t len)
+{
+    uint8_t packet[FRAME_MAX];
+    int n = cobs_decode(frame, len, packet);
+
+    if (n < HEADER_BYTES || (n - HEADER_BYTES) % RECORD_BYTES != 0) return;
+    for (int i = HEADER_BYTES; i < n; i += RECORD_BYTES) {
+        if (packet[i + 2] >= TRACE_EVENT_CNT) return;
+    }
+
+    packet_cnt++;
+    if (packet[0] != 0 && is_started) {
+        char label[48];
+        snprintf(label, sizeof(label), "%u records dropped", packet[0]);
+        emit(label, 'i', TRACK_CPU, base_us + last_count * count_us);
+        dropped_cnt += packet[0];
+    }
+    for (int i = HEADER_BYTES; i < n; i += RECORD_BYTES) {
+        uint16_t count = (uint16_t)(packet[i] | (packet[i + 1] << 8));
+        process_record(count, packet[i + 2], packet[i + 3]);
+        record_cnt++;
+    }
+}
+
+// --- Public Function Definitions ---
+
+int main(int argc, char **argv)
+{
+    FILE *in = stdin;
+    if (argc > 1) {
+        in = fopen(argv[1], "rb");
+        if (in == NULL) {
+            perror(argv[1]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("{\"traceEvents\": [");
+    emit_track_name(TRACK_ISR, "interrupts");
+    emit_track_name(TRACK_TASK, "run loop");
+    emit_track_name(TRACK_CPU, "cpu");
+
+    uint8_t frame[FRAME_MAX];
+    size_t len = 0;
+    bool is_overlong = false;
+    int c;
+    while ((c = fgetc(in)) != EOF) {
+        if (c != 0) {
+            if (len < sizeof(frame)) {
+                frame[len++] = (uint8_t)c;
+            } else {
+                is_overlong = true;
+            }
+            continue;
+        }
+        if (len > 0 && !is_overlong) process_frame(frame, len);
+        len = 0;
+        is_overlong = false;
+    }
+    printf("\n]}\n");
+
+    fprintf(stderr, "trace_decode: %" PRIu32 " packets, %" PRIu32 " records, %" PRIu32 " dropped\n",
+        packet_cnt, record_cnt, dropped_cnt);
+    if (dropped_cnt != 0) {
+        fprintf(stderr, "trace_decode: times after a drop may be off by whole counter periods\n");
+    }
+    if (in != stdin) fclose(in);
+    return EXIT_SUCCESS;
+}